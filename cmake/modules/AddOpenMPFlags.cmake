@@ -0,0 +1,23 @@
+# Defines the functions to use OpenMP
+#
+# .. cmake_function:: add_dune_openmp_flags
+#
+#    .. cmake_param:: targets
+#       :positional:
+#       :single:
+#       :required:
+#
+#       A list of targets to use OpenMP with.
+#
+#    Compiling with OpenMP enables the threaded kernels of dune-istl,
+#    e.g. the level-scheduled triangular solves of the ILU preconditioners.
+#
+
+# Provide function to set target properties for linking to OpenMP
+function(add_dune_openmp_flags _targets)
+  if(OpenMP_CXX_FOUND)
+    foreach(_target ${_targets})
+      target_link_libraries(${_target} OpenMP::OpenMP_CXX)
+    endforeach()
+  endif()
+endfunction(add_dune_openmp_flags)
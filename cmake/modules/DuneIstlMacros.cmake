@@ -12,6 +12,8 @@ find_package(ARPACKPP)
 include(AddARPACKPPFlags)
 find_package(SuiteSparse OPTIONAL_COMPONENTS CHOLMOD LDL SPQR UMFPACK)
 include(AddSuiteSparseFlags)
+find_package(OpenMP COMPONENTS CXX)
+include(AddOpenMPFlags)
 
 # enable / disable backwards compatibility w.r.t. category
 set(DUNE_ISTL_SUPPORT_OLD_CATEGORY_INTERFACE 1
@@ -10,17 +10,20 @@
 #include <initializer_list>
 #include <limits>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <dune/common/dotproduct.hh>
 #include <dune/common/ftraits.hh>
+#include <dune/common/math.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/promotiontraits.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/common/unused.hh>
 #include <dune/common/scalarvectorview.hh>
+#include <dune/common/simd/simd.hh>
 
 #include <dune/istl/blocklevel.hh>
 
@@ -66,6 +69,54 @@ namespace Imp {
   template <class B>
   using BlockTraits = BlockTraitsImp<B,IsNumber<B>::value>;
 
+  /** \brief Add the weighted Gram matrix of the lanes of two blocks
+   *
+   * For a SIMD field type K the lanes are interpreted as the columns of
+   * a multi-vector. Adds \f$\overline{x_a}^T y_b\,w\f$ to
+   * gram[a*lanes+b] for all lanes a, b, where x_a is lane a of the
+   * (possibly nested) block x.
+   */
+  template<class K, class G, class B, class W>
+  void addLaneGram (G& gram, const B& x, const B& y, const W& weight)
+  {
+    if constexpr (std::is_same<B,K>::value)
+    {
+      const std::size_t lanes = Simd::lanes<K>();
+      for (std::size_t a=0; a<lanes; ++a)
+      {
+        const Simd::Scalar<K> xa = conjugateComplex(Simd::Scalar<K>(Simd::lane(a,x)))*weight;
+        for (std::size_t b=0; b<lanes; ++b)
+          gram[a*lanes+b] += xa*Simd::lane(b,y);
+      }
+    }
+    else
+      for (std::size_t i=0; i<x.size(); ++i)
+        addLaneGram<K>(gram, x[i], y[i], weight);
+  }
+
+  /** \brief Mix the lanes of two blocks
+   *
+   * Adds \f$\sum_a x_a\,m_{ab}\f$ to lane b of y for all lanes b,
+   * where m[a*lanes+b] are the entries of a square scalar matrix.
+   */
+  template<class K, class B, class M>
+  void addLaneCombination (B& y, const B& x, const M& m)
+  {
+    if constexpr (std::is_same<B,K>::value)
+    {
+      const std::size_t lanes = Simd::lanes<K>();
+      for (std::size_t a=0; a<lanes; ++a)
+      {
+        const Simd::Scalar<K> xa = Simd::lane(a,x);
+        for (std::size_t b=0; b<lanes; ++b)
+          Simd::lane(b,y) += xa*m[a*lanes+b];
+      }
+    }
+    else
+      for (std::size_t i=0; i<x.size(); ++i)
+        addLaneCombination<K>(y[i], x[i], m);
+  }
+
   /**
       \brief An unmanaged vector of blocks.
 
@@ -212,6 +263,51 @@ namespace Imp {
       return sum;
     }
 
+    /**
+     * @brief several vector dot products \f$\left (y_k^H \cdot x \right)\f$ in a single sweep, which corresponds to Petsc's VecMDot
+     *
+     * http://www.mcs.anl.gov/petsc/petsc-current/docs/manualpages/Vec/VecMDot.html
+     * @param y pointers to other (compatible) vectors
+     * @return the vector of the dot products of y[k] and this vector
+     */
+    template<class V>
+    auto mdot (const std::vector<const V*>& y) const
+    {
+      typedef typename PromotionTraits<field_type,typename V::field_type>::PromotedType PromotedType;
+      std::vector<PromotedType> sum(y.size(), PromotedType(0));
+#ifdef DUNE_ISTL_WITH_CHECKING
+      for (std::size_t k=0; k<y.size(); ++k)
+        if (this->n!=y[k]->N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+
+      for (size_type i=0; i<this->n; ++i)
+        for (std::size_t k=0; k<y.size(); ++k)
+          sum[k] += Impl::asVector((*y[k])[i]).dot(Impl::asVector((*this)[i]));
+
+      return sum;
+    }
+
+    /**
+     * @brief several axpy operations \f$\left (x = x + \sum_k a_k y_k \right)\f$ in a single sweep, which corresponds to Petsc's VecMAXPY
+     *
+     * http://www.mcs.anl.gov/petsc/petsc-current/docs/manualpages/Vec/VecMAXPY.html
+     * @param a the scaling factors
+     * @param y pointers to other (compatible) vectors
+     */
+    template<class F, class FA, class V>
+    block_vector_unmanaged& maxpy (const std::vector<F,FA>& a, const std::vector<const V*>& y)
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      for (std::size_t k=0; k<y.size(); ++k)
+        if (this->n!=y[k]->N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+      for (size_type i=0; i<this->n; ++i)
+        for (std::size_t k=0; k<y.size(); ++k)
+          Impl::asVector((*this)[i]).axpy(a[k],Impl::asVector((*y[k])[i]));
+
+      return *this;
+    }
+
     //===== norms
 
     //! one norm (sum over absolute values of entries)
@@ -0,0 +1,85 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_COMMON_THREADING_HH
+#define DUNE_ISTL_COMMON_THREADING_HH
+
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** \file
+ * \brief Minimal helpers for running ISTL kernels on several threads.
+ *
+ * The threads are provided by OpenMP if the code is compiled with OpenMP
+ * support (see the CMake function `add_dune_openmp_flags`). Without it all
+ * loops are executed serially by the calling thread.
+ */
+
+namespace Dune {
+  namespace Impl {
+
+    //! \brief The number of threads the threaded kernels may use.
+    inline int threadCount ()
+    {
+#ifdef _OPENMP
+      return omp_get_max_threads();
+#else
+      return 1;
+#endif
+    }
+
+    //! \brief The index of the calling thread in [0,threadCount()), e.g. to select per-thread scratch storage.
+    inline int threadIndex ()
+    {
+#ifdef _OPENMP
+      return omp_get_thread_num();
+#else
+      return 0;
+#endif
+    }
+
+    //! \brief Whether the threaded kernels run on more than one thread.
+    inline bool threadsEnabled ()
+    {
+      return threadCount() > 1;
+    }
+
+    /**
+     * \brief Call `f(i)` for all `i` in `[begin,end)`.
+     *
+     * The range is distributed statically over the available threads.
+     * Ranges shorter than twice the grain size are processed serially
+     * by the calling thread, as are nested calls. The order in which the
+     * indices are visited is unspecified and `f` must not throw.
+     *
+     * \param begin First index.
+     * \param end One past the last index.
+     * \param f The loop body.
+     * \param grainSize Minimum number of indices per thread.
+     */
+    template<class Index, class F>
+    void parallelFor (Index begin, Index end, F&& f, std::size_t grainSize = 256)
+    {
+#ifdef _OPENMP
+      if (end > begin && std::size_t(end - begin) >= 2*grainSize
+          && !omp_in_parallel() && threadCount() > 1)
+      {
+        const std::ptrdiff_t n = end - begin;
+#pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t k = 0; k < n; ++k)
+          f(begin + Index(k));
+        return;
+      }
+#else
+      (void)grainSize;
+#endif
+      for (Index i = begin; i < end; ++i)
+        f(i);
+    }
+
+  } // end namespace Impl
+} // end namespace Dune
+
+#endif
@@ -0,0 +1,357 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_CPR_HH
+#define DUNE_ISTL_CPR_HH
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/istl/paamg/amg.hh>
+
+#include "bcrsmatrix.hh"
+#include "bvector.hh"
+#include "istlexception.hh"
+#include "operators.hh"
+#include "preconditioner.hh"
+#include "preconditioners.hh"
+#include "solvercategory.hh"
+#include "solverregistry.hh"
+
+/** \file
+ * \brief Constrained pressure residual (CPR) preconditioner.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Prec
+          @{
+   */
+
+  /**
+   * \brief Two-stage constrained pressure residual (CPR) preconditioner.
+   *
+   * For systems of equations with one pressure like unknown per block,
+   * e.g. black-oil reservoir models stored as
+   * `BCRSMatrix<FieldMatrix<double,3,3>>`, the pressure is decoupled by
+   * quasi-IMPES weights: \f$w_i\f$ solves \f$A_{ii}^Tw_i = e_p\f$, where p is
+   * the index of the pressure in the blocks. The scalar pressure matrix
+   * \f$(A_p)_{ij} = w_i^TA_{ij}e_p\f$ is preconditioned by an algebraic
+   * multigrid cycle, the full system by ILU(n):
+   *
+   *  1. \f$v = e_p\,\mathrm{AMG}(w^Td)\f$,
+   *  2. \f$v \mathrel{+}= \mathrm{ILU}(d - Av)\f$.
+   *
+   * update() recomputes the weights and the values of the pressure matrix
+   * and reuses the AMG hierarchy and the symbolic ILU phase, so only the
+   * numeric parts of the setup are repeated in every Newton step.
+   *
+   * \tparam M The matrix type to operate on, a BCRSMatrix with square FieldMatrix blocks.
+   * \tparam X Type of the update
+   * \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class CPRPreconditioner : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief The type of the matrix blocks.
+    typedef typename matrix_type::block_type block_type;
+    //! \brief The number of unknowns per block.
+    static constexpr int blocksize = block_type::rows;
+
+    //! \brief The type of the pressure matrix.
+    typedef BCRSMatrix<FieldMatrix<field_type,1,1> > pressure_matrix_type;
+    //! \brief The type of the pressure vectors.
+    typedef BlockVector<FieldVector<field_type,1> > pressure_vector_type;
+    //! \brief The type of the pressure operator.
+    typedef MatrixAdapter<pressure_matrix_type,pressure_vector_type,pressure_vector_type> pressure_operator_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param pressureIndex The index of the pressure in the blocks.
+       \param pressureConfig The parameters of the AMG for the pressure matrix, see Amg::AMG.
+              The key smoother selects the AMG smoother, default=ssor.
+       \param n The order of the ILU decomposition of the second stage.
+       \param w The relaxation factor of the ILU decomposition.
+     */
+    CPRPreconditioner (const M& A, int pressureIndex, const ParameterTree& pressureConfig,
+                       int n = 0, scalar_field_type w = 1.0)
+      : A_(A),
+        pressureIndex_(pressureIndex),
+        ilu_(A, n, w)
+    {
+      if (pressureIndex < 0 || pressureIndex >= blocksize)
+        DUNE_THROW(ISTLError, "pressure index " << pressureIndex << " out of range");
+
+      // the pressure matrix has the sparsity pattern of A
+      Ap_.setBuildMode(pressure_matrix_type::row_wise);
+      Ap_.setSize(A.N(), A.M(), A.nonzeroes());
+      for (auto row = Ap_.createbegin(); row != Ap_.createend(); ++row)
+        for (auto j = A[row.index()].begin(); j != A[row.index()].end(); ++j)
+          row.insert(j.index());
+
+      computePressureMatrix();
+
+      pressureOperator_ = std::make_shared<pressure_operator_type>(Ap_);
+      std::string smoother = pressureConfig.get("smoother", "ssor");
+      amg_ = AMGCreator().makeAMG(pressureOperator_, smoother, pressureConfig);
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      pressureIndex     | The index of the pressure in the blocks. default=0
+      pressure          | Subtree with the parameters of the AMG for the pressure matrix.
+      n                 | The order of the ILU decomposition of the second stage. default=0
+      relaxation        | The relaxation factor of the ILU decomposition. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    CPRPreconditioner (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : CPRPreconditioner(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       pressureIndex     | The index of the pressure in the blocks. default=0
+       pressure          | Subtree with the parameters of the AMG for the pressure matrix.
+       n                 | The order of the ILU decomposition of the second stage. default=0
+       relaxation        | The relaxation factor of the ILU decomposition. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    CPRPreconditioner (const M& A, const ParameterTree& configuration)
+      : CPRPreconditioner(A, configuration.get<int>("pressureIndex", 0),
+                          configuration.sub("pressure"),
+                          configuration.get<int>("n", 0),
+                          configuration.get<scalar_field_type>("relaxation", 1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      rp_.resize(A_.N());
+      xp_.resize(A_.N());
+      restrict(b, rp_);
+      xp_ = 0;
+      amg_->pre(xp_, rp_);
+      ilu_.pre(x, b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      // first stage: correction of the decoupled pressure
+      restrict(d, rp_);
+      xp_ = 0;
+      amg_->apply(xp_, rp_);
+      v = 0;
+      Impl::parallelFor(std::size_t(0), std::size_t(v.size()), [&](std::size_t i){
+          v[i][pressureIndex_] = xp_[i][0];
+        });
+
+      // second stage: ILU on the remaining defect of the full system
+      r_ = d;
+      A_.mmv(v, r_);
+      t_ = v;
+      ilu_.apply(t_, r_);
+      v += t_;
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      amg_->post(xp_);
+      ilu_.post(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the weights and the pressure matrix on the existing
+       pattern, the AMG hierarchy and the symbolic ILU phase are reused.
+     */
+    virtual void update ()
+    {
+      computePressureMatrix();
+      amg_->update();
+      ilu_.update();
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The decoupled pressure matrix.
+    const pressure_matrix_type& pressureMatrix () const
+    {
+      return Ap_;
+    }
+
+  private:
+    //! compute the quasi-IMPES weights and the values of the pressure matrix
+    void computePressureMatrix ()
+    {
+      typedef typename matrix_type::size_type size_type;
+      weights_.resize(A_.N());
+      std::atomic<size_type> failedRow(A_.N());
+
+      Impl::parallelFor(size_type(0), A_.N(), [&](size_type i){
+          auto ii = A_[i].find(i);
+          if (ii == A_[i].end())
+          {
+            failedRow = i;
+            return;
+          }
+
+          // w_i solves A_ii^T w_i = e_p
+          block_type transposed;
+          for (int r = 0; r < blocksize; ++r)
+            for (int c = 0; c < blocksize; ++c)
+              transposed[r][c] = (*ii)[c][r];
+          FieldVector<field_type,blocksize> unit(0);
+          unit[pressureIndex_] = 1;
+          try {
+            transposed.solve(weights_[i], unit);
+          }
+          catch (Dune::FMatrixError&) {
+            failedRow = i;
+            return;
+          }
+
+          auto pij = Ap_[i].begin();
+          for (auto ij = A_[i].begin(); ij != A_[i].end(); ++ij, ++pij)
+          {
+            field_type value = 0;
+            for (int r = 0; r < blocksize; ++r)
+              value += weights_[i][r] * (*ij)[r][pressureIndex_];
+            *pij = value;
+          }
+        });
+
+      const size_type failed = failedRow;
+      if (failed != A_.N())
+      {
+        if (A_[failed].find(failed) == A_[failed].end())
+          DUNE_THROW(ISTLError, "diagonal entry missing");
+        DUNE_THROW(MatrixBlockError, "CPR failed to compute the weights of row " << failed;
+                   th__ex.r=failed; th__ex.c=failed;);
+      }
+    }
+
+    //! rp_i = w_i^T d_i
+    void restrict (const Y& d, pressure_vector_type& rp) const
+    {
+      Impl::parallelFor(std::size_t(0), std::size_t(d.size()), [&](std::size_t i){
+          field_type value = 0;
+          for (int r = 0; r < blocksize; ++r)
+            value += weights_[i][r] * d[i][r];
+          rp[i] = value;
+        });
+    }
+
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The index of the pressure in the blocks.
+    const int pressureIndex_;
+    //! \brief The quasi-IMPES weights.
+    std::vector<FieldVector<field_type,blocksize> > weights_;
+    //! \brief The decoupled pressure matrix.
+    pressure_matrix_type Ap_;
+    //! \brief The operator of the pressure matrix.
+    std::shared_ptr<pressure_operator_type> pressureOperator_;
+    //! \brief The AMG for the pressure matrix.
+    std::shared_ptr<Preconditioner<pressure_vector_type,pressure_vector_type> > amg_;
+    //! \brief The ILU of the second stage.
+    SeqILU<M,X,Y> ilu_;
+    //! \brief Temporaries.
+    pressure_vector_type rp_, xp_;
+    X t_;
+    Y r_;
+  };
+
+  struct CPRCreator {
+    template<class> struct isValidBlockType : std::false_type{};
+    template<class T, int n> struct isValidBlockType<FieldMatrix<T,n,n>> : std::is_floating_point<T>{};
+
+    // the weights are applied to the defect, so SIMD vectors are not supported
+    template<class TL, class OP>
+    using isValid = std::integral_constant<bool,
+      isValidBlockType<typename OP::matrix_type::block_type>::value
+      && std::is_same<typename Dune::TypeListElement<1, TL>::type::field_type,
+                      typename OP::matrix_type::field_type>::value>;
+
+    template<typename TL, typename OP>
+    std::shared_ptr<Dune::Preconditioner<typename Dune::TypeListElement<1, TL>::type,
+                                         typename Dune::TypeListElement<2, TL>::type>>
+    operator() (TL tl, const std::shared_ptr<OP>& op, const Dune::ParameterTree& config,
+                std::enable_if_t<isValid<TL,OP>::value,int> = 0) const
+    {
+      using M = typename Dune::TypeListElement<0, decltype(tl)>::type;
+      using D = typename Dune::TypeListElement<1, decltype(tl)>::type;
+      using R = typename Dune::TypeListElement<2, decltype(tl)>::type;
+      if (op->category() != SolverCategory::sequential)
+        DUNE_THROW(InvalidSolverCategory, "CPR is only implemented for sequential operators");
+      std::shared_ptr<Preconditioner<D,R>> preconditioner
+        = std::make_shared<CPRPreconditioner<M,D,R>>(op, config);
+      return preconditioner;
+    }
+
+    template<typename TL, typename OP>
+    std::shared_ptr<Dune::Preconditioner<typename Dune::TypeListElement<1, TL>::type,
+                                         typename Dune::TypeListElement<2, TL>::type>>
+    operator() (TL /*tl*/, const std::shared_ptr<OP>& /*op*/, const Dune::ParameterTree& /*config*/,
+                std::enable_if_t<!isValid<TL,OP>::value,int> = 0) const
+    {
+      DUNE_THROW(UnsupportedType, "CPR needs a square FieldMatrix with a real field type as Matrix block_type "
+                 "and vectors with the same field type");
+    }
+  };
+  DUNE_REGISTER_PRECONDITIONER("cpr", CPRCreator());
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
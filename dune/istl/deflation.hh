@@ -0,0 +1,274 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_DEFLATION_HH
+#define DUNE_ISTL_DEFLATION_HH
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/shared_ptr.hh>
+
+#include "istlexception.hh"
+#include "operators.hh"
+#include "preconditioner.hh"
+#include "scalarproducts.hh"
+#include "solvercategory.hh"
+
+/** \file
+ * \brief Preconditioner wrapper removing a coarse space by deflation.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Prec
+          @{
+   */
+
+  /**
+   * \brief The variants of the deflated preconditioner.
+   *
+   * With the coarse matrix \f$E = Z^HAZ\f$, the coarse correction
+   * \f$Q = ZE^{-1}Z^H\f$ and the preconditioner \f$M^{-1}\f$ the variants are
+   *  - ADEF1: \f$M^{-1}(I - AQ) + Q\f$,
+   *  - ADEF2: \f$(I - QA)M^{-1} + Q\f$.
+   *
+   * Both need one application of the operator per step. ADEF2 is more
+   * robust with respect to inexact coarse solves and starting vectors.
+   */
+  struct DeflationVariant
+  {
+    enum Variant {
+      ADEF1,
+      ADEF2
+    };
+  };
+
+  /**
+   * \brief Deflation of a coarse space around an arbitrary preconditioner.
+   *
+   * The columns of \f$Z\f$ are a small number of vectors, e.g. the near
+   * kernel of the operator or vectors recycled from previous solves, that
+   * the Krylov method would otherwise have to rediscover. The coarse
+   * matrix \f$E = Z^HAZ\f$ is computed with the given scalar product and
+   * inverted once; the application then combines the wrapped preconditioner
+   * with the coarse correction \f$Q = ZE^{-1}Z^H\f$ (see DeflationVariant).
+   *
+   * pre() also corrects the initial guess x by \f$Q(b - Ax)\f$, which
+   * removes the error components in the coarse space from the start.
+   *
+   * \tparam X The type of the domain.
+   * \tparam Y The type of the range.
+   * \tparam P The type of the wrapped preconditioner.
+   */
+  template<class X, class Y = X, class P = Preconditioner<X,Y> >
+  class DeflationPreconditioner : public Preconditioner<X,Y> {
+  public:
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The type of the deflation space.
+    typedef std::vector<X> space_type;
+
+    /*! \brief Constructor.
+
+       \param op The linear operator.
+       \param prec The preconditioner to wrap.
+       \param Z The vectors spanning the deflation space.
+       \param variant The variant of the deflated preconditioner.
+     */
+    DeflationPreconditioner (const LinearOperator<X,Y>& op, P& prec, space_type Z,
+                             DeflationVariant::Variant variant = DeflationVariant::ADEF2)
+      : DeflationPreconditioner(stackobject_to_shared_ptr(op), stackobject_to_shared_ptr(prec),
+                                std::make_shared<SeqScalarProduct<X> >(), std::move(Z), variant)
+    {}
+
+    /*! \brief Constructor.
+
+       \param op The linear operator.
+       \param prec The preconditioner to wrap.
+       \param sp The scalar product used for the coarse space, e.g.
+                 OverlappingSchwarzScalarProduct for parallel problems.
+       \param Z The vectors spanning the deflation space.
+       \param variant The variant of the deflated preconditioner.
+     */
+    DeflationPreconditioner (const std::shared_ptr<const LinearOperator<X,Y> >& op,
+                             const std::shared_ptr<P>& prec,
+                             const std::shared_ptr<const ScalarProduct<X> >& sp,
+                             space_type Z,
+                             DeflationVariant::Variant variant = DeflationVariant::ADEF2)
+      : op_(op), prec_(prec), sp_(sp), variant_(variant)
+    {
+      setDeflationSpace(std::move(Z));
+    }
+
+    /*!
+       \brief Replace the deflation space, e.g. by vectors recycled from a previous solve.
+
+       The coarse matrix is recomputed and inverted.
+
+       \throws ISTLError if the coarse matrix is singular, i.e. the
+               vectors are linearly dependent.
+     */
+    void setDeflationSpace (space_type Z)
+    {
+      Z_ = std::move(Z);
+      computeCoarseMatrix();
+    }
+
+    //! \brief The vectors spanning the deflation space.
+    const space_type& deflationSpace () const
+    {
+      return Z_;
+    }
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      prec_->pre(x,b);
+      if (Z_.empty())
+        return;
+      r_ = b;
+      op_->applyscaleadd(-1.0,x,r_);
+      coarseCorrection(r_, x);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      if (Z_.empty())
+      {
+        prec_->apply(v,d);
+        return;
+      }
+
+      if (variant_ == DeflationVariant::ADEF1)
+      {
+        // v = M^{-1}(d - AQd) + Qd
+        t_ = v;
+        t_ = 0;
+        coarseCorrection(d, t_);
+        r_ = d;
+        op_->applyscaleadd(-1.0,t_,r_);
+        prec_->apply(v,r_);
+        v += t_;
+      }
+      else
+      {
+        // v = w + Q(d - Aw) with w = M^{-1}d
+        prec_->apply(v,d);
+        r_ = d;
+        op_->applyscaleadd(-1.0,v,r_);
+        coarseCorrection(r_, v);
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      prec_->post(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Updates the wrapped preconditioner and recomputes the coarse matrix.
+     */
+    virtual void update ()
+    {
+      prec_->update();
+      computeCoarseMatrix();
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return prec_->category();
+    }
+
+  private:
+    void computeCoarseMatrix ()
+    {
+      const std::size_t k = Z_.size();
+      Einv_ = DynamicMatrix<field_type>(k, k, field_type(0));
+      dots_.assign(k, field_type(0));
+      coarse_.assign(k, field_type(0));
+      if (k == 0)
+        return;
+
+      r_ = Y(Z_[0].size());
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        op_->apply(Z_[j], r_);
+        for (std::size_t i = 0; i < k; ++i)
+          Einv_[i][j] = sp_->dot(Z_[i], r_);
+      }
+
+      try {
+        Einv_.invert();
+      }
+      catch (FMatrixError&) {
+        DUNE_THROW(ISTLError, "coarse matrix of the deflation space is singular");
+      }
+    }
+
+    //! x += Qr
+    void coarseCorrection (const Y& r, X& x)
+    {
+      const std::size_t k = Z_.size();
+      for (std::size_t i = 0; i < k; ++i)
+        dots_[i] = sp_->dot(Z_[i], r);
+      for (std::size_t i = 0; i < k; ++i)
+      {
+        coarse_[i] = 0;
+        for (std::size_t j = 0; j < k; ++j)
+          coarse_[i] += Einv_[i][j] * dots_[j];
+      }
+      for (std::size_t i = 0; i < k; ++i)
+        x.axpy(coarse_[i], Z_[i]);
+    }
+
+    //! \brief The linear operator.
+    std::shared_ptr<const LinearOperator<X,Y> > op_;
+    //! \brief The wrapped preconditioner.
+    std::shared_ptr<P> prec_;
+    //! \brief The scalar product for the coarse space.
+    std::shared_ptr<const ScalarProduct<X> > sp_;
+    //! \brief The variant of the deflation.
+    DeflationVariant::Variant variant_;
+    //! \brief The vectors spanning the deflation space.
+    space_type Z_;
+    //! \brief The inverse of the coarse matrix Z^H A Z.
+    DynamicMatrix<field_type> Einv_;
+    //! \brief The projection Z^H r of a residual onto the coarse space.
+    std::vector<field_type> dots_;
+    //! \brief The coefficients of the coarse correction.
+    std::vector<field_type> coarse_;
+    //! \brief Temporaries.
+    X t_;
+    Y r_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
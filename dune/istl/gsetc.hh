@@ -8,8 +8,14 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <dune/common/fmatrix.hh>
 #include <dune/common/hybridutilities.hh>
+#include <dune/common/scalarmatrixview.hh>
+#include <dune/common/scalarvectorview.hh>
 
 #include "multitypeblockvector.hh"
 #include "multitypeblockmatrix.hh"
@@ -664,6 +670,171 @@ namespace Dune {
     algmeta_itsteps<l,M>::dbjac(A,x,b,w);
   }
 
+  //============================================================
+  // iteration steps with precomputed inverse diagonal blocks
+  // the sweeps only multiply with the inverses instead of
+  // solving with the diagonal block of each row in each sweep
+  //============================================================
+
+  /**
+   * \brief The inverted diagonal blocks of a matrix.
+   *
+   * This is only defined if the blocks of M can be inverted directly,
+   * i.e. if they are scalars or dense matrices. Otherwise `cached` is
+   * false and nothing is stored.
+   */
+  template<class M, class = void>
+  class InverseBlockDiagonal
+  {
+  public:
+    //! whether the inverted diagonal blocks are stored
+    static constexpr bool cached = false;
+
+    //! nothing to compute
+    void compute (const M& /*A*/)
+    {}
+  };
+
+  template<class M>
+  class InverseBlockDiagonal<M, std::void_t<decltype(Impl::asMatrix(std::declval<typename M::block_type&>()).invert())> >
+  {
+  public:
+    //! whether the inverted diagonal blocks are stored
+    static constexpr bool cached = true;
+
+    //! the type of the blocks
+    typedef typename M::block_type block_type;
+    //! the type for the index access
+    typedef typename M::size_type size_type;
+
+    /**
+     * \brief Invert the diagonal blocks of A.
+     *
+     * \throws ISTLError if a diagonal entry is missing
+     * \throws MatrixBlockError if a diagonal block is singular
+     */
+    void compute (const M& A)
+    {
+      inv_.resize(A.N());
+      for (auto i=A.begin(); i!=A.end(); ++i)
+      {
+        auto ii = i->find(i.index());
+        if (ii == i->end())
+          DUNE_THROW(ISTLError, "diagonal entry missing");
+        inv_[i.index()] = *ii;
+        try {
+          Impl::asMatrix(inv_[i.index()]).invert();
+        }
+        catch (Dune::FMatrixError&) {
+          DUNE_THROW(MatrixBlockError, "Failed to invert matrix block A["
+                     << i.index() << "][" << i.index() << "]";
+                     th__ex.r=i.index(); th__ex.c=i.index(););
+        }
+      }
+    }
+
+    //! the inverse of the i-th diagonal block
+    const block_type& operator[] (size_type i) const
+    {
+      return inv_[i];
+    }
+
+  private:
+    std::vector<block_type> inv_;
+  };
+
+  namespace Impl {
+
+    //! r = b_i - sum_j a_ij x_j, the diagonal block is skipped unless withDiagonal is true
+    template<bool withDiagonal, class Row, class X, class B>
+    void rowDefect (const Row& row, std::size_t i, const X& x, const B& bi, B& r)
+    {
+      r = bi;
+      auto&& rhs = Impl::asVector(r);
+      for (auto j=row.begin(); j!=row.end(); ++j)
+        if (withDiagonal || j.index()!=i)
+          Impl::asMatrix(*j).mmv(Impl::asVector(x[j.index()]),rhs);
+    }
+
+    //! v = D^{-1}_i r using the stored inverse
+    template<class D, class B, class V>
+    void inverseDiagonalMv (const D& invDiag, typename D::size_type i, const B& r, V& v)
+    {
+      auto&& vi = Impl::asVector(v);
+      Impl::asMatrix(invDiag[i]).mv(Impl::asVector(r),vi);
+    }
+
+  } // end namespace Impl
+
+  //! GS step using the inverted diagonal blocks
+  template<class M, class X, class Y, class K>
+  void dbgs (const M& A, const InverseBlockDiagonal<M>& invDiag, X& x, const Y& b, const K& w)
+  {
+    typename Y::block_type rhs;
+    X xold(x);     // remember old x
+
+    for (auto i=A.begin(); i!=A.end(); ++i)
+    {
+      Impl::rowDefect<false>(*i,i.index(),x,b[i.index()],rhs);
+      Impl::inverseDiagonalMv(invDiag,i.index(),rhs,x[i.index()]);
+    }
+    x *= w;
+    x.axpy(K(1)-w,xold);
+  }
+
+  //! SOR step using the inverted diagonal blocks
+  template<class M, class X, class Y, class K>
+  void bsorf (const M& A, const InverseBlockDiagonal<M>& invDiag, X& x, const Y& b, const K& w)
+  {
+    typename Y::block_type rhs;
+    typename X::block_type v;
+
+    // Initialize nested data structure if there are entries
+    if(A.begin()!=A.end())
+      v=x[0];
+
+    for (auto i=A.begin(); i!=A.end(); ++i)
+    {
+      Impl::rowDefect<true>(*i,i.index(),x,b[i.index()],rhs);
+      Impl::inverseDiagonalMv(invDiag,i.index(),rhs,v);
+      Impl::asVector(x[i.index()]).axpy(w,Impl::asVector(v));
+    }
+  }
+
+  //! Backward SOR step using the inverted diagonal blocks
+  template<class M, class X, class Y, class K>
+  void bsorb (const M& A, const InverseBlockDiagonal<M>& invDiag, X& x, const Y& b, const K& w)
+  {
+    typename Y::block_type rhs;
+    typename X::block_type v;
+
+    // Initialize nested data structure if there are entries
+    if(A.begin()!=A.end())
+      v=x[0];
+
+    for (auto i=A.beforeEnd(); i!=A.beforeBegin(); --i)
+    {
+      Impl::rowDefect<true>(*i,i.index(),x,b[i.index()],rhs);
+      Impl::inverseDiagonalMv(invDiag,i.index(),rhs,v);
+      Impl::asVector(x[i.index()]).axpy(w,Impl::asVector(v));
+    }
+  }
+
+  //! Jacobi step using the inverted diagonal blocks
+  template<class M, class X, class Y, class K>
+  void dbjac (const M& A, const InverseBlockDiagonal<M>& invDiag, X& x, const Y& b, const K& w)
+  {
+    typename Y::block_type rhs;
+    X v(x);     // allocate with same size
+
+    for (auto i=A.begin(); i!=A.end(); ++i)
+    {
+      Impl::rowDefect<true>(*i,i.index(),x,b[i.index()],rhs);
+      Impl::inverseDiagonalMv(invDiag,i.index(),rhs,v[i.index()]);
+    }
+    x.axpy(w,v);
+  }
+
 
   /** @} end documentation */
 
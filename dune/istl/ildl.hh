@@ -1,8 +1,16 @@
 #ifndef DUNE_ISTL_ILDL_HH
 #define DUNE_ISTL_ILDL_HH
 
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <dune/common/scalarvectorview.hh>
 #include <dune/common/scalarmatrixview.hh>
+
+#include <dune/istl/common/threading.hh>
+
 #include "ilu.hh"
 
 /**
@@ -215,6 +223,403 @@ namespace Dune
     }
   }
 
+
+  // ILDLLevelSets
+  // -------------
+
+  /**
+   * \brief level sets of an ILDL decomposition
+   *
+   * Besides the level sets of \f$L\f$ and \f$L^T\f$ this stores the pattern of
+   * \f$L^T\f$, i.e., for each row \f$i\f$ the rows \f$k > i\f$ with \f$L_{ki} \neq 0\f$
+   * together with the offset of \f$L_{ki}\f$ within row \f$k\f$. This allows to
+   * eliminate the rows of \f$L^T\f$ independently of each other.
+   **/
+  struct ILDLLevelSets
+  {
+    typedef std::size_t size_type;
+
+    ILU::LevelSets lower;
+    ILU::LevelSets upper;
+
+    std::vector< size_type > transposedStart_;
+    std::vector< size_type > transposedRows_;
+    std::vector< size_type > transposedOffsets_;
+  };
+
+
+
+  // bildl_levelsets
+  // ---------------
+
+  /**
+   * \brief compute the level sets of a lower triangular ILDL decomposition
+   *
+   * Consecutive levels with less than minLevelSize rows are merged and
+   * processed serially (see ILU::LevelSets).
+   *
+   * \note The matrix must be a BCRSMatrix storing the lower triangle only
+   *       (see bildl_backsolve).
+   **/
+  template< class Matrix >
+  inline void bildl_levelsets ( const Matrix &A, ILDLLevelSets &levelSets,
+                                typename ILDLLevelSets::size_type minLevelSize = 512 )
+  {
+    typedef typename ILDLLevelSets::size_type size_type;
+    const size_type n = A.N();
+
+    // level sets of L
+    std::vector< size_type > level( n, 0 );
+    size_type nLevels = 0;
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+    {
+      size_type l = 0;
+      for( auto ij = i->begin(); ij.index() < i.index(); ++ij )
+        l = std::max( l, level[ ij.index() ]+1 );
+      level[ i.index() ] = l;
+      nLevels = std::max( nLevels, l+1 );
+    }
+    levelSets.lower.build( level, nLevels, minLevelSize );
+
+    // pattern of L^T
+    auto &start = levelSets.transposedStart_;
+    start.assign( n+1, 0 );
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+      for( auto ij = i->begin(); ij.index() < i.index(); ++ij )
+        ++start[ ij.index()+1 ];
+    for( size_type i = 0; i < n; ++i )
+      start[ i+1 ] += start[ i ];
+
+    levelSets.transposedRows_.resize( start[ n ] );
+    levelSets.transposedOffsets_.resize( start[ n ] );
+    std::vector< size_type > next( start.begin(), start.end()-1 );
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+    {
+      for( auto ij = i->begin(); ij.index() < i.index(); ++ij )
+      {
+        const size_type pos = next[ ij.index() ]++;
+        levelSets.transposedRows_[ pos ] = i.index();
+        levelSets.transposedOffsets_[ pos ] = ij.offset();
+      }
+    }
+
+    // level sets of L^T, eliminated from the last row upwards
+    const size_type lastRow = n - 1;
+    nLevels = 0;
+    for( size_type i = n; i-- > 0; )
+    {
+      size_type l = 0;
+      for( size_type pos = start[ i ]; pos < start[ i+1 ]; ++pos )
+        l = std::max( l, level[ lastRow - levelSets.transposedRows_[ pos ] ]+1 );
+      level[ lastRow - i ] = l;
+      nLevels = std::max( nLevels, l+1 );
+    }
+    levelSets.upper.build( level, nLevels, minLevelSize );
+  }
+
+  /**
+   * \brief level-scheduled backsolve for a lower triangular ILDL decomposition
+   *
+   * Equivalent to <tt>bildl_backsolve( A, v, d, true )</tt>, but the rows of
+   * each level are processed concurrently.
+   **/
+  template< class Matrix, class X, class Y >
+  inline void bildl_backsolve ( const Matrix &A, const ILDLLevelSets &levelSets, X &v, const Y &d )
+  {
+    typedef typename ILDLLevelSets::size_type size_type;
+    const size_type lastRow = A.N() - 1;
+
+    // solve L v = d, note: Lii = I
+    levelSets.lower.forEachRow( [ & ] ( const size_type i )
+    {
+      const auto &A_i = A[ i ];
+      v[ i ] = d[ i ];
+      auto&& vi = Impl::asVector( v[ i ] );
+      for( auto ij = A_i.begin(); ij.index() < i; ++ij )
+        Impl::asMatrix(*ij).mmv(Impl::asVector( v[ ij.index() ] ), vi);
+    } );
+
+    // solve D w = v, note: diagonal stores Dii^{-1} and is the last entry in each row
+    Impl::parallelFor( size_type( 0 ), size_type( A.N() ), [ & ] ( const size_type i )
+    {
+      const auto ii = A[ i ].beforeEnd();
+      assert( ii.index() == i );
+      auto rhsValue = v[ i ];
+      auto&& rhs = Impl::asVector(rhsValue);
+      auto&& vi = Impl::asVector( v[ i ] );
+      Impl::asMatrix(*ii).mv(rhs, vi);
+    } );
+
+    // solve L^T v = w, using the transposed pattern
+    levelSets.upper.forEachRow( [ & ] ( const size_type k )
+    {
+      const size_type i = lastRow - k;
+      auto&& vi = Impl::asVector( v[ i ] );
+      for( size_type pos = levelSets.transposedStart_[ i ]; pos < levelSets.transposedStart_[ i+1 ]; ++pos )
+      {
+        const size_type row = levelSets.transposedRows_[ pos ];
+        const auto &L_ki = A[ row ].getptr()[ levelSets.transposedOffsets_[ pos ] ];
+        Impl::asMatrix(L_ki).mmtv(Impl::asVector( v[ row ] ), vi);
+      }
+    } );
+  }
+
+
+  // bic_pattern
+  // -----------
+
+  /**
+   * \brief symbolic incomplete Cholesky decomposition of order n
+   *
+   * Computes the sparsity pattern of the IC(n) decomposition of a symmetric
+   * matrix A, i.e., the lower triangle of the ILU(n) pattern (see
+   * bilu_pattern). The matrix L should be an empty matrix in row_wise
+   * creation mode, only the lower triangle including the diagonal is stored.
+   **/
+  template< class Matrix >
+  inline void bic_pattern ( const Matrix &A, int n, Matrix &L )
+  {
+    Matrix ILU( A.N(), A.M(), Matrix::row_wise );
+    bilu_pattern( A, n, ILU );
+
+    for( auto row = L.createbegin(), rowend = L.createend(); row != rowend; ++row )
+    {
+      const auto &ILU_i = ILU[ row.index() ];
+      for( auto ij = ILU_i.begin(); (ij != ILU_i.end()) && (ij.index() <= row.index()); ++ij )
+        row.insert( ij.index() );
+    }
+  }
+
+
+
+  // bic_checkPivot
+  // --------------
+
+  /**
+   * \brief check the inverted pivot block of row i of an incomplete Cholesky decomposition
+   *
+   * \throws MatrixBlockError if a diagonal entry is not positive, i.e., the
+   *         decomposition broke down for a symmetric positive definite matrix.
+   **/
+  template< class Block, class size_type >
+  inline void bic_checkPivot ( const Block &Dinv, size_type i )
+  {
+    using std::real;
+    const auto &D = Impl::asMatrix( Dinv );
+    for( std::size_t r = 0; r < D.N(); ++r )
+      if( !(real( D[ r ][ r ] ) > 0) )
+        DUNE_THROW( MatrixBlockError, "IC failed, pivot of row " << i << " is not positive"; th__ex.r = i; th__ex.c = i );
+  }
+
+
+
+  // bic_numeric
+  // -----------
+
+  /**
+   * \brief numeric incomplete Cholesky decomposition
+   *
+   * Copies the lower triangle of A into the pattern of L, e.g. computed by
+   * bic_pattern, multiplies the diagonal blocks by (1+alpha) and computes
+   * the ILDL decomposition on this pattern (see bildl_decompose).
+   *
+   * \throws MatrixBlockError if the decomposition breaks down
+   **/
+  template< class Matrix, class real_type >
+  inline void bic_numeric ( const Matrix &A, real_type alpha, Matrix &L )
+  {
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+    {
+      auto &&L_i = L[ i.index() ];
+      auto ij = i->begin();
+      const auto ijend = i->end();
+      for( auto lij = L_i.begin(), ljend = L_i.end(); lij != ljend; ++lij )
+      {
+        while( (ij != ijend) && (ij.index() < lij.index()) )
+          ++ij;
+        if( (ij != ijend) && (ij.index() == lij.index()) )
+          *lij = *ij;
+        else
+          *lij = 0;
+      }
+      if( L_i.beforeEnd().index() == i.index() )
+        *L_i.beforeEnd() *= (1 + alpha);
+    }
+
+    bildl_decompose( L );
+    for( auto i = L.begin(), iend = L.end(); i != iend; ++i )
+      bic_checkPivot( *i->beforeEnd(), i.index() );
+  }
+
+
+
+  // bict_decomposition
+  // ------------------
+
+  /**
+   * \brief threshold incomplete Cholesky decomposition
+   *
+   * Computes the ICT(p,tau) decomposition of a symmetric matrix A in the
+   * format of bildl_decompose: the lower triangle stores L and the diagonal
+   * the inverse of D. In each row i the entries of L with a norm below tau
+   * times the norm of row i of A are dropped and of the remaining ones only
+   * the p largest are kept. The diagonal blocks of A are multiplied by
+   * (1+alpha). The matrix L should be an empty matrix in row_wise creation
+   * mode.
+   *
+   * \throws MatrixBlockError if the decomposition breaks down
+   **/
+  template< class Matrix >
+  inline void bict_decomposition ( const Matrix &A, int p,
+                                   typename FieldTraits< Simd::Scalar< typename Matrix::field_type > >::real_type tau,
+                                   typename FieldTraits< Simd::Scalar< typename Matrix::field_type > >::real_type alpha,
+                                   Matrix &L )
+  {
+    typedef typename Matrix::size_type size_type;
+    typedef typename Matrix::block_type block;
+    typedef typename FieldTraits< Simd::Scalar< typename Matrix::field_type > >::real_type real_type;
+
+    // all SIMD lanes share the pattern, so drop by the largest lane
+    auto norm2 = [] ( const block &b ) -> real_type {
+      return Simd::max( Impl::asMatrix( b ).frobenius_norm2() );
+    };
+
+    const size_type n = A.N();
+    std::vector< block > w( n );                    // the working row
+    std::vector< size_type > marker( n, n );        // marker[j]==i if j is in the working row i
+    std::set< size_type > lower;                    // columns left of the diagonal, in elimination order
+    std::vector< size_type > kept, rowpattern;
+    std::vector< std::pair< real_type, size_type > > candidates;
+    // for each column k the rows j > k with L_jk != 0 and the offset of L_jk in row j
+    std::vector< std::vector< std::pair< size_type, size_type > > > columns( n );
+
+    auto ci = L.createbegin();
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+    {
+      const size_type row = i.index();
+      lower.clear();
+      kept.clear();
+
+      // initialize working row with the lower triangle of row i of A
+      real_type rowNorm2 = 0;
+      marker[ row ] = row;
+      w[ row ] = 0;
+      for( auto ij = i->begin(), ijend = i->end(); ij != ijend; ++ij )
+      {
+        rowNorm2 += norm2( *ij );
+        if( ij.index() > row )
+          continue;
+        marker[ ij.index() ] = row;
+        w[ ij.index() ] = *ij;
+        if( ij.index() < row )
+          lower.insert( ij.index() );
+      }
+      w[ row ] *= (1 + alpha);
+      const real_type threshold2 = tau*tau*rowNorm2;
+
+      // eliminate entries left of the diagonal, w_k = L_ik D_k when k is reached
+      for( auto k = lower.begin(); k != lower.end(); ++k )
+      {
+        const block LD = w[ *k ];
+        block &L_ik = w[ *k ];
+        Impl::asMatrix( L_ik ).rightmultiply( Impl::asMatrix( *L[ *k ].beforeEnd() ) );
+        if( norm2( L_ik ) < threshold2 )
+          continue;
+        kept.push_back( *k );
+
+        // w_j -= (L_ik D_k) L_jk^T, fill-in is inserted behind k
+        for( const auto &jk : columns[ *k ] )
+        {
+          if( marker[ jk.first ] != row )
+          {
+            marker[ jk.first ] = row;
+            w[ jk.first ] = 0;
+            lower.insert( jk.first );
+          }
+          bildl_subtractBCT( LD, L[ jk.first ].getptr()[ jk.second ], w[ jk.first ] );
+        }
+
+        // D_i -= (L_ik D_k) L_ik^T
+        bildl_subtractBCT( LD, L_ik, w[ row ] );
+      }
+
+      // keep the p largest entries of L
+      candidates.clear();
+      for( size_type j : kept )
+        candidates.emplace_back( norm2( w[ j ] ), j );
+      if( candidates.size() > size_type( p ) )
+      {
+        std::nth_element( candidates.begin(), candidates.begin()+p, candidates.end(),
+                          [] ( const auto &a, const auto &b ) { return a.first > b.first; } );
+        candidates.resize( p );
+      }
+      rowpattern.assign( 1, row );
+      for( const auto &c : candidates )
+        rowpattern.push_back( c.second );
+      std::sort( rowpattern.begin(), rowpattern.end() );
+
+      // create row
+      for( size_type j : rowpattern )
+        ci.insert( j );
+      ++ci;
+
+      // copy kept entries, invert the pivot and store it in L
+      auto &&L_i = L[ row ];
+      for( auto ij = L_i.begin(), ijend = L_i.end(); ij != ijend; ++ij )
+      {
+        *ij = w[ ij.index() ];
+        if( ij.index() < row )
+          columns[ ij.index() ].emplace_back( row, ij.offset() );
+      }
+      auto &&L_ii = *L_i.beforeEnd();
+      try
+      {
+        Impl::asMatrix( L_ii ).invert();
+      }
+      catch( const Dune::FMatrixError &e )
+      {
+        DUNE_THROW( MatrixBlockError, "ICT failed to invert matrix block A[" << row << "][" << row << "]" << e.what(); th__ex.r = row; th__ex.c = row );
+      }
+      bic_checkPivot( L_ii, row );
+    }
+  }
+
+
+
+  // bic_shifted
+  // -----------
+
+  /**
+   * \brief incomplete Cholesky decomposition with diagonal shifting
+   *
+   * Calls decompose( alpha ) for alpha = 0 and, each time it breaks down
+   * with a MatrixBlockError, again for alpha = shift, 2 shift, 4 shift, ...
+   * (Manteuffel). decompose( alpha ) has to decompose the matrix with its
+   * diagonal blocks multiplied by (1+alpha), e.g. by bic_numeric.
+   *
+   * \returns the shift alpha of the successful decomposition
+   * \throws MatrixBlockError if the decomposition still breaks down after maxShifts shifts
+   **/
+  template< class Decompose, class real_type >
+  inline real_type bic_shifted ( Decompose &&decompose, real_type shift, int maxShifts = 20 )
+  {
+    real_type alpha = 0;
+    for( int k = 0; ; ++k )
+    {
+      try
+      {
+        decompose( alpha );
+        return alpha;
+      }
+      catch( const MatrixBlockError & )
+      {
+        if( (k >= maxShifts) || !(shift > 0) )
+          throw;
+      }
+      alpha = (k == 0) ? shift : 2*alpha;
+    }
+  }
+
 } // namespace Dune
 
 #endif // #ifndef DUNE_ISTL_ILDL_HH
@@ -3,14 +3,21 @@
 #ifndef DUNE_ISTL_ILU_HH
 #define DUNE_ISTL_ILU_HH
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <map>
+#include <set>
 #include <vector>
 
 #include <dune/common/fmatrix.hh>
+#include <dune/common/ftraits.hh>
 #include <dune/common/scalarvectorview.hh>
 #include <dune/common/scalarmatrixview.hh>
+
+#include <dune/istl/common/threading.hh>
+
 #include "istlexception.hh"
 
 /** \file
@@ -23,12 +30,6 @@ namespace Dune {
           @{
    */
 
-  class MatrixBlockError : public virtual Dune::FMatrixError {
-  public:
-    int r, c;
-  };
-
-
   //! compute ILU decomposition of A. A is overwritten by its decomposition
   template<class M>
   void bilu0_decomposition (M& A)
@@ -159,14 +160,13 @@ namespace Dune {
   }
 
 
-  /*! ILU decomposition of order n
-          Computes ILU decomposition of order n. The matrix ILU should
-      be an empty matrix in row_wise creation mode. This allows the user
-      to either specify the number of nonzero elements or to
-          determine it automatically at run-time.
+  /*! Symbolic ILU decomposition of order n
+          Computes the sparsity pattern of the ILU decomposition of order n.
+      The matrix ILU should be an empty matrix in row_wise creation mode.
+      The values of the entries of ILU are unspecified afterwards.
    */
   template<class M>
-  void bilu_decomposition (const M& A, int n, M& ILU)
+  void bilu_pattern (const M& A, int n, M& ILU)
   {
     // iterator types
     typedef typename M::ColIterator coliterator;
@@ -223,8 +223,25 @@ namespace Dune {
       for (coliterator ILUij=ILU[i.index()].begin(); ILUij!=endILUij; ++ILUij)
         Simd::lane(0,firstmatrixelement(*ILUij)) = (Simd::Scalar<K>) rowpattern[ILUij.index()];
     }
+  }
+
+  /*! Numeric ILU decomposition
+          Computes the ILU decomposition of A on the given pattern of ILU,
+      e.g. the pattern computed by bilu_pattern. The entries of A are
+      copied into ILU, fill-in entries are set to zero and the values are
+      overwritten by the decomposition. The pattern of ILU must contain
+      the pattern of A.
+   */
+  template<class M>
+  void bilu_numeric (const M& A, M& ILU)
+  {
+    // iterator types
+    typedef typename M::ColIterator coliterator;
+    typedef typename M::ConstRowIterator crowiterator;
+    typedef typename M::ConstColIterator ccoliterator;
 
     // copy entries of A
+    crowiterator endi=A.end();
     for (crowiterator i=A.begin(); i!=endi; ++i)
     {
       coliterator ILUij;
@@ -255,6 +272,145 @@ namespace Dune {
     bilu0_decomposition(ILU);
   }
 
+  /*! ILU decomposition of order n
+          Computes ILU decomposition of order n. The matrix ILU should
+      be an empty matrix in row_wise creation mode. This allows the user
+      to either specify the number of nonzero elements or to
+          determine it automatically at run-time.
+   */
+  template<class M>
+  void bilu_decomposition (const M& A, int n, M& ILU)
+  {
+    // symbolic factorization phase
+    bilu_pattern(A, n, ILU);
+
+    // numeric factorization phase
+    bilu_numeric(A, ILU);
+  }
+
+  /*! ILUT decomposition with fill p and threshold tau
+          Computes the ILUT(p,tau) decomposition of Saad. In each row i
+      the entries of the factors with a norm below tau times the norm of
+      row i of A are dropped. Of the remaining entries only the p largest
+      ones left and right of the diagonal are kept, the diagonal is always
+      kept. The matrix ILU should be an empty matrix in row_wise creation
+      mode. As for bilu0_decomposition the diagonal stores the inverse of
+      the diagonal block of U.
+   */
+  template<class M>
+  void bilut_decomposition (const M& A, int p,
+                            typename FieldTraits<Simd::Scalar<typename M::field_type> >::real_type tau,
+                            M& ILU)
+  {
+    typedef typename M::size_type size_type;
+    typedef typename M::block_type block;
+    typedef typename M::CreateIterator createiterator;
+    typedef typename FieldTraits<Simd::Scalar<typename M::field_type> >::real_type real_type;
+
+    // all SIMD lanes share the pattern, so drop by the largest lane
+    auto norm2 = [](const block& b) -> real_type {
+      return Simd::max(Impl::asMatrix(b).frobenius_norm2());
+    };
+
+    const size_type n = A.N();
+    std::vector<block> w(n);                      // the working row
+    std::vector<size_type> marker(n, n);          // marker[j]==i if j is in the working row i
+    std::set<size_type> lower;                    // columns left of the diagonal, in elimination order
+    std::vector<size_type> lowerKept, upper, rowpattern;
+    std::vector<std::pair<real_type,size_type> > candidates;
+
+    createiterator ci=ILU.createbegin();
+    for (auto i=A.begin(); i!=A.end(); ++i)
+    {
+      const size_type row = i.index();
+      lower.clear();
+      lowerKept.clear();
+      upper.clear();
+
+      auto insert = [&](const size_type j) {
+        marker[j] = row;
+        w[j] = 0;
+        if (j<row)
+          lower.insert(j);
+        else
+          upper.push_back(j);
+      };
+
+      // initialize working row with row of A
+      real_type rowNorm2 = 0;
+      for (auto ij=i->begin(); ij!=i->end(); ++ij)
+      {
+        insert(ij.index());
+        w[ij.index()] = *ij;
+        rowNorm2 += norm2(*ij);
+      }
+      if (marker[row]!=row)
+        insert(row);
+      const real_type threshold2 = tau*tau*rowNorm2;
+
+      // eliminate entries left of the diagonal, fill-in is inserted behind k
+      for (auto k=lower.begin(); k!=lower.end(); ++k)
+      {
+        block& wk = w[*k];
+        const auto& rowk = ILU[*k];
+        auto kj = rowk.find(*k);
+
+        // compute L_ik = w_k U_kk^-1
+        Impl::asMatrix(wk).rightmultiply(Impl::asMatrix(*kj));
+        if (norm2(wk)<threshold2)
+          continue;
+        lowerKept.push_back(*k);
+
+        // w_j -= L_ik U_kj
+        for (++kj; kj!=rowk.end(); ++kj)
+        {
+          if (marker[kj.index()]!=row)
+            insert(kj.index());
+          block B(*kj);
+          Impl::asMatrix(B).leftmultiply(Impl::asMatrix(wk));
+          w[kj.index()] -= B;
+        }
+      }
+
+      // keep the p largest entries of L and U above the threshold
+      rowpattern.assign(1, row);
+      for (const auto* part : { &lowerKept, &upper })
+      {
+        candidates.clear();
+        for (size_type j : *part)
+          if (j!=row && norm2(w[j])>=threshold2)
+            candidates.emplace_back(norm2(w[j]), j);
+        if (candidates.size()>size_type(p))
+        {
+          std::nth_element(candidates.begin(), candidates.begin()+p, candidates.end(),
+                           [](const auto& a, const auto& b){ return a.first>b.first; });
+          candidates.resize(p);
+        }
+        for (const auto& c : candidates)
+          rowpattern.push_back(c.second);
+      }
+      std::sort(rowpattern.begin(), rowpattern.end());
+
+      // create row
+      for (size_type j : rowpattern)
+        ci.insert(j);
+      ++ci;           // now row i exist
+
+      // copy kept entries, invert pivot and store it in ILU
+      auto&& iluRow = ILU[row];
+      for (auto ij=iluRow.begin(); ij!=iluRow.end(); ++ij)
+        *ij = w[ij.index()];
+      try {
+        Impl::asMatrix(*iluRow.find(row)).invert();
+      }
+      catch (Dune::FMatrixError & e) {
+        DUNE_THROW(MatrixBlockError, "ILUT failed to invert matrix block A["
+                   << row << "][" << row << "]" << e.what();
+                   th__ex.r=row; th__ex.c=row;);
+      }
+    }
+  }
+
   namespace ILU {
 
     template <class B, class Alloc = std::allocator<B>>
@@ -371,6 +527,41 @@ namespace Dune {
       }
     } // end convertToCRS
 
+    /** \brief copy the values of an ILU decomposition into CRS format.
+
+        The structure of lower and upper, i.e. rows_ and cols_, must have been
+        set up by convertToCRS for a matrix with the same sparsity pattern as A.
+        Only the values and the inverse diagonal are written.
+     */
+    template<class M, class CRS, class InvVector>
+    void copyToCRS(const M& A, CRS& lower, CRS& upper, InvVector& inv )
+    {
+      typedef typename M :: size_type size_type;
+
+      lower.values_.resize( lower.cols_.size() );
+      upper.values_.resize( upper.cols_.size() );
+      inv.resize( A.N() );
+
+      size_type colcount = 0;
+      for (auto i=A.begin(); i!=A.end(); ++i)
+        for (auto j=(*i).begin(); j.index() < i.index(); ++j )
+          lower.values_[ colcount++ ] = (*j);
+
+      // same reverse order as in convertToCRS
+      size_type row = 0;
+      colcount = 0;
+      for (auto i=A.beforeEnd(); i!=A.beforeBegin(); --i, ++row )
+        for (auto j=(*i).beforeEnd(); j != (*i).beforeBegin(); --j )
+        {
+          if( j.index() == i.index() )
+          {
+            inv[ row ] = (*j);
+            break;
+          }
+          upper.values_[ colcount++ ] = (*j);
+        }
+    } // end copyToCRS
+
 
     //! LU backsolve with stored inverse in CRS format for lower and upper triangular
     template<class CRS, class InvVector, class X, class Y>
@@ -422,6 +613,533 @@ namespace Dune {
       }
     }
 
+    /** \brief Rows of a triangular factor grouped into levels (wavefronts).
+
+        All rows of a level only depend on rows of previous levels, so the
+        rows of one level can be eliminated concurrently. Consecutive levels
+        with less than \c minLevelSize rows are merged into a single level
+        that is processed serially in row order, which avoids the
+        synchronization and keeps the memory access pattern of the serial
+        triangular solve where there is nothing to parallelize.
+
+        The rows are counted in the order of elimination, i.e., for an
+        upper triangular factor row \c k refers to row <tt>N-1-k</tt> of the
+        matrix (which matches the storage order of ILU::CRS, see convertToCRS).
+     */
+    struct LevelSets
+    {
+      typedef size_t size_type;
+
+      //! number of levels
+      size_type levels() const { return parallel_.size(); }
+
+      //! true if no level sets have been computed
+      bool empty() const { return rows_.empty(); }
+
+      void clear()
+      {
+        levelStart_.clear();
+        rows_.clear();
+        parallel_.clear();
+      }
+
+      /** \brief group rows by level
+
+          \param level level of each row, every row may only depend on rows with smaller level
+          \param nLevels number of levels
+          \param minLevelSize minimal number of rows of a level that is processed concurrently
+       */
+      void build( const std::vector< size_type >& level, const size_type nLevels,
+                  const size_type minLevelSize = 512 )
+      {
+        // counting sort, keeps the row order within a level
+        std::vector< size_type > start( nLevels+1, 0 );
+        for( size_type row = 0; row < level.size(); ++row )
+          ++start[ level[ row ]+1 ];
+        for( size_type l = 0; l < nLevels; ++l )
+          start[ l+1 ] += start[ l ];
+
+        std::vector< size_type > next( start.begin(), start.end()-1 );
+        rows_.resize( level.size() );
+        for( size_type row = 0; row < level.size(); ++row )
+          rows_[ next[ level[ row ] ]++ ] = row;
+
+        // merge runs of small levels, their rows are processed in row order
+        levelStart_.assign( 1, 0 );
+        parallel_.clear();
+        for( size_type l = 0; l < nLevels; )
+        {
+          if( start[ l+1 ] - start[ l ] >= minLevelSize )
+          {
+            ++l;
+            parallel_.push_back( true );
+          }
+          else
+          {
+            while( l < nLevels && start[ l+1 ] - start[ l ] < minLevelSize )
+              ++l;
+            std::sort( rows_.begin() + levelStart_.back(), rows_.begin() + start[ l ] );
+            parallel_.push_back( false );
+          }
+          levelStart_.push_back( start[ l ] );
+        }
+      }
+
+      //! call f(row) for all rows, rows of a level are processed concurrently
+      template< class F >
+      void forEachRow( F&& f ) const
+      {
+        for( size_type l = 0; l < levels(); ++l )
+          forEachRowInLevel( l, f );
+      }
+
+      //! call f(row) for all rows, starting with the last level
+      template< class F >
+      void forEachRowReverse( F&& f ) const
+      {
+        for( size_type l = levels(); l-- > 0; )
+          forEachRowInLevel( l, f );
+      }
+
+      //! call f(row) for all rows of level l, concurrently if the level is large enough
+      template< class F >
+      void forEachRowInLevel( const size_type l, F&& f ) const
+      {
+        if( parallel_[ l ] )
+          Impl::parallelFor( levelStart_[ l ], levelStart_[ l+1 ],
+                             [ & ]( const size_type k ) { f( rows_[ k ] ); } );
+        else
+          for( size_type k = levelStart_[ l ]; k < levelStart_[ l+1 ]; ++k )
+            f( rows_[ k ] );
+      }
+
+      std::vector< size_type > levelStart_;
+      std::vector< size_type > rows_;
+      std::vector< bool > parallel_;
+    };
+
+    //! compute the level sets of the factors of an ILU decomposition stored in a matrix
+    template<class M>
+    void computeLevelSets (const M& A, LevelSets& lowerLevels, LevelSets& upperLevels,
+                           const typename LevelSets::size_type minLevelSize = 512)
+    {
+      typedef typename LevelSets::size_type size_type;
+      const size_type n = A.N();
+      const size_type lastRow = n - 1;
+
+      // level of row i in L is one more than the highest level of the rows it depends on
+      std::vector< size_type > level( n, 0 );
+      size_type nLevels = 0;
+      for (auto i=A.begin(); i!=A.end(); ++i)
+      {
+        size_type l = 0;
+        for (auto j=(*i).begin(); j.index()<i.index(); ++j)
+          l = std::max( l, level[ j.index() ]+1 );
+        level[ i.index() ] = l;
+        nLevels = std::max( nLevels, l+1 );
+      }
+      lowerLevels.build( level, nLevels, minLevelSize );
+
+      // same for U, which is eliminated from the last row upwards
+      nLevels = 0;
+      for (auto i=A.beforeEnd(); i!=A.beforeBegin(); --i)
+      {
+        size_type l = 0;
+        for (auto j=(*i).beforeEnd(); j.index()>i.index(); --j)
+          l = std::max( l, level[ lastRow - j.index() ]+1 );
+        level[ lastRow - i.index() ] = l;
+        nLevels = std::max( nLevels, l+1 );
+      }
+      upperLevels.build( level, nLevels, minLevelSize );
+    }
+
+    //! compute the level sets of the factors of an ILU decomposition stored in CRS format (see convertToCRS)
+    template<class CRS>
+    void computeLevelSets (const CRS& lower, const CRS& upper, LevelSets& lowerLevels, LevelSets& upperLevels,
+                           const typename LevelSets::size_type minLevelSize = 512)
+    {
+      typedef typename LevelSets::size_type size_type;
+      const size_type n = lower.rows();
+      const size_type lastRow = n - 1;
+      if( n != upper.rows() )
+      {
+        DUNE_THROW(ISTLError,"ILU::computeLevelSets: lower and upper rows must be the same");
+      }
+
+      std::vector< size_type > level( n, 0 );
+      size_type nLevels = 0;
+      for( size_type i=0; i<n; ++i )
+      {
+        size_type l = 0;
+        for( size_type col = lower.rows_[ i ]; col < lower.rows_[ i+1 ]; ++col )
+          l = std::max( l, level[ lower.cols_[ col ] ]+1 );
+        level[ i ] = l;
+        nLevels = std::max( nLevels, l+1 );
+      }
+      lowerLevels.build( level, nLevels, minLevelSize );
+
+      nLevels = 0;
+      for( size_type i=0; i<n; ++i )
+      {
+        size_type l = 0;
+        for( size_type col = upper.rows_[ i ]; col < upper.rows_[ i+1 ]; ++col )
+          l = std::max( l, level[ lastRow - upper.cols_[ col ] ]+1 );
+        level[ i ] = l;
+        nLevels = std::max( nLevels, l+1 );
+      }
+      upperLevels.build( level, nLevels, minLevelSize );
+    }
+
+    /** \brief set up the pattern of ILU factors stored in CRS format
+
+        The CRS structure has to be set up by convertToCRS. Thus a resorted
+        decomposition needs no further copy of its pattern.
+
+        \param lower The strictly lower triangular factor.
+        \param upper The strictly upper triangular factor in reverse order.
+        \param ILU An empty matrix in row_wise creation mode, its values are unspecified afterwards.
+     */
+    template<class CRS, class M>
+    void setupPattern (const CRS& lower, const CRS& upper, M& ILU)
+    {
+      typedef typename CRS::size_type size_type;
+      const size_type lastRow = lower.rows()-1;
+      for( auto ci = ILU.createbegin(); ci != ILU.createend(); ++ci )
+      {
+        const size_type i = ci.index();
+        for( size_type k = lower.rows_[ i ]; k < lower.rows_[ i+1 ]; ++k )
+          ci.insert( lower.cols_[ k ] );
+        ci.insert( i );
+        for( size_type k = upper.rows_[ lastRow-i ]; k < upper.rows_[ lastRow-i+1 ]; ++k )
+          ci.insert( upper.cols_[ k ] );
+      }
+    }
+
+    /** \brief The symbolic phase of an ILU(n) decomposition.
+
+        The level sets of the factors, which SeqILU computes once from the
+        pattern of the factors. The pattern itself is not copied, it is
+        referenced from the storage of the factors, i.e. the BCRSMatrix or
+        the CRS structure of a resorted decomposition.
+     */
+    struct SymbolicILU
+    {
+      //! \brief level sets of the factors
+      LevelSets lowerLevels_;
+      LevelSets upperLevels_;
+
+      //! \brief no level sets, the triangular solves are sequential
+      SymbolicILU () = default;
+
+      //! \brief compute the level sets of the factors stored in the BCRSMatrix ILU
+      template<class M>
+      explicit SymbolicILU (const M& ILU)
+      {
+        computeLevelSets( ILU, lowerLevels_, upperLevels_ );
+      }
+
+      //! \brief compute the level sets of the factors stored in CRS format
+      template<class CRS>
+      SymbolicILU (const CRS& lower, const CRS& upper)
+      {
+        computeLevelSets( lower, upper, lowerLevels_, upperLevels_ );
+      }
+    };
+
+    //! LU backsolve with stored inverse, rows of each level are processed concurrently
+    template<class M, class X, class Y>
+    void bilu_backsolve (const M& A,
+                         const LevelSets& lowerLevels,
+                         const LevelSets& upperLevels,
+                         X& v, const Y& d)
+    {
+      typedef typename Y::block_type dblock;
+      typedef typename X::block_type vblock;
+      typedef typename LevelSets::size_type size_type;
+
+      const size_type lastRow = A.N() - 1;
+
+      // lower triangular solve
+      lowerLevels.forEachRow( [&]( const size_type i )
+      {
+        const auto& row = A[ i ];
+        dblock rhsValue(d[i]);
+        auto&& rhs = Impl::asVector(rhsValue);
+        for (auto j=row.begin(); j.index()<i; ++j)
+          Impl::asMatrix(*j).mmv(Impl::asVector(v[j.index()]),rhs);
+        Impl::asVector(v[i]) = rhs;           // Lii = I
+      } );
+
+      // upper triangular solve
+      upperLevels.forEachRow( [&]( const size_type k )
+      {
+        const size_type i = lastRow - k;
+        const auto& row = A[ i ];
+        vblock rhsValue(v[i]);
+        auto&& rhs = Impl::asVector(rhsValue);
+        auto j = row.beforeEnd();
+        for (; j.index()>i; --j)
+          Impl::asMatrix(*j).mmv(Impl::asVector(v[j.index()]),rhs);
+        auto&& vi = Impl::asVector(v[i]);
+        Impl::asMatrix(*j).mv(rhs,vi);           // diagonal stores inverse!
+      } );
+    }
+
+    //! LU backsolve with stored inverse in CRS format, rows of each level are processed concurrently
+    template<class CRS, class InvVector, class X, class Y>
+    void bilu_backsolve (const CRS& lower,
+                         const CRS& upper,
+                         const InvVector& inv,
+                         const LevelSets& lowerLevels,
+                         const LevelSets& upperLevels,
+                         X& v, const Y& d)
+    {
+      typedef typename Y :: block_type  dblock;
+      typedef typename X :: block_type  vblock;
+      typedef typename LevelSets::size_type size_type;
+
+      const size_type lastRow = lower.rows() - 1;
+
+      // lower triangular solve
+      lowerLevels.forEachRow( [&]( const size_type i )
+      {
+        dblock rhsValue( d[ i ] );
+        auto&& rhs = Impl::asVector(rhsValue);
+        for( size_type col = lower.rows_[ i ]; col < lower.rows_[ i+1 ]; ++ col )
+          Impl::asMatrix(lower.values_[ col ]).mmv( Impl::asVector(v[ lower.cols_[ col ] ] ), rhs );
+        Impl::asVector(v[ i ]) = rhs;  // Lii = I
+      } );
+
+      // upper triangular solve
+      upperLevels.forEachRow( [&]( const size_type i )
+      {
+        auto&& vBlock = Impl::asVector(v[ lastRow - i ]);
+        vblock rhsValue ( v[ lastRow - i ] );
+        auto&& rhs = Impl::asVector(rhsValue);
+        for( size_type col = upper.rows_[ i ]; col < upper.rows_[ i+1 ]; ++ col )
+          Impl::asMatrix(upper.values_[ col ]).mmv( Impl::asVector(v[ upper.cols_[ col ] ]), rhs );
+
+        // apply inverse and store result
+        Impl::asMatrix(inv[ i ]).mv(rhs, vBlock);
+      } );
+    }
+
+    /** \brief compute the ILU decomposition of A by fixed-point sweeps (Chow & Patel)
+
+        The entries of the factors are the solution of the nonlinear equations
+        \f$ (LU)_{ij} = A_{ij} \f$ on the pattern of ILU. Each sweep updates
+        all entries from the values of the previous sweep, i.e. all rows are
+        computed concurrently. The sweeps start from L = strict lower part of A
+        times the inverse of its diagonal and U = upper part of A.
+
+        On input the matrix ILU has to contain the sparsity pattern of the
+        decomposition, including the pattern of A (e.g. a copy of A for
+        ILU(0), or the result of bilu_pattern for ILU(n)). Its values are
+        overwritten. The result is stored as by bilu0_decomposition, i.e.,
+        the diagonal stores the inverse of the diagonal of U.
+
+        \param A matrix to decompose
+        \param ILU on entry the pattern, on exit the decomposition
+        \param sweeps number of fixed-point sweeps
+     */
+    template<class M>
+    void bilu_iterative_decomposition (const M& A, M& ILU, int sweeps)
+    {
+      typedef typename M::size_type size_type;
+      typedef typename M::block_type block;
+
+      const size_type n = ILU.N();
+      std::atomic<size_type> failedRow( n );
+
+      // position of the first entry of each row in the value arrays
+      std::vector< size_type > rowStart( n+1, 0 );
+      for( auto i = ILU.begin(); i != ILU.end(); ++i )
+        rowStart[ i.index()+1 ] = rowStart[ i.index() ] + i->size();
+
+      // invert the diagonal blocks of U, which is stored in ILU
+      std::vector< block > invDiag( n );
+      auto invertDiagonal = [ & ]( const size_type i )
+      {
+        auto ii = ILU[ i ].find( i );
+        if( ii == ILU[ i ].end() )
+        {
+          failedRow = i;
+          return;
+        }
+        invDiag[ i ] = *ii;
+        try {
+          Impl::asMatrix( invDiag[ i ] ).invert();
+        }
+        catch( Dune::FMatrixError & ) {
+          failedRow = i;
+        }
+      };
+      auto checkFailure = [ & ]()
+      {
+        // exceptions may not leave the threaded loops, report the failure here
+        const size_type i = failedRow;
+        if( i == n )
+          return;
+        if( ILU[ i ].find( i ) == ILU[ i ].end() )
+          DUNE_THROW(ISTLError,"diagonal entry missing");
+        DUNE_THROW(MatrixBlockError, "ILU failed to invert matrix block A["
+                   << i << "][" << i << "]";
+                   th__ex.r=i; th__ex.c=i;);
+      };
+
+      // entries of A on the pattern of ILU
+      std::vector< block > a( rowStart[ n ] );
+      Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+      {
+        auto Aij = A[ i ].begin();
+        const auto endAij = A[ i ].end();
+        for( auto ij = ILU[ i ].begin(); ij != ILU[ i ].end(); ++ij )
+        {
+          while( Aij != endAij && Aij.index() < ij.index() )
+            ++Aij;
+          block& value = a[ rowStart[ i ] + ij.offset() ];
+          if( Aij != endAij && Aij.index() == ij.index() )
+            value = *Aij;
+          else
+            value = 0;
+          *ij = value;
+        }
+      } );
+
+      // initial guess L_ij = A_ij A_jj^-1, U_ij = A_ij
+      Impl::parallelFor( size_type( 0 ), n, invertDiagonal );
+      checkFailure();
+      Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+      {
+        for( auto ij = ILU[ i ].begin(); ij.index() < i; ++ij )
+          Impl::asMatrix( *ij ).rightmultiply( Impl::asMatrix( invDiag[ ij.index() ] ) );
+      } );
+
+      std::vector< block > old( rowStart[ n ] );
+      for( int sweep = 0; sweep < sweeps; ++sweep )
+      {
+        Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+        {
+          for( auto ij = ILU[ i ].begin(); ij != ILU[ i ].end(); ++ij )
+            old[ rowStart[ i ] + ij.offset() ] = *ij;
+        } );
+
+        Impl::parallelFor( size_type( 0 ), n, invertDiagonal );
+        checkFailure();
+
+        Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+        {
+          auto&& row = ILU[ i ];
+          const auto endij = row.end();
+          for( auto ij = row.begin(); ij != endij; ++ij )
+            *ij = a[ rowStart[ i ] + ij.offset() ];
+
+          // A_ij - sum_{k < min(i,j)} L_ik U_kj
+          for( auto ik = row.begin(); ik.index() < i; ++ik )
+          {
+            const size_type k = ik.index();
+            const block& Lik = old[ rowStart[ i ] + ik.offset() ];
+            const auto& rowk = ILU[ k ];
+            const auto endkj = rowk.end();
+            auto kj = rowk.find( k );
+            auto ij = ik;
+            ++kj; ++ij;
+            while( ij != endij && kj != endkj )
+            {
+              if( ij.index() == kj.index() )
+              {
+                block B( old[ rowStart[ k ] + kj.offset() ] );
+                Impl::asMatrix( B ).leftmultiply( Impl::asMatrix( Lik ) );
+                *ij -= B;
+                ++ij; ++kj;
+              }
+              else if( ij.index() < kj.index() )
+                ++ij;
+              else
+                ++kj;
+            }
+          }
+
+          // L_ij = ( A_ij - sum_{k < j} L_ik U_kj ) U_jj^-1
+          for( auto ij = row.begin(); ij.index() < i; ++ij )
+            Impl::asMatrix( *ij ).rightmultiply( Impl::asMatrix( invDiag[ ij.index() ] ) );
+        } );
+      }
+
+      // store the inverse of the diagonal of U
+      Impl::parallelFor( size_type( 0 ), n, invertDiagonal );
+      checkFailure();
+      Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+      {
+        *ILU[ i ].find( i ) = invDiag[ i ];
+      } );
+    }
+
+    /** \brief approximate LU backsolve by Jacobi iterations
+
+        The triangular systems are solved approximately by a fixed number of
+        Jacobi iterations, starting from \f$ y = d \f$ and
+        \f$ v = U_{ii}^{-1} y \f$, respectively. All rows of an iteration
+        are processed concurrently. As the strictly triangular parts are
+        nilpotent, the result is exact after N iterations.
+
+        \param A decomposition as computed by bilu0_decomposition (diagonal stores inverse)
+        \param sweeps number of Jacobi iterations for each triangular solve
+        \param v solution
+        \param d right hand side
+        \param old scratch vector for the previous iterate
+        \param y scratch vector for the result of the lower triangular solve
+     */
+    template<class M, class X, class Y>
+    void bilu_jacobi_backsolve (const M& A, int sweeps, X& v, const Y& d, X& old, X& y)
+    {
+      typedef typename M::size_type size_type;
+      typedef typename Y::block_type dblock;
+      typedef typename X::block_type vblock;
+
+      const size_type n = A.N();
+
+      // lower triangular solve, y = d - L y
+      Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+      {
+        dblock rhsValue( d[ i ] );
+        Impl::asVector( v[ i ] ) = Impl::asVector( rhsValue );
+      } );
+      for( int sweep = 0; sweep < sweeps; ++sweep )
+      {
+        old = v;
+        Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+        {
+          dblock rhsValue( d[ i ] );
+          auto&& rhs = Impl::asVector( rhsValue );
+          for( auto j = A[ i ].begin(); j.index() < i; ++j )
+            Impl::asMatrix( *j ).mmv( Impl::asVector( old[ j.index() ] ), rhs );
+          Impl::asVector( v[ i ] ) = rhs;           // Lii = I
+        } );
+      }
+
+      // upper triangular solve, v = U_ii^-1 ( y - U v )
+      y = v;
+      for( int sweep = 0; sweep <= sweeps; ++sweep )
+      {
+        old = v;
+        Impl::parallelFor( size_type( 0 ), n, [ & ]( const size_type i )
+        {
+          vblock rhsValue( y[ i ] );
+          auto&& rhs = Impl::asVector( rhsValue );
+          const auto ii = A[ i ].find( i );
+          if( sweep > 0 )
+          {
+            auto j = ii;
+            for( ++j; j != A[ i ].end(); ++j )
+              Impl::asMatrix( *j ).mmv( Impl::asVector( old[ j.index() ] ), rhs );
+          }
+          auto&& vi = Impl::asVector( v[ i ] );
+          Impl::asMatrix( *ii ).mv( rhs, vi );           // diagonal stores inverse!
+        } );
+      }
+    }
+
   } // end namespace ILU
 
 
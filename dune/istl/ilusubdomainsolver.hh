@@ -4,6 +4,8 @@
 #define DUNE_ISTL_ILUSUBDOMAINSOLVER_HH
 
 #include <map>
+#include <dune/common/ftraits.hh>
+#include <dune/common/simd/simd.hh>
 #include <dune/common/typetraits.hh>
 #include "matrix.hh"
 #include <cmath>
@@ -141,6 +143,68 @@ namespace Dune {
     rilu_type RILU;
   };
 
+  /**
+   * @brief Subdomain solver using ILUT(p,tau).
+   *
+   * The local matrix is decomposed with bilut_decomposition.
+   * @tparam M The type of the matrix.
+   * @tparam X The type of the vector for the domain.
+   * @tparam X The type of the vector for the range.
+   */
+  template<class M, class X, class Y>
+  class ILUTSubdomainSolver
+    : public ILUSubdomainSolver<M,X,Y>{
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    typedef typename std::remove_const<M>::type rilu_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The real type of the drop tolerance.
+    typedef typename FieldTraits<Simd::Scalar<typename M::field_type> >::real_type real_type;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param fill The maximal number of entries left and right of the diagonal in each row.
+     * @param threshold The drop tolerance relative to the norm of the row.
+     */
+    ILUTSubdomainSolver(int fill=10, real_type threshold=1e-4)
+      : fill_(fill), threshold_(threshold)
+    {}
+
+    /**
+     * @brief Apply the subdomain solver.
+     * @copydoc ILUSubdomainSolver::apply
+     */
+    void apply (X& v, const Y& d)
+    {
+      bilu_backsolve(RILU,v,d);
+    }
+
+    /**
+     * @brief Set the data of the local problem.
+     *
+     * @param A The global matrix.
+     * @param rowset The global indices of the local problem.
+     * @tparam S The type of the set with the indices.
+     */
+    template<class S>
+    void setSubMatrix(const M& A, S& rowset);
+
+  private:
+    /**
+     * @brief Storage for the ILUT decomposition.
+     */
+    rilu_type RILU;
+    //! \brief The maximal number of entries left and right of the diagonal.
+    int fill_;
+    //! \brief The drop tolerance.
+    real_type threshold_;
+  };
+
 
 
   template<class M, class X, class Y>
@@ -231,6 +295,16 @@ namespace Dune {
     bilu_decomposition(this->ILU, (offset+1)/2, RILU);
   }
 
+  template<class M, class X, class Y>
+  template<class S>
+  void ILUTSubdomainSolver<M,X,Y>::setSubMatrix(const M& A, S& rowSet)
+  {
+    this->copyToLocalMatrix(A,rowSet);
+    RILU.setSize(rowSet.size(),rowSet.size());
+    RILU.setBuildMode(matrix_type::row_wise);
+    bilut_decomposition(this->ILU, fill_, threshold_, RILU);
+  }
+
   /** @} */
 } // end name space DUNE
 
@@ -4,6 +4,7 @@
 #define DUNE_ISTL_ISTLEXCEPTION_HH
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
 
 namespace Dune {
 
@@ -51,6 +52,12 @@ namespace Dune {
    */
   class SolverAbort : public ISTLError {};
 
+  //! Error when performing an operation on a matrix block.
+  class MatrixBlockError : public virtual Dune::FMatrixError {
+  public:
+    int r, c; // row and column index of the entry from which the error resulted
+  };
+
   /** @} end documentation */
 
 } // end namespace
@@ -0,0 +1,376 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_MIXEDPRECISION_HH
+#define DUNE_ISTL_MIXEDPRECISION_HH
+
+#include <complex>
+#include <functional>
+#include <memory>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/paamg/amg.hh>
+
+#include "bcrsmatrix.hh"
+#include "bvector.hh"
+#include "istlexception.hh"
+#include "operators.hh"
+#include "preconditioner.hh"
+#include "preconditioners.hh"
+#include "solvercategory.hh"
+#include "solverfactory.hh"
+#include "solvers.hh"
+
+/** \file
+ * \brief Iterative refinement with an inner solver in lower precision.
+ */
+
+namespace Dune {
+
+  namespace Impl {
+
+    /**
+     * \brief The type T with its field type replaced by K.
+     *
+     * Defined for scalars, FieldVector, FieldMatrix, BlockVector and BCRSMatrix.
+     */
+    template<class T, class K>
+    struct LowerPrecisionType
+    {
+      static_assert(IsNumber<T>::value, "LowerPrecisionType is only defined for numbers, FieldVector, FieldMatrix, BlockVector and BCRSMatrix");
+      using type = K;
+    };
+
+    template<class T, class K>
+    struct LowerPrecisionType<std::complex<T>,K>
+    {
+      using type = std::complex<K>;
+    };
+
+    template<class T, int n, class K>
+    struct LowerPrecisionType<FieldVector<T,n>,K>
+    {
+      using type = FieldVector<typename LowerPrecisionType<T,K>::type,n>;
+    };
+
+    template<class T, int n, int m, class K>
+    struct LowerPrecisionType<FieldMatrix<T,n,m>,K>
+    {
+      using type = FieldMatrix<typename LowerPrecisionType<T,K>::type,n,m>;
+    };
+
+    template<class B, class A, class K>
+    struct LowerPrecisionType<BlockVector<B,A>,K>
+    {
+      using block_type = typename LowerPrecisionType<B,K>::type;
+      using type = BlockVector<block_type, typename std::allocator_traits<A>::template rebind_alloc<block_type>>;
+    };
+
+    template<class B, class A, class K>
+    struct LowerPrecisionType<BCRSMatrix<B,A>,K>
+    {
+      using block_type = typename LowerPrecisionType<B,K>::type;
+      using type = BCRSMatrix<block_type, typename std::allocator_traits<A>::template rebind_alloc<block_type>>;
+    };
+
+    //! copy the entries of a dense block or a vector multiplied by factor to a vector of other precision
+    template<class S, class T, class F>
+    void convertPrecision(const S& src, T& dst, const F& factor)
+    {
+      if constexpr (IsNumber<S>::value)
+        dst = T(src*factor);
+      else
+        for (std::size_t i=0; i<src.N(); ++i)
+          convertPrecision(src[i], dst[i], factor);
+    }
+
+    //! copy the entries of a matrix to a matrix of other precision with the same sparsity pattern
+    template<class B, class A, class LB, class LA>
+    void convertPrecision(const BCRSMatrix<B,A>& src, BCRSMatrix<LB,LA>& dst)
+    {
+      auto drow = dst.begin();
+      for (auto row = src.begin(); row != src.end(); ++row, ++drow)
+      {
+        auto dcol = drow->begin();
+        for (auto col = row->begin(); col != row->end(); ++col, ++dcol)
+          convertPrecision(*col, *dcol, 1.0);
+      }
+    }
+
+  } // end namespace Impl
+
+  /** @addtogroup ISTL_Prec
+          @{
+   */
+
+  /**
+   * \brief Preconditioner solving the defect equation in lower precision.
+   *
+   * The matrix is copied once to a matrix with field type K, usually float,
+   * and an inner solver with its own preconditioner, e.g. an AMG or ILU, is
+   * set up for this copy. Each application converts the defect to K, solves
+   * with the inner solver and converts the correction back. Since all the
+   * work of the inner solver is done in K, the memory traffic is halved
+   * compared to the same solver in double precision.
+   *
+   * The defect is scaled by its maximum norm before the conversion, so small
+   * defects late in a refinement loop do not underflow in K.
+   *
+   * \tparam M The matrix type, a BCRSMatrix with FieldMatrix or scalar blocks.
+   * \tparam X Type of the update
+   * \tparam Y Type of the defect
+   * \tparam K The field type of the inner solver.
+   */
+  template<class M, class X, class Y, class K = float>
+  class MixedPrecisionPreconditioner : public Preconditioner<X,Y>
+  {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef M matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+
+    //! \brief The matrix type of the inner solver.
+    typedef typename Impl::LowerPrecisionType<M,K>::type lower_matrix_type;
+    //! \brief The domain type of the inner solver.
+    typedef typename Impl::LowerPrecisionType<X,K>::type lower_domain_type;
+    //! \brief The range type of the inner solver.
+    typedef typename Impl::LowerPrecisionType<Y,K>::type lower_range_type;
+    //! \brief The operator of the inner solver.
+    typedef MatrixAdapter<lower_matrix_type,lower_domain_type,lower_range_type> lower_operator_type;
+    //! \brief The inner solver.
+    typedef InverseOperator<lower_domain_type,lower_range_type> lower_solver_type;
+    //! \brief Function setting up the inner solver for the operator in lower precision.
+    typedef std::function<std::shared_ptr<lower_solver_type>(const std::shared_ptr<lower_operator_type>&)> LowerSolverCreator;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param creator Sets up the inner solver for the matrix copy in lower precision.
+     */
+    MixedPrecisionPreconditioner (const M& A, const LowerSolverCreator& creator)
+      : A_(A),
+        creator_(creator),
+        lowerMatrix_(copyMatrix(A)),
+        lowerOperator_(std::make_shared<lower_operator_type>(lowerMatrix_)),
+        solver_(creator_(lowerOperator_)),
+        v_(A.M()),
+        d_(A.N())
+    {}
+
+    /*! \brief Constructor.
+
+       The inner solver is taken from the solver factory for the operator in
+       lower precision, see \ref ISTL_Factory.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing the configuration of the inner solver.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       type              | The inner solver, e.g. cgsolver or loopsolver.
+       reduction         | The relative defect reduction of the inner solver
+       maxit             | The maximum number of iterations of the inner solver
+       verbose           | The verbosity level of the inner solver
+       preconditioner    | Subtree with the preconditioner of the inner solver, e.g. amg or ilu.
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    MixedPrecisionPreconditioner (const M& A, const ParameterTree& configuration)
+      : MixedPrecisionPreconditioner(A, [configuration](const std::shared_ptr<lower_operator_type>& op){
+            initSolverFactories<lower_operator_type>();
+            return getSolverFromFactory(op, configuration);
+          })
+    {}
+
+    /*! \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing the configuration of the inner solver.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       type              | The inner solver, e.g. cgsolver or loopsolver.
+       reduction         | The relative defect reduction of the inner solver
+       maxit             | The maximum number of iterations of the inner solver
+       verbose           | The verbosity level of the inner solver
+       preconditioner    | Subtree with the preconditioner of the inner solver, e.g. amg or ilu.
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    MixedPrecisionPreconditioner (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : MixedPrecisionPreconditioner(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X&, Y&)
+    {}
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      auto scale = d.infinity_norm();
+      if (scale == 0)
+      {
+        v = 0;
+        return;
+      }
+      Impl::convertPrecision(d, d_, 1.0/scale);
+      v_ = 0;
+      InverseOperatorResult res;
+      solver_->apply(v_, d_, res);
+      Impl::convertPrecision(v_, v, scale);
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X&)
+    {}
+
+    /*!
+       \brief Update the preconditioner.
+
+       Converts the entries of the matrix to the copy in lower precision
+       again and sets up a new inner solver for it. The sparsity pattern of
+       the matrix has to be unchanged.
+     */
+    virtual void update ()
+    {
+      Impl::convertPrecision(A_, *lowerMatrix_);
+      solver_ = creator_(lowerOperator_);
+    }
+
+    //! The operator of the inner solver working on the matrix copy.
+    std::shared_ptr<lower_operator_type> lowerPrecisionOperator () const
+    {
+      return lowerOperator_;
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  private:
+    static std::shared_ptr<lower_matrix_type> copyMatrix (const M& A)
+    {
+      auto lowerMatrix = std::make_shared<lower_matrix_type>(A.N(), A.M(), A.nonzeroes(), lower_matrix_type::row_wise);
+      for (auto row = lowerMatrix->createbegin(); row != lowerMatrix->createend(); ++row)
+        for (auto j = A[row.index()].begin(); j != A[row.index()].end(); ++j)
+          row.insert(j.index());
+      Impl::convertPrecision(A, *lowerMatrix);
+      return lowerMatrix;
+    }
+
+    const M& A_;
+    LowerSolverCreator creator_;
+    std::shared_ptr<lower_matrix_type> lowerMatrix_;
+    std::shared_ptr<lower_operator_type> lowerOperator_;
+    std::shared_ptr<lower_solver_type> solver_;
+    lower_domain_type v_;
+    lower_range_type d_;
+  };
+
+  /** @} end documentation */
+
+  /** @addtogroup ISTL_Solvers
+          @{
+   */
+
+  /**
+   * \brief Mixed precision iterative refinement.
+   *
+   * The outer loop computes the defect \f$d = b - Ax\f$ in the precision of
+   * the given matrix, usually double, and corrects the iterate by an
+   * approximate solution of \f$Av = d\f$ in lower precision, see
+   * MixedPrecisionPreconditioner. The float copies of the matrix and of the
+   * vectors are built automatically. As long as the inner solver reduces the
+   * defect, i.e. the condition of A is well below the inverse of the machine
+   * epsilon of K, the iterate converges to the accuracy of the outer precision
+   * while the bulk of the work is done in K.
+   *
+   * Only sequential operators are supported.
+   *
+   * \tparam M The matrix type, a BCRSMatrix with FieldMatrix or scalar blocks.
+   * \tparam X The vector type.
+   * \tparam K The field type of the inner solver.
+   */
+  template<class M, class X, class K = float>
+  class MixedPrecisionSolver : public LoopSolver<X>
+  {
+  public:
+    using typename LoopSolver<X>::domain_type;
+    using typename LoopSolver<X>::range_type;
+    using typename LoopSolver<X>::field_type;
+    using typename LoopSolver<X>::real_type;
+    using typename LoopSolver<X>::scalar_real_type;
+
+    //! \brief The preconditioner solving in lower precision.
+    typedef MixedPrecisionPreconditioner<M,X,X,K> lower_preconditioner_type;
+    //! \brief Function setting up the inner solver for the operator in lower precision.
+    typedef typename lower_preconditioner_type::LowerSolverCreator LowerSolverCreator;
+
+    /*!
+       \brief Set up the refinement loop.
+
+       \param A The matrix in the outer precision. It has to live as long as the solver.
+       \param creator Sets up the inner solver for the matrix copy in lower precision.
+       \param reduction The relative defect reduction to achieve in the outer precision.
+       \param maxit The maximum number of refinement steps.
+       \param verbose The verbosity level.
+     */
+    MixedPrecisionSolver (const M& A, const LowerSolverCreator& creator,
+                          scalar_real_type reduction, int maxit, int verbose)
+      : LoopSolver<X>(std::make_shared<MatrixAdapter<M,X,X>>(A),
+                      std::make_shared<SeqScalarProduct<X>>(),
+                      std::make_shared<lower_preconditioner_type>(A, creator),
+                      reduction, maxit, verbose)
+    {}
+
+    /*!
+       \brief Set up the refinement loop.
+
+       \param A The matrix in the outer precision. It has to live as long as the solver.
+       \param configuration ParameterTree containing the solver parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       reduction         | The relative defect reduction to achieve in the outer precision
+       maxit             | The maximum number of refinement steps
+       verbose           | The verbosity level
+       inner             | Subtree with the inner solver and its preconditioner, see MixedPrecisionPreconditioner.
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    MixedPrecisionSolver (const M& A, const ParameterTree& configuration)
+      : LoopSolver<X>(std::make_shared<MatrixAdapter<M,X,X>>(A),
+                      std::make_shared<SeqScalarProduct<X>>(),
+                      std::make_shared<lower_preconditioner_type>(A, configuration.sub("inner")),
+                      configuration)
+    {}
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_ISTL_MIXEDPRECISION_HH
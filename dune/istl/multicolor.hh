@@ -0,0 +1,306 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_MULTICOLOR_HH
+#define DUNE_ISTL_MULTICOLOR_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/scalarmatrixview.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/common/threading.hh>
+
+#include "ilu.hh"
+#include "istlexception.hh"
+
+/** \file
+ * \brief Multi-color variants of the Gauss-Seidel and ILU(0) kernels.
+ *
+ * The rows of the matrix are colored such that two rows of the same
+ * color are not coupled. All rows of a color can then be processed
+ * concurrently, the colors are processed one after another.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  /**
+   * \brief Coloring of the rows of a sparse matrix.
+   *
+   * Two rows i and j get different colors if A_ij or A_ji is stored.
+   * The coloring only depends on the sparsity pattern of the matrix.
+   */
+  struct MatrixColoring
+  {
+    typedef std::size_t size_type;
+
+    //! number of colors
+    size_type colors() const { return classes_.levels(); }
+
+    //! true if no coloring has been computed
+    bool empty() const { return classes_.empty(); }
+
+    //! color of each row
+    std::vector<size_type> color_;
+    //! rows grouped by color
+    ILU::LevelSets classes_;
+  };
+
+  /**
+   * \brief Compute a greedy coloring of the symmetrized pattern of A.
+   *
+   * The rows are visited in their natural order and each row gets the
+   * smallest color not used by one of its neighbors.
+   */
+  template<class M>
+  void computeColoring (const M& A, MatrixColoring& coloring)
+  {
+    typedef MatrixColoring::size_type size_type;
+    const size_type n = A.N();
+
+    // rows j < c with A_jc != 0, i.e. the upper triangle transposed
+    std::vector<size_type> transposedStart(n+1, 0);
+    for (auto i=A.begin(); i!=A.end(); ++i)
+      for (auto j=i->begin(); j!=i->end(); ++j)
+        if (j.index()>i.index())
+          ++transposedStart[j.index()+1];
+    for (size_type i=0; i<n; ++i)
+      transposedStart[i+1] += transposedStart[i];
+
+    std::vector<size_type> transposed(transposedStart[n]);
+    std::vector<size_type> next(transposedStart.begin(), transposedStart.end()-1);
+    for (auto i=A.begin(); i!=A.end(); ++i)
+      for (auto j=i->begin(); j!=i->end(); ++j)
+        if (j.index()>i.index())
+          transposed[next[j.index()]++] = i.index();
+
+    // mark[c] == i+1 if color c is used by a neighbor of row i
+    std::vector<size_type> mark;
+    std::vector<size_type>& color = coloring.color_;
+    color.assign(n, 0);
+    size_type nColors = 0;
+    for (auto i=A.begin(); i!=A.end(); ++i)
+    {
+      const size_type row = i.index();
+      for (auto j=i->begin(); j!=i->end() && j.index()<row; ++j)
+        mark[color[j.index()]] = row+1;
+      for (size_type k=transposedStart[row]; k<transposedStart[row+1]; ++k)
+        mark[color[transposed[k]]] = row+1;
+
+      size_type c = 0;
+      while (c<nColors && mark[c]==row+1)
+        ++c;
+      if (c==nColors)
+      {
+        ++nColors;
+        mark.push_back(0);
+      }
+      color[row] = c;
+    }
+
+    coloring.classes_.build(color, nColors, 1);
+  }
+
+  namespace Impl {
+
+    //! relaxed Gauss-Seidel update of a single row, x_i += w D_i^{-1} (b - Ax)_i
+    template<class M, class X, class Y, class K>
+    void bmcsorRow (const M& A, typename M::size_type row, X& x, const Y& b, const K& w)
+    {
+      typedef typename Y::block_type bblock;
+      typedef typename X::block_type xblock;
+
+      bblock rhsValue(b[row]);
+      auto&& rhs = Impl::asVector(rhsValue);
+      auto diag = A[row].end();
+      for (auto j=A[row].begin(); j!=A[row].end(); ++j)
+      {
+        if (j.index()==row)
+          diag = j;
+        Impl::asMatrix(*j).mmv(Impl::asVector(x[j.index()]),rhs);
+      }
+
+      if constexpr (IsNumber<typename M::block_type>())
+        x[row] += w * (rhsValue / (*diag));
+      else
+      {
+        xblock v(x[row]);
+        diag->solve(v,rhsValue);
+        x[row].axpy(w,v);
+      }
+    }
+
+  } // end namespace Impl
+
+  /**
+   * \brief Multi-color SOR step, the colors are processed in ascending order.
+   *
+   * The rows of one color are updated concurrently. The diagonal blocks
+   * are inverted directly, i.e. this corresponds to bsorf with BL<1>
+   * applied to the matrix permuted by colors.
+   */
+  template<class M, class X, class Y, class K>
+  void bmcsorf (const M& A, const MatrixColoring& coloring, X& x, const Y& b, const K& w)
+  {
+    coloring.classes_.forEachRow([&](typename M::size_type row){
+        Impl::bmcsorRow(A,row,x,b,w);
+      });
+  }
+
+  //! Multi-color SOR step, the colors are processed in descending order.
+  template<class M, class X, class Y, class K>
+  void bmcsorb (const M& A, const MatrixColoring& coloring, X& x, const Y& b, const K& w)
+  {
+    coloring.classes_.forEachRowReverse([&](typename M::size_type row){
+        Impl::bmcsorRow(A,row,x,b,w);
+      });
+  }
+
+  /**
+   * \brief compute the ILU(0) decomposition of the color permuted matrix A.
+   *
+   * A is overwritten by its decomposition. The factor L consists of the
+   * entries A_ij with color(j) < color(i), U of the entries with
+   * color(j) > color(i) and the diagonal, which stores the inverse
+   * of U_ii. The rows of one color are factorized concurrently.
+   */
+  template<class M>
+  void bmcilu0_decomposition (M& A, const MatrixColoring& coloring)
+  {
+    typedef typename M::size_type size_type;
+    typedef typename M::ColIterator coliterator;
+    typedef typename M::block_type block;
+
+    const std::vector<std::size_t>& color = coloring.color_;
+    std::atomic<size_type> failedRow(A.N());
+
+    // the entries of L of the current row, one buffer per thread
+    std::vector<std::vector<std::pair<std::size_t,coliterator> > > scratch(Impl::threadCount());
+
+    for (size_type l=0; l<coloring.colors(); ++l)
+    {
+      coloring.classes_.forEachRowInLevel(l, [&](size_type i){
+          auto&& row = A[i];
+          const coliterator endij = row.end();
+
+          // entries of L in the order of elimination
+          auto& lower = scratch[Impl::threadIndex()];
+          lower.clear();
+          coliterator ii = endij;
+          for (coliterator ij=row.begin(); ij!=endij; ++ij)
+            if (ij.index()==i)
+              ii = ij;
+            else if (color[ij.index()]<color[i])
+              lower.emplace_back(color[ij.index()],ij);
+          std::sort(lower.begin(),lower.end(),
+                    [](const auto& a, const auto& b){ return a.first<b.first; });
+
+          if (ii==endij)
+          {
+            failedRow = i;
+            return;
+          }
+
+          for (const auto& entry : lower)
+          {
+            const coliterator ik = entry.second;
+            const size_type k = ik.index();
+            auto&& rowk = A[k];
+
+            // compute L_ik = A_ik * U_kk^-1
+            Impl::asMatrix(*ik).rightmultiply(Impl::asMatrix(*rowk.find(k)));
+
+            // A_ij -= L_ik U_kj for all j eliminated after k
+            coliterator ij = row.begin();
+            coliterator kj = rowk.begin();
+            const coliterator endkj = rowk.end();
+            while (ij!=endij && kj!=endkj)
+              if (ij.index()==kj.index())
+              {
+                if (color[kj.index()]>entry.first)
+                {
+                  block B(*kj);
+                  Impl::asMatrix(B).leftmultiply(Impl::asMatrix(*ik));
+                  *ij -= B;
+                }
+                ++ij; ++kj;
+              }
+              else
+              {
+                if (ij.index()<kj.index())
+                  ++ij;
+                else
+                  ++kj;
+              }
+          }
+
+          // invert pivot and store it in A
+          try {
+            Impl::asMatrix(*ii).invert();
+          }
+          catch (Dune::FMatrixError&) {
+            failedRow = i;
+          }
+        });
+
+      // exceptions may not leave the threaded loop, report the failure here
+      const size_type failed = failedRow;
+      if (failed!=A.N())
+      {
+        if (A[failed].find(failed)==A[failed].end())
+          DUNE_THROW(ISTLError,"diagonal entry missing");
+        DUNE_THROW(MatrixBlockError, "ILU failed to invert matrix block A["
+                   << failed << "][" << failed << "]";
+                   th__ex.r=failed; th__ex.c=failed;);
+      }
+    }
+  }
+
+  //! LU backsolve for the decomposition computed by bmcilu0_decomposition
+  template<class M, class X, class Y>
+  void bmcilu0_backsolve (const M& A, const MatrixColoring& coloring, X& v, const Y& d)
+  {
+    typedef typename M::size_type size_type;
+    typedef typename Y::block_type dblock;
+    typedef typename X::block_type vblock;
+
+    const std::vector<std::size_t>& color = coloring.color_;
+
+    // lower triangular solve
+    coloring.classes_.forEachRow([&](size_type i){
+        dblock rhsValue(d[i]);
+        auto&& rhs = Impl::asVector(rhsValue);
+        for (auto j=A[i].begin(); j!=A[i].end(); ++j)
+          if (color[j.index()]<color[i])
+            Impl::asMatrix(*j).mmv(Impl::asVector(v[j.index()]),rhs);
+        Impl::asVector(v[i]) = rhs;           // Lii = I
+      });
+
+    // upper triangular solve
+    coloring.classes_.forEachRowReverse([&](size_type i){
+        vblock rhsValue(v[i]);
+        auto&& rhs = Impl::asVector(rhsValue);
+        auto diag = A[i].end();
+        for (auto j=A[i].begin(); j!=A[i].end(); ++j)
+          if (j.index()==i)
+            diag = j;
+          else if (color[j.index()]>color[i])
+            Impl::asMatrix(*j).mmv(Impl::asVector(v[j.index()]),rhs);
+        auto&& vi = Impl::asVector(v[i]);
+        Impl::asMatrix(*diag).mv(rhs,vi);           // diagonal stores inverse!
+      });
+  }
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
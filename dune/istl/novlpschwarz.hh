@@ -356,6 +356,26 @@ namespace Dune {
       _preconditioner->post(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       \copydoc Preconditioner::update()
+     */
+    virtual void update ()
+    {
+      _preconditioner->update();
+    }
+
+    /*!
+       \brief Forward the progress of the outer iteration.
+
+       \copydoc Preconditioner::setOuterDefect(double,double)
+     */
+    virtual void setOuterDefect (double relativeDefect, double reduction)
+    {
+      _preconditioner->setOuterDefect(relativeDefect, reduction);
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
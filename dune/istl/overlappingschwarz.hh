@@ -512,6 +512,25 @@ namespace Dune
     {}
   };
 
+  // specialization for ILUT
+  template<class M, class X, class Y>
+  class OverlappingAssignerHelper<ILUTSubdomainSolver<M,X,Y>,false>
+    : public OverlappingAssignerILUBase<M,X,Y>
+  {
+  public:
+    /**
+     * @brief Constructor.
+     * @param maxlength The maximum entries over all subdomains.
+     * @param mat The global matrix.
+     * @param b the global right hand side.
+     * @param x the global left hand side.
+     */
+    OverlappingAssignerHelper(std::size_t maxlength, const M& mat,
+                        const Y& b, X& x)
+      : OverlappingAssignerILUBase<M,X,Y>(maxlength, mat,b,x)
+    {}
+  };
+
   template<typename S, typename T>
   struct AdditiveAdder
   {};
@@ -735,6 +754,11 @@ namespace Dune
     : public SeqOverlappingSchwarzAssemblerILUBase<M,X,Y>
   {};
 
+  template<class M,class X, class Y>
+  struct SeqOverlappingSchwarzAssemblerHelper<ILUTSubdomainSolver<M,X,Y>,false>
+    : public SeqOverlappingSchwarzAssemblerILUBase<M,X,Y>
+  {};
+
   /**
    * @brief Sequential overlapping Schwarz preconditioner
    *
@@ -866,6 +890,16 @@ namespace Dune
     template<bool forward>
     void apply(X& v, const X& d);
 
+    /*!
+       \brief Update the preconditioner.
+
+       Assembles the local problems of the subdomains again and sets up new
+       subdomain solvers for them, as the direct solvers cannot refactorize
+       in place. Only the subdomains are kept. If the decompositions are
+       computed on the fly there is nothing to do.
+     */
+    virtual void update ();
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -1230,6 +1264,32 @@ namespace Dune
   }
 
 
+  template<class M, class X, class TM, class TD, class TA>
+  void SeqOverlappingSchwarz<M,X,TM,TD,TA>::update()
+  {
+    if(onTheFly)
+      return;
+
+    typedef typename subdomain_vector::const_iterator DomainIterator;
+
+    // Recreate the row to subdomain mapping
+    rowtodomain_vector rowToDomain(mat.N());
+
+    size_type domainId=0;
+
+    for(DomainIterator domain=subDomains.begin(); domain != subDomains.end(); ++domain, ++domainId) {
+      typedef typename subdomain_type::const_iterator iterator;
+      for(iterator row=domain->begin(); row != domain->end(); ++row)
+        rowToDomain[*row].push_back(domainId);
+    }
+
+    // The direct solvers cannot refactorize in place, set up new ones
+    solvers.clear();
+    solvers.resize(subDomains.size());
+    maxlength = SeqOverlappingSchwarzAssembler<slu>
+                ::assembleLocalProblems(rowToDomain, mat, solvers, subDomains, onTheFly);
+  }
+
   template<class M, class X, class TM, class TD, class TA>
   void SeqOverlappingSchwarz<M,X,TM,TD,TA>::apply(X& x, const X& b)
   {
@@ -3,6 +3,7 @@
 #ifndef DUNE_ISTL_OWNEROVERLAPCOPY_HH
 #define DUNE_ISTL_OWNEROVERLAPCOPY_HH
 
+#include <functional>
 #include <new>
 #include <iostream>
 #include <vector>
@@ -30,6 +31,9 @@
 #include "solvercategory.hh"
 #include "istlexception.hh"
 #include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/future.hh>
+#include <dune/common/simd/simd.hh>
+#include <dune/istl/bvector.hh>
 #include <dune/istl/matrixmarket.hh>
 
 template<int dim, template<class,class> class Comm>
@@ -411,16 +415,7 @@ namespace Dune {
     void dot (const T1& x, const T1& y, T2& result) const
     {
       using real_type = typename FieldTraits<typename T1::field_type>::real_type;
-      // set up mask vector
-      if (mask.size()!=static_cast<typename std::vector<double>::size_type>(x.size()))
-      {
-        mask.resize(x.size());
-        for (typename std::vector<double>::size_type i=0; i<mask.size(); i++)
-          mask[i] = 1;
-        for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
-          if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
-            mask[i->local().local()] = 0;
-      }
+      setupMask(x.size());
       result = T2(0.0);
 
       for (typename T1::size_type i=0; i<x.size(); i++)
@@ -428,6 +423,62 @@ namespace Dune {
       result = cc.sum(result);
     }
 
+    /**
+     * @brief Start the computation of several global dot products.
+     *
+     * The local contributions of all products are summed in a single
+     * non-blocking reduction, which may be overlapped with other work until
+     * the result is requested from the returned future.
+     *
+     * @param x The first vectors of the products.
+     * @param y The second vectors of the products.
+     * @return A future providing the dot products of x[k] and y[k].
+     */
+    template<class T1, class T2>
+    Future<std::vector<T2> > idot (const std::vector<const T1*>& x, const std::vector<const T1*>& y) const
+    {
+      using real_type = typename FieldTraits<typename T1::field_type>::real_type;
+      std::vector<T2> result(x.size(), T2(0.0));
+      if (x.empty())
+        return PseudoFuture<std::vector<T2> >(std::move(result));
+
+      setupMask(x[0]->size());
+
+      // a single sweep over the vectors computes all local products
+      for (typename T1::size_type i=0; i<x[0]->size(); i++)
+        for (std::size_t k=0; k<x.size(); k++)
+          result[k] += ((*x[k])[i]*((*y[k])[i]))*static_cast<real_type>(mask[i]);
+      return cc.template iallreduce<std::plus<T2> >(std::move(result));
+    }
+
+    /**
+     * @brief Compute the global block dot product of two multi-vectors.
+     *
+     * The lanes of the SIMD field type are the columns of the multi-vectors,
+     * the local scalar products of all columns are summed in a single
+     * reduction.
+     *
+     * @param x The first multi-vector of the product.
+     * @param y The second multi-vector of the product.
+     * @return The matrix of the products, entry a*lanes+b is the product of
+     *         column a of x and column b of y.
+     */
+    template<class T1>
+    std::vector<Simd::Scalar<typename T1::field_type> > blockDot (const T1& x, const T1& y) const
+    {
+      using field_type = typename T1::field_type;
+      using real_type = typename FieldTraits<field_type>::real_type;
+      const std::size_t lanes = Simd::lanes<field_type>();
+
+      setupMask(x.size());
+      std::vector<Simd::Scalar<field_type> > result(lanes*lanes, 0);
+      for (typename T1::size_type i=0; i<x.size(); i++)
+        if (mask[i] != 0)
+          Imp::addLaneGram<field_type>(result, x[i], y[i], static_cast<Simd::Scalar<real_type> >(mask[i]));
+      cc.sum(result.data(), result.size());
+      return result;
+    }
+
     /**
      * @brief Compute the global Euclidean norm of a vector.
      *
@@ -439,16 +490,7 @@ namespace Dune {
     {
       using real_type = typename FieldTraits<typename T1::field_type>::real_type;
 
-      // set up mask vector
-      if (mask.size()!=static_cast<typename std::vector<double>::size_type>(x.size()))
-      {
-        mask.resize(x.size());
-        for (typename std::vector<double>::size_type i=0; i<mask.size(); i++)
-          mask[i] = 1;
-        for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
-          if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
-            mask[i->local().local()] = 0;
-      }
+      setupMask(x.size());
       auto result = real_type(0.0);
       for (typename T1::size_type i=0; i<x.size(); i++)
         result += Impl::asVector(x[i]).two_norm2()*mask[i];
@@ -687,6 +729,18 @@ namespace Dune {
   private:
     OwnerOverlapCopyCommunication (const OwnerOverlapCopyCommunication&)
     {}
+
+    //! @brief Set up the mask of the owned entries for vectors of the given size.
+    void setupMask (std::size_t size) const
+    {
+      if (mask.size()==size)
+        return;
+      mask.assign(size, 1);
+      for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
+        if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
+          mask[i->local().local()] = 0;
+    }
+
     MPI_Comm comm;
     CollectiveCommunication<MPI_Comm> cc;
     PIS pis;
@@ -221,6 +221,16 @@ namespace Dune
         matrices_->recalculateGalerkin(NegateSet<typename PI::OwnerSet>());
       }
 
+      /**
+       * @brief Update the preconditioner after the values of the fine level matrix changed.
+       *
+       * The aggregates are kept and the Galerkin products of the coarser
+       * levels are recalculated (see recalculateHierarchy()). Then the
+       * smoothers of all levels are updated and the coarse solver is set
+       * up again. A coarse solver given by the user is not changed.
+       */
+      virtual void update();
+
       /**
        * @brief Check whether the coarse solver used is a direct solver.
        * @return True if the coarse level solver is a direct solver.
@@ -262,6 +272,10 @@ namespace Dune
       void createHierarchies(C& criterion,
                              const std::shared_ptr<const Operator>& matrixptr,
                              const PI& pinfo);
+      /**
+       * @brief Create the coarse solver on the coarsest level of the matrix hierarchy.
+       */
+      void createCoarseSolver();
       /**
        * @brief A struct that holds the context of the current level.
        *
@@ -698,6 +712,17 @@ namespace Dune
       // build the necessary smoother hierarchies
       matrices_->coarsenSmoother(*smoothers_, smootherArgs_);
 
+      createCoarseSolver();
+
+      if(verbosity_>0 && matrices_->parallelInformation().finest()->communicator().rank()==0)
+        std::cout<<"Building hierarchy of "<<matrices_->maxlevels()<<" levels "
+                 <<"(including coarse solver) took "<<watch.elapsed()<<" seconds."<<std::endl;
+    }
+
+
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::createCoarseSolver()
+    {
       // test whether we should solve on the coarse level. That is the case if we
       // have that level and if there was a redistribution on this level then our
       // communicator has to be valid (size()>0) as the smoother might try to communicate
@@ -788,12 +813,25 @@ namespace Dune
           }
         }
       }
-
-      if(verbosity_>0 && matrices_->parallelInformation().finest()->communicator().rank()==0)
-        std::cout<<"Building hierarchy of "<<matrices_->maxlevels()<<" levels "
-                 <<"(including coarse solver) took "<<watch.elapsed()<<" seconds."<<std::endl;
     }
 
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::update()
+    {
+      recalculateHierarchy();
+
+      // update the smoothers of all levels
+      typedef typename Hierarchy<Smoother,A>::Iterator Iterator;
+      Iterator coarsest = smoothers_->coarsest();
+      Iterator smoother = smoothers_->finest();
+      if(smoothers_->levels()>0) {
+        for(; smoother != coarsest; ++smoother)
+          smoother->update();
+        smoother->update();
+      }
+
+      createCoarseSolver();
+    }
 
     template<class M, class X, class S, class PI, class A>
     void AMG<M,X,S,PI,A>::pre(Domain& x, Range& b)
@@ -1187,6 +1225,18 @@ namespace Dune
         return std::make_shared<Amg::AMG<OP, X, SeqGS<M,X,Y>>>(op, config);
       if(smoother == "ilu")
         return std::make_shared<Amg::AMG<OP, X, SeqILU<M,X,Y>>>(op, config);
+      if(smoother == "ilut")
+        return std::make_shared<Amg::AMG<OP, X, SeqILUT<M,X,Y>>>(op, config);
+      if(smoother == "chebyshev")
+        return std::make_shared<Amg::AMG<OP, X, SeqChebyshev<M,X,Y>>>(op, config);
+      if(smoother == "fsai")
+        return std::make_shared<Amg::AMG<OP, X, SeqFSAI<M,X,Y>>>(op, config);
+      if(smoother == "spai")
+        return std::make_shared<Amg::AMG<OP, X, SeqSPAI<M,X,Y>>>(op, config);
+      if(smoother == "mcgs")
+        return std::make_shared<Amg::AMG<OP, X, SeqMultiColorGS<M,X,Y>>>(op, config);
+      if(smoother == "mcilu0")
+        return std::make_shared<Amg::AMG<OP, X, SeqMultiColorILU0<M,X,Y>>>(op, config);
       else
         DUNE_THROW(Dune::Exception, "Unknown smoother for AMG");
     }
@@ -1210,6 +1260,18 @@ namespace Dune
         return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqGS<M,X,Y>>,C>>(cop, config, op->getCommunication());
       if(smoother == "ilu")
         return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqILU<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "ilut")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqILUT<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "chebyshev")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqChebyshev<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "fsai")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqFSAI<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "spai")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqSPAI<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "mcgs")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqMultiColorGS<M,X,Y>>,C>>(cop, config, op->getCommunication());
+      if(smoother == "mcilu0")
+        return std::make_shared<Amg::AMG<OP, X, BlockPreconditioner<X,Y,C,SeqMultiColorILU0<M,X,Y>>,C>>(cop, config, op->getCommunication());
       else
         DUNE_THROW(Dune::Exception, "Unknown smoother for AMG");
     }
@@ -1231,6 +1293,18 @@ namespace Dune
         return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqGS<M,X,Y>>,C>>(op, config, op->getCommunication());
       if(smoother == "ilu")
         return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqILU<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "ilut")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqILUT<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "chebyshev")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqChebyshev<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "fsai")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqFSAI<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "spai")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqSPAI<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "mcgs")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqMultiColorGS<M,X,Y>>,C>>(op, config, op->getCommunication());
+      if(smoother == "mcilu0")
+        return std::make_shared<Amg::AMG<OP, X, NonoverlappingBlockPreconditioner<C,SeqMultiColorILU0<M,X,Y>>,C>>(op, config, op->getCommunication());
       else
         DUNE_THROW(Dune::Exception, "Unknown smoother for AMG");
     }
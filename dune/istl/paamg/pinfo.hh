@@ -3,7 +3,11 @@
 #ifndef DUNE_AMG_PINFO_HH
 #define DUNE_AMG_PINFO_HH
 
+#include <vector>
+
 #include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/future.hh>
+#include <dune/common/simd/simd.hh>
 #include <dune/common/enumset.hh>
 
 #if HAVE_MPI
@@ -93,6 +97,20 @@ namespace Dune
         std::abort();
       }
 
+      template<class T1, class T2>
+      Future<std::vector<T2> > idot (const std::vector<const T1*>& x, const std::vector<const T1*>& y) const
+      {
+        // This function should never be called
+        std::abort();
+      }
+
+      template<class T1>
+      std::vector<Simd::Scalar<typename T1::field_type> > blockDot (const T1& x, const T1& y) const
+      {
+        // This function should never be called
+        std::abort();
+      }
+
       template<class T>
       SequentialInformation(const CollectiveCommunication<T>&)
       {}
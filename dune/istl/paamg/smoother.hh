@@ -248,6 +248,22 @@ namespace Dune
     };
 
 
+    /**
+     * @brief Policy for the construction of the SeqMultiColorGS smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqMultiColorGS<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqMultiColorGS<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqMultiColorGS<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqMultiColorGS<M,X,Y>>
+          (args.getMatrix(), args.getArgs().iterations, args.getArgs().relaxationFactor);
+      }
+    };
+
+
     /**
      * @brief Policy for the construction of the SeqJac smoother
      */
@@ -318,6 +334,214 @@ namespace Dune
       }
     };
 
+    template<class M, class X, class Y>
+    class ConstructionArgs<SeqILUT<M,X,Y> >
+      : public DefaultConstructionArgs<SeqILUT<M,X,Y> >
+    {
+    public:
+      typedef typename SeqILUT<M,X,Y>::real_field_type RealType;
+
+      ConstructionArgs(int fill=10, RealType threshold=1e-4)
+        : fill_(fill), threshold_(threshold)
+      {}
+
+      void setFill(int fill)
+      {
+        fill_ = fill;
+      }
+
+      int getFill()
+      {
+        return fill_;
+      }
+
+      void setThreshold(RealType threshold)
+      {
+        threshold_ = threshold;
+      }
+
+      RealType getThreshold()
+      {
+        return threshold_;
+      }
+
+    private:
+      int fill_;
+      RealType threshold_;
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqILUT smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqILUT<M,X,Y> >
+    {
+      typedef ConstructionArgs<SeqILUT<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqILUT<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqILUT<M,X,Y>>
+          (args.getMatrix(), args.getFill(), args.getThreshold(), args.getArgs().relaxationFactor);
+      }
+    };
+
+    template<class M, class X, class Y>
+    class ConstructionArgs<SeqChebyshev<M,X,Y> >
+      : public DefaultConstructionArgs<SeqChebyshev<M,X,Y> >
+    {
+    public:
+      typedef typename SeqChebyshev<M,X,Y>::real_field_type RealType;
+
+      ConstructionArgs(int degree=2, RealType eigenvalueRatio=30.0, int powerIterations=10)
+        : degree_(degree), eigenvalueRatio_(eigenvalueRatio), powerIterations_(powerIterations)
+      {}
+
+      void setDegree(int degree)
+      {
+        degree_ = degree;
+      }
+
+      int getDegree()
+      {
+        return degree_;
+      }
+
+      void setEigenvalueRatio(RealType eigenvalueRatio)
+      {
+        eigenvalueRatio_ = eigenvalueRatio;
+      }
+
+      RealType getEigenvalueRatio()
+      {
+        return eigenvalueRatio_;
+      }
+
+      void setPowerIterations(int powerIterations)
+      {
+        powerIterations_ = powerIterations;
+      }
+
+      int getPowerIterations()
+      {
+        return powerIterations_;
+      }
+
+    private:
+      int degree_;
+      RealType eigenvalueRatio_;
+      int powerIterations_;
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqChebyshev smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqChebyshev<M,X,Y> >
+    {
+      typedef ConstructionArgs<SeqChebyshev<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqChebyshev<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqChebyshev<M,X,Y>>
+          (args.getMatrix(), args.getDegree(), args.getEigenvalueRatio(), args.getPowerIterations());
+      }
+    };
+
+    /**
+     * @brief Policy for the construction of the SeqMultiColorILU0 smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqMultiColorILU0<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqMultiColorILU0<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqMultiColorILU0<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqMultiColorILU0<M,X,Y>>
+          (args.getMatrix(), args.getArgs().relaxationFactor);
+      }
+    };
+
+    template<class M, class X, class Y>
+    class ConstructionArgs<SeqFSAI<M,X,Y> >
+      : public DefaultConstructionArgs<SeqFSAI<M,X,Y> >
+    {
+    public:
+      ConstructionArgs(int n=0)
+        : n_(n)
+      {}
+
+      void setN(int n)
+      {
+        n_ = n;
+      }
+
+      int getN()
+      {
+        return n_;
+      }
+
+    private:
+      int n_;
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqFSAI smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqFSAI<M,X,Y> >
+    {
+      typedef ConstructionArgs<SeqFSAI<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqFSAI<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqFSAI<M,X,Y>>
+          (args.getMatrix(), args.getN(), args.getArgs().relaxationFactor);
+      }
+    };
+
+    template<class M, class X, class Y>
+    class ConstructionArgs<SeqSPAI<M,X,Y> >
+      : public DefaultConstructionArgs<SeqSPAI<M,X,Y> >
+    {
+    public:
+      ConstructionArgs(int n=0)
+        : n_(n)
+      {}
+
+      void setN(int n)
+      {
+        n_ = n;
+      }
+
+      int getN()
+      {
+        return n_;
+      }
+
+    private:
+      int n_;
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqSPAI smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqSPAI<M,X,Y> >
+    {
+      typedef ConstructionArgs<SeqSPAI<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqSPAI<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqSPAI<M,X,Y>>
+          (args.getMatrix(), args.getN(), args.getArgs().relaxationFactor);
+      }
+    };
+
     /**
      * @brief Policy for the construction of the ParSSOR smoother
      */
@@ -494,6 +718,63 @@ namespace Dune
       }
 
 
+      static void postSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<false>(v,d);
+      }
+    };
+
+    template<class M, class X, class Y>
+    struct SmootherApplier<SeqMultiColorGS<M,X,Y> >
+    {
+      typedef SeqMultiColorGS<M,X,Y> Smoother;
+      typedef typename Smoother::range_type Range;
+      typedef typename Smoother::domain_type Domain;
+
+      static void preSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<true>(v,d);
+      }
+
+
+      static void postSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<false>(v,d);
+      }
+    };
+
+    template<class M, class X, class Y, class C>
+    struct SmootherApplier<BlockPreconditioner<X,Y,C,SeqMultiColorGS<M,X,Y> > >
+    {
+      typedef BlockPreconditioner<X,Y,C,SeqMultiColorGS<M,X,Y> > Smoother;
+      typedef typename Smoother::range_type Range;
+      typedef typename Smoother::domain_type Domain;
+
+      static void preSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<true>(v,d);
+      }
+
+
+      static void postSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<false>(v,d);
+      }
+    };
+
+    template<class M, class X, class Y, class C>
+    struct SmootherApplier<NonoverlappingBlockPreconditioner<C,SeqMultiColorGS<M,X,Y> > >
+    {
+      typedef NonoverlappingBlockPreconditioner<C,SeqMultiColorGS<M,X,Y> > Smoother;
+      typedef typename Smoother::range_type Range;
+      typedef typename Smoother::domain_type Domain;
+
+      static void preSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<true>(v,d);
+      }
+
+
       static void postSmooth(Smoother& smoother, Domain& v, Range& d)
       {
         smoother.template apply<false>(v,d);
@@ -170,6 +170,24 @@ void testAMG(int N, int coarsenTarget, int ml)
   std::cout<<"AMG building took the same time as "<<(buildtime/r.elapsed*r.iterations)<<" iterations"<<std::endl;
   std::cout<<"AMG building together with solving took "<<buildtime+solvetime<<std::endl;
 
+  // scale the matrix and compare the updated AMG to a new one
+  mat *= 2.0;
+  amg.update();
+  AMG freshAmg(fop, criterion, smootherArgs);
+
+  Vector d(b), v1(x), v2(x);
+  v1 = 0;
+  v2 = 0;
+  amg.pre(v1, d);
+  amg.apply(v1, d);
+  amg.post(v1);
+  freshAmg.pre(v2, d);
+  freshAmg.apply(v2, d);
+  freshAmg.post(v2);
+  v1 -= v2;
+  if(v1.two_norm() > 1e-8 * v2.two_norm())
+    DUNE_THROW(Dune::Exception, "AMG::update() does not match a new AMG");
+
   /*
      watch.reset();
      cg.apply(x,b,r);
@@ -3,6 +3,7 @@
 #ifndef DUNE_ISTL_TWOLEVELMETHOD_HH
 #define DUNE_ISTL_TWOLEVELMETHOD_HH
 
+#include <optional>
 #include <tuple>
 
 #include<dune/istl/operators.hh>
@@ -263,32 +264,49 @@ private:
    * @brief A wrapper that makes an inverse operator out of AMG.
    *
    * The operator will use one step of AMG to approximately solve
-   * the coarse level system.
+   * the coarse level system. If a reduction is given, AMG steps are
+   * repeated until the coarse level defect is reduced by this factor,
+   * but at most maxCycles times.
    */
   struct AMGInverseOperator : public InverseOperator<X,X>
   {
+    enum { maxCycles = 100 };
+
     AMGInverseOperator(const typename AMGType::Operator& op,
                        const Criterion& crit,
                        const typename AMGType::SmootherArgs& args)
-      : amg_(op, crit,args), first_(true)
+      : op_(op), amg_(op, crit,args), first_(true)
     {}
 
     void apply(X& x, X& b, double reduction, InverseOperatorResult& res)
     {
-      DUNE_UNUSED_PARAMETER(reduction);
-      DUNE_UNUSED_PARAMETER(res);
-      if(first_)
+      prepare(x,b);
+      res.clear();
+      // the cycles work on the defect of the initial guess
+      op_.applyscaleadd(-1,x,b);
+      X v(x);
+      auto def0 = b.two_norm();
+      auto def = def0;
+      int i = 0;
+      while(i < maxCycles && def > reduction*def0)
       {
-        amg_.pre(x,b);
-        first_=false;
-        x_=x;
+        v = 0;
+        amg_.apply(v,b);
+        x += v;
+        op_.applyscaleadd(-1,v,b);
+        def = b.two_norm();
+        ++i;
       }
-      amg_.apply(x,b);
+      res.iterations = i;
+      res.reduction = def0 > 0 ? static_cast<double>(def/def0) : 0.0;
+      res.converged = def <= reduction*def0;
     }
 
     void apply(X& x, X& b, InverseOperatorResult& res)
     {
-      return apply(x,b,1e-8,res);
+      DUNE_UNUSED_PARAMETER(res);
+      prepare(x,b);
+      amg_.apply(x,b);
     }
 
     //! Category of the solver (see SolverCategory::Category)
@@ -303,10 +321,21 @@ private:
         amg_.post(x_);
     }
     AMGInverseOperator(const AMGInverseOperator& other)
-    : x_(other.x_), amg_(other.amg_), first_(other.first_)
+    : op_(other.op_), x_(other.x_), amg_(other.amg_), first_(other.first_)
     {
     }
   private:
+    void prepare(X& x, X& b)
+    {
+      if(first_)
+      {
+        amg_.pre(x,b);
+        first_=false;
+        x_=x;
+      }
+    }
+
+    const typename AMGType::Operator& op_;
     X x_;
     AMGType amg_;
     bool first_;
@@ -420,9 +449,24 @@ public:
   TwoLevelMethod(const TwoLevelMethod& other)
   : operator_(other.operator_), coarseSolver_(new CoarseLevelSolver(*other.coarseSolver_)),
     smoother_(other.smoother_), policy_(other.policy_->clone()),
-    preSteps_(other.preSteps_), postSteps_(other.postSteps_)
+    preSteps_(other.preSteps_), postSteps_(other.postSteps_),
+    coarseTolerance_(other.coarseTolerance_)
   {}
 
+  /**
+   * @brief Relax the accuracy of the coarse level solve by the outer defect.
+   *
+   * By default the coarse level solver is applied once with its own
+   * accuracy, e.g. one step of AMG. With a tolerance each coarse solve
+   * reduces the coarse defect by the reduction computed from the defect
+   * reported by a flexible outer solver, see RelaxedInnerTolerance.
+   * @param tolerance The relaxed tolerance of the coarse level solves.
+   */
+  void setCoarseTolerance(const RelaxedInnerTolerance& tolerance)
+  {
+    coarseTolerance_ = tolerance;
+  }
+
   ~TwoLevelMethod()
   {
     // Each instance has its own policy.
@@ -430,17 +474,25 @@ public:
     delete coarseSolver_;
   }
 
-  void pre(FineDomainType& x, FineRangeType& b)
+  void pre(FineDomainType& x, FineRangeType& b) override
   {
     smoother_->pre(x,b);
+    if(coarseTolerance_)
+      coarseTolerance_->reset();
+  }
+
+  void setOuterDefect(double relativeDefect, double reduction) override
+  {
+    if(coarseTolerance_)
+      coarseTolerance_->update(relativeDefect, reduction);
   }
 
-  void post(FineDomainType& x)
+  void post(FineDomainType& x) override
   {
     DUNE_UNUSED_PARAMETER(x);
   }
 
-  void apply(FineDomainType& v, const FineRangeType& d)
+  void apply(FineDomainType& v, const FineRangeType& d) override
   {
     FineDomainType u(v);
     FineRangeType rhs(d);
@@ -457,7 +509,11 @@ public:
     //Coarse grid correction
     policy_->moveToCoarseLevel(*context.rhs);
     InverseOperatorResult res;
-    coarseSolver_->apply(policy_->getCoarseLevelLhs(), policy_->getCoarseLevelRhs(), res);
+    if(coarseTolerance_)
+      coarseSolver_->apply(policy_->getCoarseLevelLhs(), policy_->getCoarseLevelRhs(),
+                           coarseTolerance_->reduction(), res);
+    else
+      coarseSolver_->apply(policy_->getCoarseLevelLhs(), policy_->getCoarseLevelRhs(), res);
     *context.lhs=0;
     policy_->moveToFineLevel(*context.lhs);
     *context.update += *context.lhs;
@@ -467,7 +523,7 @@ public:
   }
 
   //! Category of the preconditioner (see SolverCategory::Category)
-  virtual SolverCategory::Category category() const
+  virtual SolverCategory::Category category() const override
   {
     return SolverCategory::sequential;
   }
@@ -516,6 +572,8 @@ private:
   std::size_t preSteps_;
   /** @brief The number of postsmoothing steps to apply. */
   std::size_t postSteps_;
+  /** @brief The relaxed tolerance of the coarse level solves, if any. */
+  std::optional<RelaxedInnerTolerance> coarseTolerance_;
 };
 }// end namespace Amg
 }// end namespace Dune
@@ -3,6 +3,8 @@
 #ifndef DUNE_ISTL_PRECONDITIONER_HH
 #define DUNE_ISTL_PRECONDITIONER_HH
 
+#include <algorithm>
+
 #include <dune/common/exceptions.hh>
 
 #include "solvercategory.hh"
@@ -88,6 +90,37 @@ namespace Dune {
      */
     virtual void post (X& x) = 0;
 
+    /*! \brief Update the preconditioner after the values of the matrix changed.
+
+       Recomputes everything that depends on the values of the matrix,
+       e.g. a factorization, in place. The storage and all data that only
+       depends on the sparsity pattern are reused. Preconditioners
+       supporting update() keep a reference to the matrix they were
+       constructed with, hence the matrix has to outlive the preconditioner
+       and may not change its sparsity pattern.
+
+       The default implementation throws NotImplemented.
+     */
+    virtual void update ()
+    {
+      DUNE_THROW(NotImplemented, "This preconditioner does not support update()");
+    }
+
+    /*! \brief Inform the preconditioner about the progress of the outer iteration.
+
+       Flexible solvers call this before each application of the
+       preconditioner. Preconditioners wrapping an inner solver may relax
+       its accuracy as the outer iteration converges, see
+       RelaxedInnerTolerance.
+
+       The default implementation does nothing.
+
+       \param relativeDefect The current outer defect relative to the initial one.
+       \param reduction The relative defect reduction the outer solver has to achieve.
+     */
+    virtual void setOuterDefect (double /*relativeDefect*/, double /*reduction*/)
+    {}
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
 #if DUNE_ISTL_SUPPORT_OLD_CATEGORY_INTERFACE
@@ -103,6 +136,65 @@ namespace Dune {
 
   };
 
+  /**
+   * \brief Reduction of an inexact inner solve relaxed by the outer defect.
+   *
+   * Krylov methods tolerate the less accurate inner solves the smaller the
+   * outer defect already is, see V. Simoncini, D. B. Szyld, Theory of
+   * inexact Krylov subspace methods and applications to scientific
+   * computing, SIAM J. Sci. Comput. 25(2), 2003. With the relative outer
+   * defect \f$\rho_k\f$ and the reduction \f$\varepsilon\f$ the outer solver
+   * has to achieve, the inner solve in step k reduces its defect by
+   * \f[ \eta_k = \min(\eta_{max}, \max(\eta_{min}, \ell\varepsilon/\rho_k)). \f]
+   * Until the first update, i.e. for solvers that do not report their
+   * defect, \f$\eta_{min}\f$ is used.
+   */
+  class RelaxedInnerTolerance
+  {
+  public:
+    /*!
+       \brief Constructor.
+
+       \param minReduction The tightest inner reduction \f$\eta_{min}\f$.
+       \param maxReduction The loosest inner reduction \f$\eta_{max}\f$.
+       \param relaxation The relaxation factor \f$\ell\f$.
+     */
+    RelaxedInnerTolerance (double minReduction, double maxReduction = 0.5, double relaxation = 1.0)
+      : minReduction_(minReduction), maxReduction_(maxReduction),
+        relaxation_(relaxation), reduction_(minReduction)
+    {
+      if (minReduction <= 0 || minReduction > maxReduction)
+        DUNE_THROW(RangeError, "the inner reductions have to satisfy 0 < minReduction <= maxReduction");
+    }
+
+    //! Compute the inner reduction for the current outer defect.
+    void update (double relativeDefect, double reduction)
+    {
+      if (relativeDefect > 0)
+        reduction_ = std::min(maxReduction_, std::max(minReduction_, relaxation_*reduction/relativeDefect));
+      else
+        reduction_ = maxReduction_;
+    }
+
+    //! Start over with the tightest inner reduction.
+    void reset ()
+    {
+      reduction_ = minReduction_;
+    }
+
+    //! The reduction the next inner solve has to achieve.
+    double reduction () const
+    {
+      return reduction_;
+    }
+
+  private:
+    double minReduction_;
+    double maxReduction_;
+    double relaxation_;
+    double reduction_;
+  };
+
 /**
  * @}
  */
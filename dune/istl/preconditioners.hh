@@ -3,12 +3,18 @@
 #ifndef DUNE_ISTL_PRECONDITIONERS_HH
 #define DUNE_ISTL_PRECONDITIONERS_HH
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <dune/common/simd/simd.hh>
 #include <dune/common/unused.hh>
@@ -20,9 +26,13 @@
 #include "solvercategory.hh"
 #include "istlexception.hh"
 #include "matrixutils.hh"
+#include "bcrsmatrix.hh"
+#include "bvector.hh"
 #include "gsetc.hh"
 #include "ildl.hh"
 #include "ilu.hh"
+#include "multicolor.hh"
+#include "spai.hh"
 
 
 namespace Dune {
@@ -66,6 +76,13 @@ namespace Dune {
 
   /**
    * @brief Turns an InverseOperator into a Preconditioner.
+   *
+   * By default the inverse operator is applied with its own reduction. With
+   * a RelaxedInnerTolerance the reduction of each application is computed
+   * from the defect reported by a flexible outer solver like
+   * RestartedFlexibleGMResSolver or RestartedFCGSolver, so the inner solves
+   * get cheaper as the outer iteration converges.
+   *
    * @tparam O The type of the inverse operator to wrap.
    */
   template<class O, int c = -1>
@@ -95,14 +112,37 @@ namespace Dune {
         DUNE_THROW(InvalidStateException, "User-supplied solver category does not match that of the given inverse operator");
     }
 
+    /**
+     * @brief Construct the preconditioner from the solver with an adaptive inner reduction.
+     * @param inverse_operator The inverse operator to wrap.
+     * @param tolerance Computes the reduction of each inner solve from the outer defect.
+     */
+    InverseOperator2Preconditioner(InverseOperator& inverse_operator, const RelaxedInnerTolerance& tolerance)
+    : InverseOperator2Preconditioner(inverse_operator)
+    {
+      tolerance_ = tolerance;
+    }
+
     virtual void pre(domain_type&,range_type&)
-    {}
+    {
+      if(tolerance_)
+        tolerance_->reset();
+    }
 
     virtual void apply(domain_type& v, const range_type& d)
     {
       InverseOperatorResult res;
       range_type copy(d);
-      inverse_operator_.apply(v, copy, res);
+      if(tolerance_)
+        inverse_operator_.apply(v, copy, tolerance_->reduction(), res);
+      else
+        inverse_operator_.apply(v, copy, res);
+    }
+
+    virtual void setOuterDefect(double relativeDefect, double reduction)
+    {
+      if(tolerance_)
+        tolerance_->update(relativeDefect, reduction);
     }
 
     virtual void post(domain_type&)
@@ -116,6 +156,7 @@ namespace Dune {
 
   private:
     InverseOperator& inverse_operator_;
+    std::optional<RelaxedInnerTolerance> tolerance_;
   };
 
   //=====================================================================
@@ -123,6 +164,359 @@ namespace Dune {
   //=====================================================================
 
 
+  /**
+   * \brief How the relaxation factor of the stationary preconditioners is chosen.
+   *
+   *  - fixed: the given relaxation factor is used.
+   *  - spectral: the relaxation factor is computed in the setup and in
+   *    update() from bounds of the spectrum of \f$D^{-1}A\f$ (of A for
+   *    Richardson), which are estimated by a few steps of the power iteration.
+   *  - adaptive: starts like spectral and searches the factor with the
+   *    smallest convergence rate between solves, the observed rates are
+   *    passed to adapt() of the preconditioner. update() moves the search
+   *    by the change of the spectral factor instead of restarting it. The
+   *    solvers do not call adapt(), so the solver factory rejects this mode.
+   *
+   * The spectral factors are optimal for consistently ordered matrices, e.g.
+   * the 5-point Laplacian, and for the stationary iteration. In a Krylov
+   * method the adaptive mode measures the rate of the Krylov method instead.
+   *
+   * In a ParameterTree the mode is given by the key "tuning" and the number
+   * of power iterations of the estimate by "powerIterations" (default 20).
+   */
+  struct RelaxationTuning
+  {
+    enum Mode {
+      fixed,
+      spectral,
+      adaptive
+    };
+  };
+
+  namespace Impl {
+
+    //! \brief read the tuning mode from the key "tuning" of a configuration
+    inline RelaxationTuning::Mode relaxationTuning (const ParameterTree& configuration)
+    {
+      const std::string tuning = configuration.get<std::string>("tuning", "fixed");
+      if (tuning == "fixed")
+        return RelaxationTuning::fixed;
+      if (tuning == "spectral")
+        return RelaxationTuning::spectral;
+      if (tuning == "adaptive")
+        return RelaxationTuning::adaptive;
+      DUNE_THROW(ISTLError, "Unknown relaxation tuning " << tuning);
+    }
+
+    /**
+     * \brief The search of the relaxation factor in the adaptive tuning mode.
+     *
+     * A factor that converged faster than the best one so far is kept and
+     * the search continues in the same direction, otherwise the search
+     * returns to the best factor and continues in the opposite direction
+     * with half the step. The factors stay in \f$(0,w_{max})\f$.
+     */
+    template<class real_type>
+    class RelaxationSearch
+    {
+    public:
+      RelaxationSearch (RelaxationTuning::Mode mode, real_type maxRelaxation)
+        : mode_(mode), maxRelaxation_(maxRelaxation)
+      {}
+
+      //! \brief the tuning mode
+      RelaxationTuning::Mode mode () const
+      {
+        return mode_;
+      }
+
+      //! \brief restart the search at the factor w
+      void reset (real_type w)
+      {
+        best_ = w;
+        bestRate_ = std::numeric_limits<real_type>::max();
+        using std::min;
+        step_ = min(w, maxRelaxation_ - w) / 4;
+        direction_ = 1;
+      }
+
+      //! \brief the next factor to try after w converged with the given rate
+      real_type next (real_type w, real_type rate)
+      {
+        if (mode_ != RelaxationTuning::adaptive)
+          return w;
+        if (rate < bestRate_)
+        {
+          best_ = w;
+          bestRate_ = rate;
+        }
+        else
+        {
+          direction_ = -direction_;
+          step_ /= 2;
+        }
+        return clamp(best_ + direction_ * step_);
+      }
+
+      /**
+       * \brief move the search by a factor, returns the moved factor w
+       *
+       * The best factor, the step and w are scaled, the best rate and the
+       * direction of the search are kept.
+       */
+      real_type rescale (real_type w, real_type factor)
+      {
+        best_ = clamp(best_ * factor);
+        step_ *= factor;
+        return clamp(w * factor);
+      }
+
+    private:
+      //! \brief keep a candidate in (0,maxRelaxation)
+      real_type clamp (real_type candidate) const
+      {
+        if (candidate <= 0)
+          candidate = best_ / 2;
+        if (candidate >= maxRelaxation_)
+          candidate = (best_ + maxRelaxation_) / 2;
+        return candidate;
+      }
+
+      RelaxationTuning::Mode mode_;
+      real_type maxRelaxation_;
+      real_type best_ = 1;
+      real_type bestRate_ = std::numeric_limits<real_type>::max();
+      real_type step_ = 0;
+      int direction_ = 1;
+    };
+
+    /**
+     * \brief Estimate bounds of the spectrum of \f$D^{-1}A\f$ by the power iteration.
+     *
+     * The largest eigenvalue is approximated by the given number of steps of
+     * the power iteration on \f$D^{-1}A\f$. If lambdaMin is given, the
+     * smallest eigenvalue is approximated by the same number of steps on
+     * \f$D^{-1}A - \lambda_{max}I\f$. Without invDiag D is the identity.
+     *
+     * A and the inverted diagonal blocks are applied blockwise, no scaled
+     * copy of the matrix is assembled as PowerIteration_Algorithms would
+     * need it. The eigenvalues are approximated by
+     * the Rayleigh quotient in the inner product \f$(x,y)_D = x^HDy\f$,
+     * for which \f$D^{-1}A\f$ is self-adjoint if A is.
+     *
+     * \returns the approximation of the largest eigenvalue
+     */
+    template<class M, class real_type>
+    real_type estimateSpectrum (const M& A, const InverseBlockDiagonal<M>* invDiag, int iterations,
+                                real_type* lambdaMin = nullptr)
+    {
+      typedef typename M::size_type size_type;
+      typedef typename M::block_type block_type;
+      typedef std::decay_t<decltype(Impl::asMatrix(std::declval<block_type&>()))> dense_block_type;
+      typedef typename FieldTraits<block_type>::field_type K;
+      constexpr int n = dense_block_type::rows;
+      typedef FieldVector<K,n> Block;
+      typedef BlockVector<Block> Vector;
+
+      using std::abs;
+      using std::real;
+
+      // deterministic start vector with components in all eigenvectors
+      Vector x(A.N()), y(A.N());
+      auto startVector = [&](){
+        for (size_type i=0; i<x.N(); ++i)
+          for (int r=0; r<n; ++r)
+            x[i][r] = 1 + ((i*n + r) * 7919 % 97) / real_type(97);
+        x *= real_type(1) / x.two_norm();
+      };
+
+      // one step of the power iteration on D^{-1}A - shift I, returns the Rayleigh quotient of x
+      auto step = [&](real_type shift) -> real_type {
+        real_type xAx = 0;
+        real_type xDx = 0;
+        for (auto i=A.begin(); i!=A.end(); ++i)
+        {
+          const size_type row = i.index();
+          Block Ax(0), Dx(0);
+          for (auto j=i->begin(); j!=i->end(); ++j)
+          {
+            Impl::asMatrix(*j).umv(x[j.index()], Ax);
+            if (j.index() == row)
+              Impl::asMatrix(*j).umv(x[row], Dx);
+          }
+          xAx += real(x[row].dot(Ax));
+          if (invDiag)
+          {
+            xDx += real(x[row].dot(Dx));
+            Impl::asMatrix((*invDiag)[row]).mv(Ax, y[row]);
+          }
+          else
+          {
+            xDx += x[row].two_norm2();
+            y[row] = Ax;
+          }
+          y[row].axpy(-shift, x[row]);
+        }
+        x = y;
+        x *= real_type(1) / x.two_norm();
+        return xAx / xDx - shift;
+      };
+
+      startVector();
+      real_type lambda = 0;
+      for (int k=0; k<std::max(iterations, 1); ++k)
+        lambda = step(0);
+      const real_type lambdaMax = abs(lambda);
+
+      if (lambdaMin)
+      {
+        // the dominant eigenvalue of D^{-1}A - lambdaMax I is lambdaMin - lambdaMax
+        startVector();
+        for (int k=0; k<std::max(iterations, 1); ++k)
+          lambda = step(lambdaMax);
+        *lambdaMin = lambdaMax - abs(lambda);
+      }
+      return lambdaMax;
+    }
+
+    /**
+     * \brief Relaxation factor of SOR and SSOR from the spectrum of \f$D^{-1}A\f$.
+     *
+     * With the spectral radius \f$\mu\f$ of the Jacobi iteration the factor
+     * is \f$2/(1+\sqrt{1-\mu^2})\f$ for SOR and \f$2/(1+\sqrt{2(1-\mu)})\f$
+     * for SSOR (Young). If the Jacobi iteration does not converge, w is kept.
+     */
+    template<class real_type>
+    real_type optimalSORRelaxation (real_type lambdaMin, real_type lambdaMax, bool symmetric, real_type w)
+    {
+      using std::abs;
+      using std::max;
+      using std::sqrt;
+      const real_type mu = max(abs(1 - lambdaMin), abs(lambdaMax - 1));
+      if (!(mu < 1))
+        return w;
+      if (symmetric)
+        return 2 / (1 + sqrt(2 * (1 - mu)));
+      return 2 / (1 + sqrt(1 - mu * mu));
+    }
+
+    /**
+     * \brief The relaxation factor of a stationary preconditioner and its tuning.
+     *
+     * Holds the factor used by SeqSSOR, SeqSOR, SeqJac and Richardson and
+     * chooses it as described in RelaxationTuning. tune() estimates the
+     * spectrum and computes the factor for the given iteration, adapt()
+     * continues the search in the adaptive mode. In the adaptive mode later
+     * calls of tune() move the search by the change of the spectral factor
+     * instead of restarting it.
+     */
+    template<class scalar_type>
+    class RelaxationFactor
+    {
+    public:
+      typedef typename FieldTraits<scalar_type>::real_type real_type;
+
+      //! \brief The iterations the spectral factor is computed for.
+      enum Iteration {
+        //! \f$2/(\lambda_{min}+1.1\lambda_{max})\f$ of \f$D^{-1}A\f$
+        jacobi,
+        //! the same as jacobi with D the identity, the search is not bounded by 2
+        richardson,
+        //! see optimalSORRelaxation()
+        sor,
+        //! see optimalSORRelaxation()
+        ssor
+      };
+
+      /**
+       * \brief Constructor.
+       *
+       * \param w The relaxation factor, the start value if it is tuned.
+       * \param mode How the relaxation factor is chosen.
+       * \param powerIterations The number of power iterations to estimate the spectrum.
+       * \param iteration The iteration the spectral factor is computed for.
+       * \param tunable Whether tune() is called, otherwise only the fixed mode is valid.
+       */
+      RelaxationFactor (scalar_type w, RelaxationTuning::Mode mode, int powerIterations,
+                        Iteration iteration, bool tunable = true)
+        : w_(w), powerIterations_(powerIterations), iteration_(iteration),
+          search_(mode, iteration == richardson ? std::numeric_limits<real_type>::max() : real_type(2))
+      {
+        if (!tunable && mode != RelaxationTuning::fixed)
+          DUNE_THROW(ISTLError, "The tuning of the relaxation factor needs invertible diagonal blocks on block level 1");
+      }
+
+      //! \brief The relaxation factor.
+      scalar_type value () const
+      {
+        return w_;
+      }
+
+      /**
+       * \brief Compute the factor from the estimated spectrum of \f$D^{-1}A\f$.
+       *
+       * Without invDiag D is the identity. Does nothing in the fixed mode.
+       */
+      template<class M>
+      void tune (const M& A, const InverseBlockDiagonal<M>* invDiag = nullptr)
+      {
+        if (search_.mode() == RelaxationTuning::fixed)
+          return;
+        using std::real;
+        real_type lambdaMin;
+        const real_type lambdaMax = estimateSpectrum(A, invDiag, powerIterations_, &lambdaMin);
+        real_type w;
+        if (iteration_ == sor || iteration_ == ssor)
+          w = optimalSORRelaxation(lambdaMin, lambdaMax, iteration_ == ssor, real(w_));
+        else
+          // the estimate of the largest eigenvalue is enlarged by 10 percent for stability
+          w = 2 / (lambdaMin + real_type(1.1) * lambdaMax);
+        if (search_.mode() == RelaxationTuning::adaptive && spectral_ > 0)
+          w_ = search_.rescale(real(w_), w / spectral_);
+        else
+        {
+          w_ = w;
+          search_.reset(w);
+        }
+        spectral_ = w;
+      }
+
+      //! \brief Continue the search with the convergence rate of a solve.
+      void adapt (const InverseOperatorResult& result)
+      {
+        using std::real;
+        if (result.iterations > 0)
+          w_ = search_.next(real(w_), real_type(result.conv_rate));
+      }
+
+    private:
+      scalar_type w_;
+      int powerIterations_;
+      Iteration iteration_;
+      RelaxationSearch<real_type> search_;
+      //! the last spectral factor, 0 before the first tune()
+      real_type spectral_ = 0;
+    };
+
+    /**
+     * \brief Creator of the solver factory for the stationary preconditioners.
+     *
+     * The factory cannot pass the convergence rates of the solves to
+     * adapt(), so the adaptive tuning is rejected.
+     */
+    template<template<class,class,class,int>class Preconditioner>
+    auto tunedPreconditionerCreator ()
+    {
+      return [](auto typeList, const auto& matrix, const ParameterTree& config){
+        if (relaxationTuning(config) == RelaxationTuning::adaptive)
+          DUNE_THROW(ISTLError, "The adaptive relaxation tuning needs calls of adapt() and is not available from the solver factory");
+        return defaultPreconditionerBlockLevelCreator<Preconditioner>()(typeList, matrix, config);
+      };
+    }
+
+  } // end namespace Impl
+
+
   /*!
      \brief Sequential SSOR preconditioner.
 
@@ -147,18 +541,24 @@ namespace Dune {
     typedef typename X::field_type field_type;
     //! \brief scalar type underlying the field_type
     typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
 
     /*! \brief Constructor.
 
        constructor gets all parameters to operate the prec.
        \param A The matrix to operate on.
        \param n The number of iterations to perform.
-       \param w The relaxation factor.
+       \param w The relaxation factor, the start value if it is tuned.
+       \param tuning How the relaxation factor is chosen, see RelaxationTuning.
+       \param powerIterations The number of power iterations to estimate the spectrum for the tuning.
      */
-    SeqSSOR (const M& A, int n, scalar_field_type w)
-      : _A_(A), _n(n), _w(w)
+    SeqSSOR (const M& A, int n, scalar_field_type w,
+             RelaxationTuning::Mode tuning = RelaxationTuning::fixed, int powerIterations = 20)
+      : _A_(A), _n(n), _w(w, tuning, powerIterations, Impl::RelaxationFactor<scalar_field_type>::ssor, invertDiagonal)
     {
       CheckIfDiagonalPresent<M,l>::check(_A_);
+      update();
     }
 
     /*!
@@ -170,7 +570,9 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        iterations        | The number of iterations to perform. default=1
-       relaxation        | The relaxation factor. default=1.0
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
@@ -187,12 +589,15 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        iterations        | The number of iterations to perform. default=1
-       relaxation        | The relaxation factor. default=1.0
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     SeqSSOR (const M& A, const ParameterTree& configuration)
-      : SeqSSOR(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0))
+      : SeqSSOR(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0),
+                 Impl::relaxationTuning(configuration), configuration.get<int>("powerIterations",20))
     {}
 
     /*!
@@ -214,10 +619,16 @@ namespace Dune {
      */
     virtual void apply (X& v, const Y& d)
     {
-      for (int i=0; i<_n; i++) {
-        bsorf(_A_,v,d,_w,BL<l>());
-        bsorb(_A_,v,d,_w,BL<l>());
-      }
+      if constexpr (invertDiagonal)
+        for (int i=0; i<_n; i++) {
+          bsorf(_A_,_invDiag,v,d,_w.value());
+          bsorb(_A_,_invDiag,v,d,_w.value());
+        }
+      else
+        for (int i=0; i<_n; i++) {
+          bsorf(_A_,v,d,_w.value(),BL<l>());
+          bsorb(_A_,v,d,_w.value(),BL<l>());
+        }
     }
 
     /*!
@@ -230,21 +641,57 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the inverted diagonal blocks if they are stored and
+       the relaxation factor if it is tuned.
+     */
+    virtual void update ()
+    {
+      if constexpr (invertDiagonal)
+      {
+        _invDiag.compute(_A_);
+        _w.tune(_A_, &_invDiag);
+      }
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
       return SolverCategory::sequential;
     }
 
+    //! \brief The relaxation factor used by apply().
+    scalar_field_type relaxation () const
+    {
+      return _w.value();
+    }
+
+    /*!
+       \brief Adapt the relaxation factor to the convergence rate of a solve.
+
+       Only has an effect in the adaptive tuning mode, see RelaxationTuning.
+     */
+    void adapt (const InverseOperatorResult& result)
+    {
+      _w.adapt(result);
+    }
+
   private:
+    //! \brief Whether the diagonal blocks are inverted once instead of solving with them in each sweep.
+    static constexpr bool invertDiagonal = (l == 1) && InverseBlockDiagonal<M>::cached;
+
     //! \brief The matrix we operate on.
     const M& _A_;
     //! \brief The number of steps to do in apply
     int _n;
-    //! \brief The relaxation factor to use
-    scalar_field_type _w;
+    //! \brief The relaxation factor to use.
+    Impl::RelaxationFactor<scalar_field_type> _w;
+    //! \brief The inverted diagonal blocks.
+    InverseBlockDiagonal<M> _invDiag;
   };
-  DUNE_REGISTER_PRECONDITIONER("ssor", defaultPreconditionerBlockLevelCreator<Dune::SeqSSOR>());
+  DUNE_REGISTER_PRECONDITIONER("ssor", Impl::tunedPreconditionerCreator<Dune::SeqSSOR>());
 
 
   /*!
@@ -271,18 +718,24 @@ namespace Dune {
     typedef typename X::field_type field_type;
     //! \brief scalar type underlying the field_type
     typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
 
     /*! \brief Constructor.
 
        constructor gets all parameters to operate the prec.
        \param A The matrix to operate on.
        \param n The number of iterations to perform.
-       \param w The relaxation factor.
+       \param w The relaxation factor, the start value if it is tuned.
+       \param tuning How the relaxation factor is chosen, see RelaxationTuning.
+       \param powerIterations The number of power iterations to estimate the spectrum for the tuning.
      */
-    SeqSOR (const M& A, int n, scalar_field_type w)
-      : _A_(A), _n(n), _w(w)
+    SeqSOR (const M& A, int n, scalar_field_type w,
+            RelaxationTuning::Mode tuning = RelaxationTuning::fixed, int powerIterations = 20)
+      : _A_(A), _n(n), _w(w, tuning, powerIterations, Impl::RelaxationFactor<scalar_field_type>::sor, invertDiagonal)
     {
       CheckIfDiagonalPresent<M,l>::check(_A_);
+      update();
     }
 
     /*!
@@ -294,7 +747,9 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        iterations        | The number of iterations to perform. default=1
-       relaxation        | The relaxation factor. default=1.0
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
@@ -311,12 +766,15 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        iterations        | The number of iterations to perform. default=1
-       relaxation        | The relaxation factor. default=1.0
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     SeqSOR (const M& A, const ParameterTree& configuration)
-      : SeqSOR(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0))
+      : SeqSOR(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0),
+                Impl::relaxationTuning(configuration), configuration.get<int>("powerIterations",20))
     {}
 
     /*!
@@ -351,14 +809,28 @@ namespace Dune {
     template<bool forward>
     void apply(X& v, const Y& d)
     {
-      if(forward)
-        for (int i=0; i<_n; i++) {
-          bsorf(_A_,v,d,_w,BL<l>());
-        }
+      if constexpr (invertDiagonal)
+      {
+        if(forward)
+          for (int i=0; i<_n; i++) {
+            bsorf(_A_,_invDiag,v,d,_w.value());
+          }
+        else
+          for (int i=0; i<_n; i++) {
+            bsorb(_A_,_invDiag,v,d,_w.value());
+          }
+      }
       else
-        for (int i=0; i<_n; i++) {
-          bsorb(_A_,v,d,_w,BL<l>());
-        }
+      {
+        if(forward)
+          for (int i=0; i<_n; i++) {
+            bsorf(_A_,v,d,_w.value(),BL<l>());
+          }
+        else
+          for (int i=0; i<_n; i++) {
+            bsorb(_A_,v,d,_w.value(),BL<l>());
+          }
+      }
     }
 
     /*!
@@ -371,21 +843,57 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the inverted diagonal blocks if they are stored and
+       the relaxation factor if it is tuned.
+     */
+    virtual void update ()
+    {
+      if constexpr (invertDiagonal)
+      {
+        _invDiag.compute(_A_);
+        _w.tune(_A_, &_invDiag);
+      }
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
       return SolverCategory::sequential;
     }
 
+    //! \brief The relaxation factor used by apply().
+    scalar_field_type relaxation () const
+    {
+      return _w.value();
+    }
+
+    /*!
+       \brief Adapt the relaxation factor to the convergence rate of a solve.
+
+       Only has an effect in the adaptive tuning mode, see RelaxationTuning.
+     */
+    void adapt (const InverseOperatorResult& result)
+    {
+      _w.adapt(result);
+    }
+
   private:
+    //! \brief Whether the diagonal blocks are inverted once instead of solving with them in each sweep.
+    static constexpr bool invertDiagonal = (l == 1) && InverseBlockDiagonal<M>::cached;
+
     //! \brief the matrix we operate on.
     const M& _A_;
     //! \brief The number of steps to perform in apply.
     int _n;
     //! \brief The relaxation factor to use.
-    scalar_field_type _w;
+    Impl::RelaxationFactor<scalar_field_type> _w;
+    //! \brief The inverted diagonal blocks.
+    InverseBlockDiagonal<M> _invDiag;
   };
-  DUNE_REGISTER_PRECONDITIONER("sor", defaultPreconditionerBlockLevelCreator<Dune::SeqSOR>());
+  DUNE_REGISTER_PRECONDITIONER("sor", Impl::tunedPreconditionerCreator<Dune::SeqSOR>());
 
 
   /*! \brief Sequential Gauss Seidel preconditioner
@@ -400,20 +908,24 @@ namespace Dune {
    */
   template<class M, class X, class Y, int l=1>
   using SeqGS = SeqSOR<M,X,Y,l>;
-  DUNE_REGISTER_PRECONDITIONER("gs", defaultPreconditionerBlockLevelCreator<Dune::SeqGS>());
+  DUNE_REGISTER_PRECONDITIONER("gs", Impl::tunedPreconditionerCreator<Dune::SeqGS>());
 
-  /*! \brief The sequential jacobian preconditioner.
+  /*!
+     \brief Sequential multi-color Gauss-Seidel preconditioner.
 
-     Wraps the naked ISTL generic block Jacobi preconditioner into the
-      solver framework.
+     The rows of the matrix are colored such that rows of the same color
+     are not coupled (see computeColoring). A sweep processes the colors
+     one after another, the rows of one color are updated concurrently if
+     threads are enabled. The result is a Gauss-Seidel sweep for the
+     matrix permuted by colors. The coloring is computed once in the
+     constructor.
 
      \tparam M The matrix type to operate on
      \tparam X Type of the update
      \tparam Y Type of the defect
-     \tparam l The block level to invert. Default is 1
    */
-  template<class M, class X, class Y, int l=1>
-  class SeqJac : public Preconditioner<X,Y> {
+  template<class M, class X, class Y>
+  class SeqMultiColorGS : public Preconditioner<X,Y> {
   public:
     //! \brief The matrix type the preconditioner is for.
     typedef M matrix_type;
@@ -428,15 +940,16 @@ namespace Dune {
 
     /*! \brief Constructor.
 
-       Constructor gets all parameters to operate the prec.
+       constructor gets all parameters to operate the prec.
        \param A The matrix to operate on.
        \param n The number of iterations to perform.
        \param w The relaxation factor.
      */
-    SeqJac (const M& A, int n, scalar_field_type w)
+    SeqMultiColorGS (const M& A, int n, scalar_field_type w)
       : _A_(A), _n(n), _w(w)
     {
-      CheckIfDiagonalPresent<M,l>::check(_A_);
+      CheckIfDiagonalPresent<M,1>::check(_A_);
+      computeColoring(_A_, _coloring);
     }
 
     /*!
@@ -452,8 +965,8 @@ namespace Dune {
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
-    SeqJac (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
-      : SeqJac(A->getmat(), configuration)
+    SeqMultiColorGS (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqMultiColorGS(A->getmat(), configuration)
     {}
 
     /*!
@@ -469,8 +982,8 @@ namespace Dune {
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
-    SeqJac (const M& A, const ParameterTree& configuration)
-      : SeqJac(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0))
+    SeqMultiColorGS (const M& A, const ParameterTree& configuration)
+      : SeqMultiColorGS(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0))
     {}
 
     /*!
@@ -491,9 +1004,26 @@ namespace Dune {
      */
     virtual void apply (X& v, const Y& d)
     {
-      for (int i=0; i<_n; i++) {
-        dbjac(_A_,v,d,_w,BL<l>());
-      }
+      this->template apply<true>(v,d);
+    }
+
+    /*!
+       \brief Apply the preconditioner in a special direction.
+
+       If forward is true the colors are processed in ascending
+       order, otherwise in descending order.
+     */
+    template<bool forward>
+    void apply(X& v, const Y& d)
+    {
+      if(forward)
+        for (int i=0; i<_n; i++) {
+          bmcsorf(_A_,_coloring,v,d,_w);
+        }
+      else
+        for (int i=0; i<_n; i++) {
+          bmcsorb(_A_,_coloring,v,d,_w);
+        }
     }
 
     /*!
@@ -506,6 +1036,14 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       Nothing to recompute, the coloring only depends on the sparsity pattern.
+     */
+    virtual void update ()
+    {}
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -513,77 +1051,77 @@ namespace Dune {
     }
 
   private:
-    //! \brief The matrix we operate on.
+    //! \brief the matrix we operate on.
     const M& _A_;
-    //! \brief The number of steps to perform during apply.
+    //! \brief The coloring of the matrix rows.
+    MatrixColoring _coloring;
+    //! \brief The number of steps to perform in apply.
     int _n;
-    //! \brief The relaxation parameter to use.
+    //! \brief The relaxation factor to use.
     scalar_field_type _w;
   };
-  DUNE_REGISTER_PRECONDITIONER("jac", defaultPreconditionerBlockLevelCreator<Dune::SeqJac>());
+  DUNE_REGISTER_PRECONDITIONER("mcgs", defaultPreconditionerCreator<Dune::SeqMultiColorGS>());
 
+  /*! \brief The sequential jacobian preconditioner.
 
-
-  /*!
-     \brief Sequential ILU preconditioner.
-
-     Wraps the naked ISTL generic ILU preconditioner into the solver framework.
+     Wraps the naked ISTL generic block Jacobi preconditioner into the
+      solver framework.
 
      \tparam M The matrix type to operate on
      \tparam X Type of the update
      \tparam Y Type of the defect
-     \tparam l Ignored. Just there to have the same number of template arguments
-     as other preconditioners.
+     \tparam l The block level to invert. Default is 1
    */
   template<class M, class X, class Y, int l=1>
-  class SeqILU : public Preconditioner<X,Y> {
+  class SeqJac : public Preconditioner<X,Y> {
   public:
     //! \brief The matrix type the preconditioner is for.
-    typedef typename std::remove_const<M>::type matrix_type;
-    //! block type of matrix
-    typedef typename matrix_type :: block_type block_type;
+    typedef M matrix_type;
     //! \brief The domain type of the preconditioner.
     typedef X domain_type;
     //! \brief The range type of the preconditioner.
     typedef Y range_type;
-
     //! \brief The field type of the preconditioner.
     typedef typename X::field_type field_type;
-
     //! \brief scalar type underlying the field_type
     typedef Simd::Scalar<field_type> scalar_field_type;
-
-    //! \brief type of ILU storage
-    typedef typename ILU::CRS< block_type , typename M::allocator_type> CRS;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
 
     /*! \brief Constructor.
 
-       Constructor invoking ILU(0) gets all parameters to operate the prec.
+       Constructor gets all parameters to operate the prec.
        \param A The matrix to operate on.
-       \param w The relaxation factor.
-       \param resort true if a resort of the computed ILU for improved performance should be done.
+       \param n The number of iterations to perform.
+       \param w The relaxation factor, the start value if it is tuned.
+       \param tuning How the relaxation factor is chosen, see RelaxationTuning.
+       \param powerIterations The number of power iterations to estimate the spectrum for the tuning.
      */
-    SeqILU (const M& A, scalar_field_type w, const bool resort = false )
-      : SeqILU( A, 0, w, resort ) // construct ILU(0)
+    SeqJac (const M& A, int n, scalar_field_type w,
+            RelaxationTuning::Mode tuning = RelaxationTuning::fixed, int powerIterations = 20)
+      : _A_(A), _n(n), _w(w, tuning, powerIterations, Impl::RelaxationFactor<scalar_field_type>::jacobi, invertDiagonal)
     {
+      CheckIfDiagonalPresent<M,l>::check(_A_);
+      update();
     }
 
     /*!
-      \brief Constructor.
+       \brief Constructor.
 
-      \param A The assembled linear operator to use.
-      \param configuration ParameterTree containing preconditioner parameters.
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
 
-      ParameterTree Key | Meaning
-      ------------------|------------
-      n                 | The order of the ILU decomposition. default=0
-      relaxation        | The relaxation factor. default=1.0
-      resort            | True if a resort of the computed ILU for improved performance should be done. default=false
+       ParameterTree Key | Meaning
+       ------------------|------------
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
-      See \ref ISTL_Factory for the ParameterTree layout and examples.
-    */
-    SeqILU (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
-      : SeqILU(A->getmat(), configuration)
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqJac (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqJac(A->getmat(), configuration)
     {}
 
     /*!
@@ -594,57 +1132,18 @@ namespace Dune {
 
        ParameterTree Key | Meaning
        ------------------|------------
-      n                 | The order of the ILU decomposition. default=0
-      relaxation        | The relaxation factor. default=1.0
-      resort            | True if a resort of the computed ILU for improved performance should be done. default=false
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
-    SeqILU(const M& A, const ParameterTree& config)
-      : SeqILU(A, config.get("n", 0),
-               config.get<scalar_field_type>("relaxation", 1.0),
-               config.get("resort", false))
+    SeqJac (const M& A, const ParameterTree& configuration)
+      : SeqJac(A, configuration.get<int>("iterations",1), configuration.get<scalar_field_type>("relaxation",1.0),
+                Impl::relaxationTuning(configuration), configuration.get<int>("powerIterations",20))
     {}
 
-   /*! \brief Constructor.
-
-       Constructor invoking ILU(n).
-       \param A The matrix to operate on.
-       \param n The order of the ILU decomposition.
-       \param w The relaxation factor.
-       \param resort true if a resort of the computed ILU for improved performance should be done.
-     */
-    SeqILU (const M& A, int n, scalar_field_type w, const bool resort = false )
-      : ILU_(),
-        lower_(),
-        upper_(),
-        inv_(),
-        w_(w),
-        wNotIdentity_([w]{using std::abs; return abs(w - scalar_field_type(1)) > 1e-15;}() )
-    {
-      if( n == 0 )
-      {
-        // copy A
-        ILU_.reset( new matrix_type( A ) );
-        // create ILU(0) decomposition
-        bilu0_decomposition( *ILU_ );
-      }
-      else
-      {
-        // create matrix in build mode
-        ILU_.reset( new matrix_type(  A.N(), A.M(), matrix_type::row_wise) );
-        // create ILU(n) decomposition
-        bilu_decomposition( A, n, *ILU_ );
-      }
-
-      if( resort )
-      {
-        // store ILU in simple CRS format
-        ILU::convertToCRS( *ILU_, lower_, upper_, inv_ );
-        ILU_.reset();
-      }
-    }
-
     /*!
        \brief Prepare the preconditioner.
 
@@ -663,19 +1162,14 @@ namespace Dune {
      */
     virtual void apply (X& v, const Y& d)
     {
-      if( ILU_ )
-      {
-        bilu_backsolve( *ILU_, v, d);
-      }
+      if constexpr (invertDiagonal)
+        for (int i=0; i<_n; i++) {
+          dbjac(_A_,_invDiag,v,d,_w.value());
+        }
       else
-      {
-        ILU::bilu_backsolve(lower_, upper_, inv_, v, d);
-      }
-
-      if( wNotIdentity_ )
-      {
-        v *= w_;
-      }
+        for (int i=0; i<_n; i++) {
+          dbjac(_A_,v,d,_w.value(),BL<l>());
+        }
     }
 
     /*!
@@ -688,40 +1182,81 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the inverted diagonal blocks if they are stored and
+       the relaxation factor if it is tuned.
+     */
+    virtual void update ()
+    {
+      if constexpr (invertDiagonal)
+      {
+        _invDiag.compute(_A_);
+        _w.tune(_A_, &_invDiag);
+      }
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
       return SolverCategory::sequential;
     }
 
-  protected:
-    //! \brief The ILU(n) decomposition of the matrix. As storage a BCRSMatrix is used.
-    std::unique_ptr< matrix_type > ILU_;
+    //! \brief The relaxation factor used by apply().
+    scalar_field_type relaxation () const
+    {
+      return _w.value();
+    }
 
-    //! \brief The ILU(n) decomposition of the matrix. As storage a CRS structure is used.
-    CRS lower_;
-    CRS upper_;
-    std::vector< block_type, typename matrix_type::allocator_type > inv_;
+    /*!
+       \brief Adapt the relaxation factor to the convergence rate of a solve.
+
+       Only has an effect in the adaptive tuning mode, see RelaxationTuning.
+     */
+    void adapt (const InverseOperatorResult& result)
+    {
+      _w.adapt(result);
+    }
+
+  private:
+    //! \brief Whether the diagonal blocks are inverted once instead of solving with them in each sweep.
+    static constexpr bool invertDiagonal = (l == 1) && InverseBlockDiagonal<M>::cached;
 
+    //! \brief The matrix we operate on.
+    const M& _A_;
+    //! \brief The number of steps to perform during apply.
+    int _n;
     //! \brief The relaxation factor to use.
-    const scalar_field_type w_;
-    //! \brief true if w != 1.0
-    const bool wNotIdentity_;
+    Impl::RelaxationFactor<scalar_field_type> _w;
+    //! \brief The inverted diagonal blocks.
+    InverseBlockDiagonal<M> _invDiag;
   };
-  DUNE_REGISTER_PRECONDITIONER("ilu", defaultPreconditionerBlockLevelCreator<Dune::SeqILU>());
+  DUNE_REGISTER_PRECONDITIONER("jac", Impl::tunedPreconditionerCreator<Dune::SeqJac>());
 
+  /*! \brief The sequential Chebyshev polynomial preconditioner.
 
-  /*!
-     \brief Richardson preconditioner.
+     Applies a Chebyshev polynomial of the Jacobi preconditioned matrix
+     \f$D^{-1}A\f$, where \f$D\f$ is the block diagonal of \f$A\f$, to the
+     defect. The polynomial is chosen to damp the error in the range
+     \f$[\lambda_{max}/r, \lambda_{max}]\f$ of the spectrum of \f$D^{-1}A\f$,
+     which makes it a smoother for multigrid methods. The upper bound
+     \f$\lambda_{max}\f$ is estimated by a few steps of the power iteration
+     and enlarged by 10 percent.
 
-        Multiply simply by a constant.
+     Each of the (degree) steps only needs a matrix-vector product and
+     vector updates, all rows are processed concurrently if threads are
+     enabled. The polynomial is symmetric if A is symmetric.
 
+     \tparam M The matrix type to operate on
      \tparam X Type of the update
      \tparam Y Type of the defect
    */
-  template<class X, class Y>
-  class Richardson : public Preconditioner<X,Y> {
+  template<class M, class X, class Y>
+  class SeqChebyshev : public Preconditioner<X,Y> {
   public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef M matrix_type;
     //! \brief The domain type of the preconditioner.
     typedef X domain_type;
     //! \brief The range type of the preconditioner.
@@ -730,29 +1265,61 @@ namespace Dune {
     typedef typename X::field_type field_type;
     //! \brief scalar type underlying the field_type
     typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
 
     /*! \brief Constructor.
 
        Constructor gets all parameters to operate the prec.
-       \param w The relaxation factor.
+       \param A The matrix to operate on.
+       \param degree The degree of the polynomial, i.e. the number of matrix-vector products per application.
+       \param eigenvalueRatio The ratio r of the upper and the lower bound of the damped part of the spectrum.
+       \param powerIterations The number of power iterations to estimate the largest eigenvalue.
      */
-    Richardson (scalar_field_type w=1.0) :
-      _w(w)
+    SeqChebyshev (const M& A, int degree, real_field_type eigenvalueRatio = 30.0, int powerIterations = 10)
+      : _A_(A), _degree(degree), _eigenvalueRatio(eigenvalueRatio), _powerIterations(powerIterations)
+    {
+      if (degree < 1)
+        DUNE_THROW(ISTLError, "The degree of the Chebyshev polynomial must be positive");
+      update();
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       degree            | The degree of the polynomial. default=2
+       eigenvalueRatio   | The ratio of the upper and the lower bound of the damped eigenvalues. default=30
+       powerIterations   | The number of power iterations to estimate the largest eigenvalue. default=10
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqChebyshev (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqChebyshev(A->getmat(), configuration)
     {}
 
     /*!
        \brief Constructor.
 
+       \param A The matrix to operate on.
        \param configuration ParameterTree containing preconditioner parameters.
 
        ParameterTree Key | Meaning
        ------------------|------------
-       relaxation        | The relaxation factor. default=1.0
+       degree            | The degree of the polynomial. default=2
+       eigenvalueRatio   | The ratio of the upper and the lower bound of the damped eigenvalues. default=30
+       powerIterations   | The number of power iterations to estimate the largest eigenvalue. default=10
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
-    Richardson (const ParameterTree& configuration)
-      : Richardson(configuration.get<scalar_field_type>("relaxation", 1.0))
+    SeqChebyshev (const M& A, const ParameterTree& configuration)
+      : SeqChebyshev(A, configuration.get<int>("degree",2),
+                     configuration.get<real_field_type>("eigenvalueRatio",30.0),
+                     configuration.get<int>("powerIterations",10))
     {}
 
     /*!
@@ -767,14 +1334,45 @@ namespace Dune {
     }
 
     /*!
-       \brief Apply the precondioner.
+       \brief Apply the preconditioner.
 
        \copydoc Preconditioner::apply(X&,const Y&)
      */
     virtual void apply (X& v, const Y& d)
     {
-      v = d;
-      v *= _w;
+      typedef typename M::size_type size_type;
+
+      // three-term recurrence of the Chebyshev polynomials (Saad, Algorithm 12.1)
+      const real_field_type theta = (_lambdaMax + _lambdaMin) / 2;
+      const real_field_type delta = (_lambdaMax - _lambdaMin) / 2;
+      const real_field_type sigma = theta / delta;
+      real_field_type rho = 1 / sigma;
+
+      _r = v;
+      _p = v;
+
+      residual(v, d);
+      Impl::parallelFor(size_type(0), _A_.N(), [&](size_type i){
+          auto&& pi = Impl::asVector(_p[i]);
+          pi = Impl::asVector(_r[i]);
+          pi *= 1 / theta;
+          Impl::asVector(v[i]) += pi;
+        });
+
+      for (int k=1; k<_degree; ++k)
+      {
+        residual(v, d);
+        const real_field_type rhoNew = 1 / (2*sigma - rho);
+        const real_field_type alpha = rhoNew * rho;
+        const real_field_type beta = 2 * rhoNew / delta;
+        Impl::parallelFor(size_type(0), _A_.N(), [&](size_type i){
+            auto&& pi = Impl::asVector(_p[i]);
+            pi *= alpha;
+            pi.axpy(beta, Impl::asVector(_r[i]));
+            Impl::asVector(v[i]) += pi;
+          });
+        rho = rhoNew;
+      }
     }
 
     /*!
@@ -787,66 +1385,129 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the inverted diagonal blocks and the eigenvalue bounds.
+     */
+    virtual void update ()
+    {
+      _invDiag.compute(_A_);
+      _lambdaMax = real_field_type(1.1) * Impl::estimateSpectrum<M,real_field_type>(_A_, &_invDiag, _powerIterations);
+      _lambdaMin = _lambdaMax / _eigenvalueRatio;
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
       return SolverCategory::sequential;
     }
 
+    //! \brief The estimated upper bound of the spectrum of \f$D^{-1}A\f$.
+    real_field_type maxEigenvalue () const
+    {
+      return _lambdaMax;
+    }
+
   private:
-    //! \brief The relaxation factor to use.
-    scalar_field_type _w;
+    //! \brief compute _r = D^{-1}(d - Av) row by row
+    void residual (const X& v, const Y& d)
+    {
+      typedef typename M::size_type size_type;
+      typedef typename Y::block_type dblock;
+
+      Impl::parallelFor(size_type(0), _A_.N(), [&](size_type i){
+          dblock rhsValue(d[i]);
+          auto&& rhs = Impl::asVector(rhsValue);
+          const auto& row = _A_[i];
+          for (auto j=row.begin(); j!=row.end(); ++j)
+            Impl::asMatrix(*j).mmv(Impl::asVector(v[j.index()]), rhs);
+          auto&& ri = Impl::asVector(_r[i]);
+          Impl::asMatrix(_invDiag[i]).mv(rhs, ri);
+        });
+    }
+
+    //! \brief The matrix we operate on.
+    const M& _A_;
+    //! \brief The degree of the polynomial.
+    int _degree;
+    //! \brief The ratio of the bounds of the damped part of the spectrum.
+    real_field_type _eigenvalueRatio;
+    //! \brief The number of power iterations to estimate the largest eigenvalue.
+    int _powerIterations;
+    //! \brief The inverted diagonal blocks.
+    InverseBlockDiagonal<M> _invDiag;
+    //! \brief The bounds of the damped part of the spectrum.
+    real_field_type _lambdaMin;
+    real_field_type _lambdaMax;
+    //! \brief Temporary vectors for the scaled residual and the update.
+    X _r;
+    X _p;
   };
-  DUNE_REGISTER_PRECONDITIONER("richardson", [](auto tl, const auto& /* mat */, const ParameterTree& config){
-                                               using D = typename Dune::TypeListElement<1, decltype(tl)>::type;
-                                               using R = typename Dune::TypeListElement<2, decltype(tl)>::type;
-                                               return std::make_shared<Richardson<D,R>>(config);
-                                             });
+  DUNE_REGISTER_PRECONDITIONER("chebyshev", defaultPreconditionerCreator<Dune::SeqChebyshev>());
 
 
-  /**
-   * \brief   sequential ILDL preconditioner
-   * \author  Martin Nolte
-   *
-   * Wraps the naked ISTL generic ILDL preconditioner into the solver framework.
-   *
-   * \tparam  M  type of matrix to operate on
-   * \tparam  X  type of update
-   * \tparam  Y  type of defect
-   **/
-  template< class M, class X, class Y >
-  class SeqILDL
-    : public Preconditioner< X, Y >
-  {
-    typedef SeqILDL< M, X, Y > This;
-    typedef Preconditioner< X, Y > Base;
 
+  /*!
+     \brief Sequential ILU preconditioner.
+
+     Wraps the naked ISTL generic ILU preconditioner into the solver framework.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+     \tparam l Ignored. Just there to have the same number of template arguments
+     as other preconditioners.
+   */
+  template<class M, class X, class Y, int l=1>
+  class SeqILU : public Preconditioner<X,Y> {
   public:
-    /** \brief type of matrix the preconditioner is for **/
-    typedef std::remove_const_t< M > matrix_type;
-    /** \brief domain type of the preconditioner **/
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! block type of matrix
+    typedef typename matrix_type :: block_type block_type;
+    //! \brief The domain type of the preconditioner.
     typedef X domain_type;
-    /** \brief range type of the preconditioner **/
+    //! \brief The range type of the preconditioner.
     typedef Y range_type;
-    /** \brief field type of the preconditioner **/
+
+    //! \brief The field type of the preconditioner.
     typedef typename X::field_type field_type;
+
     //! \brief scalar type underlying the field_type
     typedef Simd::Scalar<field_type> scalar_field_type;
 
+    //! \brief type of ILU storage
+    typedef typename ILU::CRS< block_type , typename M::allocator_type> CRS;
+
+    /*! \brief Constructor.
+
+       Constructor invoking ILU(0) gets all parameters to operate the prec.
+       \param A The matrix to operate on.
+       \param w The relaxation factor.
+       \param resort true if a resort of the computed ILU for improved performance should be done.
+     */
+    SeqILU (const M& A, scalar_field_type w, const bool resort = false )
+      : SeqILU( A, 0, w, resort ) // construct ILU(0)
+    {
+    }
+
     /*!
-       \brief Constructor.
+      \brief Constructor.
 
-       \param A The linear operator to use.
-       \param configuration ParameterTree containing preconditioner parameters.
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
 
-       ParameterTree Key | Meaning
-       ------------------|------------
-       relaxation        | relaxation factor
+      ParameterTree Key | Meaning
+      ------------------|------------
+      n                 | The order of the ILU decomposition. default=0
+      relaxation        | The relaxation factor. default=1.0
+      resort            | True if a resort of the computed ILU for improved performance should be done. default=false
 
-       See \ref ISTL_Factory for the ParameterTree layout and examples.
-     */
-    SeqILDL (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
-      : SeqILDL(A->getmat(), configuration)
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqILU (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqILU(A->getmat(), configuration)
     {}
 
     /*!
@@ -857,59 +1518,1376 @@ namespace Dune {
 
        ParameterTree Key | Meaning
        ------------------|------------
-       relaxation        | relaxation factor. default=1.0
+      n                 | The order of the ILU decomposition. default=0
+      relaxation        | The relaxation factor. default=1.0
+      resort            | True if a resort of the computed ILU for improved performance should be done. default=false
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
-    SeqILDL(const matrix_type& A, const ParameterTree& config)
-      : SeqILDL(A, config.get<scalar_field_type>("relaxation", 1.0))
+    SeqILU(const M& A, const ParameterTree& config)
+      : SeqILU(A, config.get("n", 0),
+               config.get<scalar_field_type>("relaxation", 1.0),
+               config.get("resort", false))
     {}
 
-    /**
-     * \brief constructor
-     *
-     * The constructor copies the matrix A and computes its ILDL decomposition.
-     *
-     * \param[in]  A      matrix to operate on
-     * \param[in]  relax  relaxation factor
-     **/
-    explicit SeqILDL ( const matrix_type &A, scalar_field_type relax = scalar_field_type( 1 ) )
-      : decomposition_( A.N(), A.M(), matrix_type::random ),
-        relax_( relax )
+   /*! \brief Constructor.
+
+       Constructor invoking ILU(n).
+       \param A The matrix to operate on.
+       \param n The order of the ILU decomposition.
+       \param w The relaxation factor.
+       \param resort true if a resort of the computed ILU for improved performance should be done.
+     */
+    SeqILU (const M& A, int n, scalar_field_type w, const bool resort = false )
+      : A_(A),
+        resort_(resort),
+        ILU_(),
+        lower_(),
+        upper_(),
+        inv_(),
+        symbolic_(),
+        w_(w),
+        wNotIdentity_([w]{using std::abs; return abs(w - scalar_field_type(1)) > 1e-15;}() )
     {
-      // setup row sizes for lower triangular matrix
-      for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+      // symbolic phase: the pattern of the factors
+      std::unique_ptr< matrix_type > pattern;
+      if( n == 0 )
+        pattern.reset( new matrix_type( A ) );
+      else
       {
-        const auto &A_i = *i;
-        const auto ij = A_i.find( i.index() );
-        if( ij != A_i.end() )
-          decomposition_.setrowsize( i.index(), ij.offset()+1 );
-        else
-          DUNE_THROW( ISTLError, "diagonal entry missing" );
+        pattern.reset( new matrix_type( A.N(), A.M(), matrix_type::row_wise ) );
+        bilu_pattern( A, n, *pattern );
       }
-      decomposition_.endrowsizes();
 
-      // setup row indices for lower triangular matrix
-      for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+      // the storage of the factors holds the pattern, it is reused by all refactorizations
+      if( resort_ )
       {
-        const auto &A_i = *i;
+        ILU::convertToCRS( *pattern, lower_, upper_, inv_ );
+        if( Impl::threadsEnabled() )
+          symbolic_ = ILU::SymbolicILU( lower_, upper_ );
+      }
+      else
+      {
+        ILU_ = std::move( pattern );
+        if( Impl::threadsEnabled() )
+          symbolic_ = ILU::SymbolicILU( *ILU_ );
+      }
+
+      // numeric phase
+      update();
+    }
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      const ILU::LevelSets& lowerLevels = symbolic_.lowerLevels_;
+      const ILU::LevelSets& upperLevels = symbolic_.upperLevels_;
+      if( !resort_ )
+      {
+        if( lowerLevels.empty() )
+          bilu_backsolve( *ILU_, v, d);
+        else
+          ILU::bilu_backsolve( *ILU_, lowerLevels, upperLevels, v, d );
+      }
+      else
+      {
+        if( lowerLevels.empty() )
+          ILU::bilu_backsolve(lower_, upper_, inv_, v, d);
+        else
+          ILU::bilu_backsolve(lower_, upper_, inv_, lowerLevels, upperLevels, v, d);
+      }
+
+      if( wNotIdentity_ )
+      {
+        v *= w_;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the numeric phase of the decomposition in place, the
+       symbolic phase and the storage of the factors are reused. A resorted
+       decomposition is computed in a temporary matrix and copied to the CRS
+       storage.
+     */
+    virtual void update ()
+    {
+      if( !resort_ )
+      {
+        // create ILU(n) decomposition on the pattern
+        bilu_numeric( A_, *ILU_ );
+        return;
+      }
+
+      // decompose into a temporary matrix and store ILU in simple CRS format
+      matrix_type factors( A_.N(), A_.M(), matrix_type::row_wise );
+      ILU::setupPattern( lower_, upper_, factors );
+      bilu_numeric( A_, factors );
+      ILU::copyToCRS( factors, lower_, upper_, inv_ );
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief true if the decomposition is stored in CRS format.
+    const bool resort_;
+
+    //! \brief The ILU(n) decomposition of the matrix. As storage a BCRSMatrix is used,
+    //! it is empty if the decomposition is resorted.
+    std::unique_ptr< matrix_type > ILU_;
+
+    //! \brief The ILU(n) decomposition of the matrix. As storage a CRS structure is used.
+    CRS lower_;
+    CRS upper_;
+    std::vector< block_type, typename matrix_type::allocator_type > inv_;
+
+    //! \brief The level sets of the factors, empty if threads are disabled.
+    ILU::SymbolicILU symbolic_;
+
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+    //! \brief true if w != 1.0
+    const bool wNotIdentity_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("ilu", defaultPreconditionerBlockLevelCreator<Dune::SeqILU>());
+
+  /*!
+     \brief Sequential ILUT preconditioner.
+
+     Wraps the naked ISTL generic ILUT(p,tau) decomposition into the
+     solver framework. Instead of by level of fill as SeqILU, the entries
+     of the factors are dropped by magnitude and at most p entries left
+     and right of the diagonal are kept in each row (see bilut_decomposition).
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqILUT : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param p The maximal number of entries left and right of the diagonal in each row.
+       \param tau The drop tolerance relative to the norm of the row of A.
+       \param w The relaxation factor.
+     */
+    SeqILUT (const M& A, int p, real_field_type tau, scalar_field_type w)
+      : A_(A),
+        p_(p),
+        tau_(tau),
+        ILU_(A.N(), A.M(), matrix_type::row_wise),
+        w_(w),
+        wNotIdentity_([w]{using std::abs; return abs(w - scalar_field_type(1)) > 1e-15;}() )
+    {
+      update();
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      fill              | The maximal number of entries left and right of the diagonal in each row. default=10
+      threshold         | The drop tolerance relative to the norm of the row. default=1e-4
+      relaxation        | The relaxation factor. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqILUT (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqILUT(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       fill              | The maximal number of entries left and right of the diagonal in each row. default=10
+       threshold         | The drop tolerance relative to the norm of the row. default=1e-4
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqILUT (const M& A, const ParameterTree& configuration)
+      : SeqILUT(A, configuration.get<int>("fill",10),
+                configuration.get<real_field_type>("threshold",1e-4),
+                configuration.get<scalar_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      if( lowerLevels_.empty() )
+        bilu_backsolve( ILU_, v, d );
+      else
+        ILU::bilu_backsolve( ILU_, lowerLevels_, upperLevels_, v, d );
+
+      if( wNotIdentity_ )
+      {
+        v *= w_;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the decomposition. The pattern of the factors depends on
+       the values of the matrix, so it is rebuilt as well.
+     */
+    virtual void update ()
+    {
+      ILU_.setSize( A_.N(), A_.M() );
+      bilut_decomposition( A_, p_, tau_, ILU_ );
+
+      // group rows into levels for the threaded triangular solves
+      if( Impl::threadsEnabled() )
+        ILU::computeLevelSets( ILU_, lowerLevels_, upperLevels_ );
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The maximal number of entries left and right of the diagonal.
+    const int p_;
+    //! \brief The drop tolerance.
+    const real_field_type tau_;
+    //! \brief The ILUT decomposition of the matrix.
+    matrix_type ILU_;
+    //! \brief Level sets of the factors, only computed if threads are enabled.
+    ILU::LevelSets lowerLevels_;
+    ILU::LevelSets upperLevels_;
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+    //! \brief true if w != 1.0
+    const bool wNotIdentity_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("ilut", defaultPreconditionerCreator<Dune::SeqILUT>());
+
+
+  /*!
+     \brief Sequential multi-color ILU(0) preconditioner.
+
+     Computes the ILU(0) decomposition of the matrix permuted by colors
+     (see computeColoring). As rows of the same color are not coupled,
+     the rows of one color are factorized and solved for concurrently
+     if threads are enabled. Note that the decomposition differs from
+     the one computed by SeqILU, as the rows are eliminated in a
+     different order.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqMultiColorILU0 : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+
+    /*! \brief Constructor.
+
+       The constructor copies the matrix A and computes its decomposition.
+       \param A The matrix to operate on.
+       \param w The relaxation factor.
+     */
+    SeqMultiColorILU0 (const M& A, scalar_field_type w)
+      : A_(A), ILU_(A), w_(w), wNotIdentity_([w]{using std::abs; return abs(w - scalar_field_type(1)) > 1e-15;}() )
+    {
+      computeColoring(ILU_, coloring_);
+      bmcilu0_decomposition(ILU_, coloring_);
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      relaxation        | The relaxation factor. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqMultiColorILU0 (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqMultiColorILU0(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqMultiColorILU0 (const M& A, const ParameterTree& configuration)
+      : SeqMultiColorILU0(A, configuration.get<scalar_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      bmcilu0_backsolve(ILU_, coloring_, v, d);
+
+      if( wNotIdentity_ )
+      {
+        v *= w_;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the decomposition in place, the coloring is reused.
+     */
+    virtual void update ()
+    {
+      // copy the values of A, the pattern is unchanged
+      Impl::parallelFor(typename matrix_type::size_type(0), A_.N(), [&](auto i){
+          auto ij = ILU_[i].begin();
+          for (auto aij=A_[i].begin(); aij!=A_[i].end(); ++aij, ++ij)
+            *ij = *aij;
+        });
+      bmcilu0_decomposition(ILU_, coloring_);
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The decomposition of the matrix.
+    matrix_type ILU_;
+    //! \brief The coloring of the matrix rows.
+    MatrixColoring coloring_;
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+    //! \brief true if w != 1.0
+    const bool wNotIdentity_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("mcilu0", defaultPreconditionerCreator<Dune::SeqMultiColorILU0>());
+
+  /*!
+     \brief Sequential fine-grained parallel ILU preconditioner.
+
+     Computes the ILU(n) decomposition by a fixed number of fixed-point
+     sweeps (Chow and Patel, "Fine-grained parallel incomplete LU
+     factorization", SIAM J. Sci. Comput. 37, 2015), in which all entries
+     of the factors are updated concurrently. The triangular systems are
+     either solved exactly, or approximately by a fixed number of Jacobi
+     iterations, so that both setup and application run in parallel if
+     threads are enabled. For a large number of sweeps the preconditioner
+     coincides with SeqILU.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqParILU : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param n The order of the ILU decomposition.
+       \param sweeps The number of fixed-point sweeps of the decomposition.
+       \param triangularSweeps The number of Jacobi iterations for each triangular solve,
+                               0 to solve the triangular systems exactly.
+       \param w The relaxation factor.
+     */
+    SeqParILU (const M& A, int n, int sweeps, int triangularSweeps, scalar_field_type w)
+      : A_(A),
+        sweeps_(sweeps),
+        triangularSweeps_(triangularSweeps),
+        w_(w),
+        wNotIdentity_([w]{using std::abs; return abs(w - scalar_field_type(1)) > 1e-15;}() )
+    {
+      if( n == 0 )
+        ILU_ = A;
+      else
+      {
+        ILU_.setBuildMode( matrix_type::row_wise );
+        ILU_.setSize( A.N(), A.M() );
+        bilu_pattern( A, n, ILU_ );
+      }
+      ILU::bilu_iterative_decomposition( A, ILU_, sweeps );
+
+      // group rows into levels for the threaded triangular solves
+      if( triangularSweeps_ == 0 && Impl::threadsEnabled() )
+        ILU::computeLevelSets( ILU_, lowerLevels_, upperLevels_ );
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      n                 | The order of the ILU decomposition. default=0
+      sweeps            | The number of fixed-point sweeps of the decomposition. default=3
+      triangularSweeps  | The number of Jacobi iterations for the triangular solves, 0 for exact solves. default=0
+      relaxation        | The relaxation factor. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqParILU (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqParILU(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       n                 | The order of the ILU decomposition. default=0
+       sweeps            | The number of fixed-point sweeps of the decomposition. default=3
+       triangularSweeps  | The number of Jacobi iterations for the triangular solves, 0 for exact solves. default=0
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqParILU (const M& A, const ParameterTree& configuration)
+      : SeqParILU(A, configuration.get<int>("n",0),
+                  configuration.get<int>("sweeps",3),
+                  configuration.get<int>("triangularSweeps",0),
+                  configuration.get<scalar_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      if( triangularSweeps_ > 0 )
+        ILU::bilu_jacobi_backsolve( ILU_, triangularSweeps_, v, d, old_, y_ );
+      else if( lowerLevels_.empty() )
+        bilu_backsolve( ILU_, v, d );
+      else
+        ILU::bilu_backsolve( ILU_, lowerLevels_, upperLevels_, v, d );
+
+      if( wNotIdentity_ )
+      {
+        v *= w_;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the decomposition on the existing pattern.
+     */
+    virtual void update ()
+    {
+      ILU::bilu_iterative_decomposition( A_, ILU_, sweeps_ );
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The number of fixed-point sweeps of the factorization.
+    const int sweeps_;
+    //! \brief The decomposition of the matrix.
+    matrix_type ILU_;
+    //! \brief Level sets of the factors, only computed for exact triangular solves if threads are enabled.
+    ILU::LevelSets lowerLevels_;
+    ILU::LevelSets upperLevels_;
+    //! \brief The number of Jacobi iterations for the triangular solves.
+    const int triangularSweeps_;
+    //! \brief Temporary vectors of the Jacobi iterations for the triangular solves.
+    X old_;
+    X y_;
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+    //! \brief true if w != 1.0
+    const bool wNotIdentity_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("parilu", defaultPreconditionerCreator<Dune::SeqParILU>());
+
+  /*!
+     \brief Sequential factored sparse approximate inverse preconditioner.
+
+     Computes a lower triangular matrix G with \f$GAG^H \approx I\f$ on the
+     lower triangle of the ILU(n) pattern of the symmetric positive definite
+     matrix A (see bfsai_decomposition) and applies \f$wG^HG\f$. Setup and
+     application only consist of independent row operations, which are
+     processed concurrently if threads are enabled. The preconditioner is
+     symmetric and can be used with the CG method.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqFSAI : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param n The level of the ILU(n) pattern of the factor.
+       \param w The relaxation factor.
+     */
+    SeqFSAI (const M& A, int n, scalar_field_type w)
+      : A_(A),
+        G_(A.N(), A.M(), matrix_type::row_wise),
+        Gt_(A.M(), A.N(), matrix_type::row_wise),
+        w_(w)
+    {
+      bfsai_pattern(A, n, G_);
+      bconjugate_transpose_pattern(G_, Gt_);
+      update();
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      n                 | The level of the ILU(n) pattern of the factor. default=0
+      relaxation        | The relaxation factor. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqFSAI (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqFSAI(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       n                 | The level of the ILU(n) pattern of the factor. default=0
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqFSAI (const M& A, const ParameterTree& configuration)
+      : SeqFSAI(A, configuration.get<int>("n",0),
+                configuration.get<scalar_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      t_ = v;
+      bspai_mv(G_, d, t_, scalar_field_type(1));
+      bspai_mv(Gt_, t_, v, w_);
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the factor on the existing pattern.
+     */
+    virtual void update ()
+    {
+      bfsai_decomposition(A_, G_);
+      bconjugate_transpose_values(G_, Gt_);
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The lower triangular factor.
+    matrix_type G_;
+    //! \brief The conjugate transpose of the factor.
+    matrix_type Gt_;
+    //! \brief Temporary for the product with the factor.
+    X t_;
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("fsai", defaultPreconditionerCreator<Dune::SeqFSAI>());
+
+
+  /*!
+     \brief Sequential sparse approximate inverse preconditioner.
+
+     Computes a matrix \f$M \approx A^{-1}\f$ on the ILU(n) pattern of A by
+     minimizing \f$\|MA - I\|_F\f$ row by row (see bspai_decomposition) and
+     applies \f$wM\f$. Setup and application only consist of independent
+     row operations, which are processed concurrently if threads are enabled.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqSPAI : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param n The level of the ILU(n) pattern of the approximate inverse.
+       \param w The relaxation factor.
+     */
+    SeqSPAI (const M& A, int n, scalar_field_type w)
+      : A_(A),
+        w_(w)
+    {
+      if( n == 0 )
+        inverse_ = A;
+      else
+      {
+        inverse_.setBuildMode( matrix_type::row_wise );
+        inverse_.setSize( A.N(), A.M() );
+        bilu_pattern( A, n, inverse_ );
+      }
+      update();
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      n                 | The level of the ILU(n) pattern of the approximate inverse. default=0
+      relaxation        | The relaxation factor. default=1.0
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqSPAI (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqSPAI(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       n                 | The level of the ILU(n) pattern of the approximate inverse. default=0
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqSPAI (const M& A, const ParameterTree& configuration)
+      : SeqSPAI(A, configuration.get<int>("n",0),
+                configuration.get<scalar_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      bspai_mv(inverse_, d, v, w_);
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the approximate inverse on the existing pattern.
+     */
+    virtual void update ()
+    {
+      bspai_decomposition(A_, inverse_);
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  protected:
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The approximate inverse.
+    matrix_type inverse_;
+    //! \brief The relaxation factor to use.
+    const scalar_field_type w_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("spai", defaultPreconditionerCreator<Dune::SeqSPAI>());
+
+
+  /*!
+     \brief Richardson preconditioner.
+
+        Multiply simply by a constant.
+
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class X, class Y>
+  class Richardson : public Preconditioner<X,Y> {
+  public:
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       Constructor gets all parameters to operate the prec.
+       \param w The relaxation factor.
+     */
+    Richardson (scalar_field_type w=1.0) :
+      _w(w, RelaxationTuning::fixed, 0, Impl::RelaxationFactor<scalar_field_type>::richardson)
+    {}
+
+    /*! \brief Constructor with a tuned relaxation factor.
+
+       The factor \f$2/(\lambda_{min}+\lambda_{max})\f$ is computed from
+       the spectrum of A estimated by the power iteration, see RelaxationTuning.
+       The matrix has to live as long as the preconditioner.
+       \param A The matrix of the operator.
+       \param w The start value of the relaxation factor.
+       \param tuning How the relaxation factor is chosen.
+       \param powerIterations The number of power iterations to estimate the spectrum.
+     */
+    template<class M>
+    Richardson (const M& A, scalar_field_type w, RelaxationTuning::Mode tuning, int powerIterations = 20) :
+      _w(w, tuning, powerIterations, Impl::RelaxationFactor<scalar_field_type>::richardson)
+    {
+      if (tuning != RelaxationTuning::fixed)
+        _tune = [&A](Impl::RelaxationFactor<scalar_field_type>& relaxation){
+          relaxation.tune(A);
+        };
+      update();
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    Richardson (const ParameterTree& configuration)
+      : Richardson(configuration.get<scalar_field_type>("relaxation", 1.0))
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix of the operator.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       relaxation        | The relaxation factor, the start value if it is tuned. default=1.0
+       tuning            | fixed, spectral or adaptive, see RelaxationTuning. default=fixed
+       powerIterations   | See RelaxationTuning. default=20
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    template<class M>
+    Richardson (const M& A, const ParameterTree& configuration)
+      : Richardson(A, configuration.get<scalar_field_type>("relaxation", 1.0),
+                   Impl::relaxationTuning(configuration), configuration.get<int>("powerIterations",20))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the precondioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      v = d;
+      v *= _w.value();
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Recomputes the relaxation factor if it is tuned, the matrix is
+       used directly in each application.
+     */
+    virtual void update ()
+    {
+      if (_tune)
+        _tune(_w);
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The relaxation factor used by apply().
+    scalar_field_type relaxation () const
+    {
+      return _w.value();
+    }
+
+    /*!
+       \brief Adapt the relaxation factor to the convergence rate of a solve.
+
+       Only has an effect in the adaptive tuning mode, see RelaxationTuning.
+     */
+    void adapt (const InverseOperatorResult& result)
+    {
+      _w.adapt(result);
+    }
+
+  private:
+    //! \brief The relaxation factor to use.
+    Impl::RelaxationFactor<scalar_field_type> _w;
+    //! \brief Tunes the relaxation factor to the matrix.
+    std::function<void(Impl::RelaxationFactor<scalar_field_type>&)> _tune;
+  };
+  DUNE_REGISTER_PRECONDITIONER("richardson", [](auto tl, const auto& op, const ParameterTree& config){
+                                               using M = typename Dune::TypeListElement<0, decltype(tl)>::type;
+                                               using D = typename Dune::TypeListElement<1, decltype(tl)>::type;
+                                               using R = typename Dune::TypeListElement<2, decltype(tl)>::type;
+                                               if (Impl::relaxationTuning(config) == RelaxationTuning::fixed)
+                                                 return std::make_shared<Richardson<D,R>>(config);
+                                               if (Impl::relaxationTuning(config) == RelaxationTuning::adaptive)
+                                                 DUNE_THROW(ISTLError, "The adaptive relaxation tuning needs calls of adapt() and is not available from the solver factory");
+                                               auto aop = std::dynamic_pointer_cast<const AssembledLinearOperator<M,D,R>>(op);
+                                               if (!aop)
+                                                 DUNE_THROW(ISTLError, "The tuning of the relaxation factor needs an assembled operator");
+                                               return std::make_shared<Richardson<D,R>>(aop->getmat(), config);
+                                             });
+
+
+  /**
+   * \brief   sequential ILDL preconditioner
+   * \author  Martin Nolte
+   *
+   * Wraps the naked ISTL generic ILDL preconditioner into the solver framework.
+   *
+   * \tparam  M  type of matrix to operate on
+   * \tparam  X  type of update
+   * \tparam  Y  type of defect
+   **/
+  template< class M, class X, class Y >
+  class SeqILDL
+    : public Preconditioner< X, Y >
+  {
+    typedef SeqILDL< M, X, Y > This;
+    typedef Preconditioner< X, Y > Base;
+
+  public:
+    /** \brief type of matrix the preconditioner is for **/
+    typedef std::remove_const_t< M > matrix_type;
+    /** \brief domain type of the preconditioner **/
+    typedef X domain_type;
+    /** \brief range type of the preconditioner **/
+    typedef Y range_type;
+    /** \brief field type of the preconditioner **/
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+
+    /*!
+       \brief Constructor.
+
+       \param A The linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       relaxation        | relaxation factor
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqILDL (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqILDL(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       relaxation        | relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqILDL(const matrix_type& A, const ParameterTree& config)
+      : SeqILDL(A, config.get<scalar_field_type>("relaxation", 1.0))
+    {}
+
+    /**
+     * \brief constructor
+     *
+     * The constructor copies the matrix A and computes its ILDL decomposition.
+     *
+     * \param[in]  A      matrix to operate on
+     * \param[in]  relax  relaxation factor
+     **/
+    explicit SeqILDL ( const matrix_type &A, scalar_field_type relax = scalar_field_type( 1 ) )
+      : A_( A ),
+        decomposition_( A.N(), A.M(), matrix_type::random ),
+        relax_( relax )
+    {
+      // setup row sizes for lower triangular matrix
+      for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+      {
+        const auto &A_i = *i;
+        const auto ij = A_i.find( i.index() );
+        if( ij != A_i.end() )
+          decomposition_.setrowsize( i.index(), ij.offset()+1 );
+        else
+          DUNE_THROW( ISTLError, "diagonal entry missing" );
+      }
+      decomposition_.endrowsizes();
+
+      // setup row indices for lower triangular matrix
+      for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+      {
+        const auto &A_i = *i;
         for( auto ij = A_i.begin(); ij.index() < i.index() ; ++ij )
           decomposition_.addindex( i.index(), ij.index() );
         decomposition_.addindex( i.index(), i.index() );
       }
       decomposition_.endindices();
 
-      // copy values of lower triangular matrix
-      auto i = A.begin();
-      for( auto row = decomposition_.begin(), rowend = decomposition_.end(); row != rowend; ++row, ++i )
-      {
-        auto ij = i->begin();
-        for( auto col = row->begin(), colend = row->end(); col != colend; ++col, ++ij )
-          *col = *ij;
-      }
+      // group rows into levels for the threaded triangular solves
+      if( Impl::threadsEnabled() )
+        bildl_levelsets( decomposition_, levelSets_ );
+
+      update();
+    }
+
+    /** \copydoc Preconditioner::pre(X&,Y&) **/
+    void pre ( X &x, Y &b ) override
+    {
+      DUNE_UNUSED_PARAMETER( x );
+      DUNE_UNUSED_PARAMETER( b );
+    }
+
+    /** \copydoc Preconditioner::apply(X&,const Y&) **/
+    void apply ( X &v, const Y &d ) override
+    {
+      if( levelSets_.lower.empty() )
+        bildl_backsolve( decomposition_, v, d, true );
+      else
+        bildl_backsolve( decomposition_, levelSets_, v, d );
+      v *= relax_;
+    }
+
+    /** \copydoc Preconditioner::post(X&) **/
+    void post ( X &x ) override
+    {
+      DUNE_UNUSED_PARAMETER( x );
+    }
+
+    /**
+     * \brief recompute the ILDL decomposition
+     *
+     * The values of the lower triangle of A are copied into the existing
+     * storage and decomposed again. The sparsity pattern of A must not have
+     * changed since construction.
+     **/
+    void update () override
+    {
+      // copy values of lower triangular matrix
+      auto i = A_.begin();
+      for( auto row = decomposition_.begin(), rowend = decomposition_.end(); row != rowend; ++row, ++i )
+      {
+        auto ij = i->begin();
+        for( auto col = row->begin(), colend = row->end(); col != colend; ++col, ++ij )
+          *col = *ij;
+      }
+
+      // perform ILDL decomposition
+      bildl_decompose( decomposition_ );
+    }
+
+    /** \copydoc Preconditioner::category() **/
+    SolverCategory::Category category () const override { return SolverCategory::sequential; }
+
+  private:
+    const matrix_type &A_;
+    matrix_type decomposition_;
+    ILDLLevelSets levelSets_;
+    scalar_field_type relax_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("ildl", defaultPreconditionerCreator<Dune::SeqILDL>());
+
+
+  /**
+   * \brief sequential incomplete Cholesky preconditioner of order n
+   *
+   * Computes the IC(n) decomposition \f$A \approx LDL^T\f$ of a symmetric
+   * matrix A, e.g. for use with the CGSolver. In contrast to SeqILU only the
+   * lower factor is stored, see bic_pattern and bic_numeric; for n = 0 the
+   * decomposition coincides with SeqILDL.
+   *
+   * If the decomposition breaks down, e.g. because A is not an M-matrix, it
+   * is recomputed with the diagonal blocks of A multiplied by
+   * \f$1+\alpha\f$, doubling \f$\alpha\f$ starting from the given shift
+   * until it succeeds (see bic_shifted).
+   *
+   * If threads are enabled, the triangular solves are scheduled by
+   * levels of independent rows (see bildl_levelsets).
+   *
+   * \tparam M The matrix type to operate on
+   * \tparam X Type of the update
+   * \tparam Y Type of the defect
+   */
+  template< class M, class X, class Y = X >
+  class SeqIC
+    : public Preconditioner< X, Y >
+  {
+  public:
+    /** \brief type of matrix the preconditioner is for **/
+    typedef std::remove_const_t< M > matrix_type;
+    /** \brief domain type of the preconditioner **/
+    typedef X domain_type;
+    /** \brief range type of the preconditioner **/
+    typedef Y range_type;
+    /** \brief field type of the preconditioner **/
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real-valued type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*!
+       \brief Constructor.
 
-      // perform ILDL decomposition
-      bildl_decompose( decomposition_ );
+       \param A The linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       n                 | The order of the incomplete Cholesky decomposition. default=0
+       shift             | The initial diagonal shift after a breakdown. default=1e-3
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqIC (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqIC(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       n                 | The order of the incomplete Cholesky decomposition. default=0
+       shift             | The initial diagonal shift after a breakdown. default=1e-3
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqIC (const matrix_type& A, const ParameterTree& config)
+      : SeqIC(A, config.get("n", 0), config.get<real_field_type>("shift", 1e-3))
+    {}
+
+    /**
+     * \brief constructor
+     *
+     * The constructor sets up the sparsity pattern of the IC(n)
+     * decomposition and computes it.
+     *
+     * \param[in]  A      matrix to operate on
+     * \param[in]  n      order of the incomplete Cholesky decomposition
+     * \param[in]  shift  initial diagonal shift after a breakdown
+     **/
+    explicit SeqIC ( const matrix_type &A, int n = 0, real_field_type shift = real_field_type( 1e-3 ) )
+      : A_( A ),
+        decomposition_( A.N(), A.M(), matrix_type::row_wise ),
+        shift_( shift ),
+        appliedShift_( 0 )
+    {
+      bic_pattern( A_, n, decomposition_ );
+
+      // group rows into levels for the threaded triangular solves
+      if( Impl::threadsEnabled() )
+        bildl_levelsets( decomposition_, levelSets_ );
+
+      update();
     }
 
     /** \copydoc Preconditioner::pre(X&,Y&) **/
@@ -922,8 +2900,10 @@ namespace Dune {
     /** \copydoc Preconditioner::apply(X&,const Y&) **/
     void apply ( X &v, const Y &d ) override
     {
-      bildl_backsolve( decomposition_, v, d, true );
-      v *= relax_;
+      if( levelSets_.lower.empty() )
+        bildl_backsolve( decomposition_, v, d, true );
+      else
+        bildl_backsolve( decomposition_, levelSets_, v, d );
     }
 
     /** \copydoc Preconditioner::post(X&) **/
@@ -932,14 +2912,445 @@ namespace Dune {
       DUNE_UNUSED_PARAMETER( x );
     }
 
+    /**
+     * \brief recompute the IC decomposition
+     *
+     * The values of A are copied into the existing pattern and decomposed
+     * again. The sparsity pattern of A must not have changed since
+     * construction.
+     **/
+    void update () override
+    {
+      appliedShift_ = bic_shifted( [ this ] ( real_field_type alpha ) { bic_numeric( A_, alpha, decomposition_ ); }, shift_ );
+    }
+
+    /** \brief the diagonal shift used by the current decomposition, zero if it did not break down **/
+    real_field_type shift () const { return appliedShift_; }
+
     /** \copydoc Preconditioner::category() **/
     SolverCategory::Category category () const override { return SolverCategory::sequential; }
 
   private:
+    const matrix_type &A_;
     matrix_type decomposition_;
-    scalar_field_type relax_;
+    ILDLLevelSets levelSets_;
+    real_field_type shift_;
+    real_field_type appliedShift_;
   };
-  DUNE_REGISTER_PRECONDITIONER("ildl", defaultPreconditionerCreator<Dune::SeqILDL>());
+  DUNE_REGISTER_PRECONDITIONER("ic", defaultPreconditionerCreator<Dune::SeqIC>());
+
+
+  /**
+   * \brief sequential threshold incomplete Cholesky preconditioner
+   *
+   * Computes the ICT(p,tau) decomposition \f$A \approx LDL^T\f$ of a
+   * symmetric matrix A, storing only the lower factor (see
+   * bict_decomposition). Entries of L below tau times the norm of their row
+   * of A are dropped and at most p entries left of the diagonal are kept in
+   * each row.
+   *
+   * Breakdowns are handled by diagonal shifting as in SeqIC. If threads are
+   * enabled, the triangular solves are scheduled by levels of independent
+   * rows (see bildl_levelsets).
+   *
+   * \tparam M The matrix type to operate on
+   * \tparam X Type of the update
+   * \tparam Y Type of the defect
+   */
+  template< class M, class X, class Y = X >
+  class SeqICT
+    : public Preconditioner< X, Y >
+  {
+  public:
+    /** \brief type of matrix the preconditioner is for **/
+    typedef std::remove_const_t< M > matrix_type;
+    /** \brief domain type of the preconditioner **/
+    typedef X domain_type;
+    /** \brief range type of the preconditioner **/
+    typedef Y range_type;
+    /** \brief field type of the preconditioner **/
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real-valued type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*!
+       \brief Constructor.
+
+       \param A The linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       fill              | The maximal number of entries left of the diagonal per row. default=10
+       threshold         | The drop tolerance relative to the row norm. default=1e-4
+       shift             | The initial diagonal shift after a breakdown. default=1e-3
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqICT (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqICT(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       fill              | The maximal number of entries left of the diagonal per row. default=10
+       threshold         | The drop tolerance relative to the row norm. default=1e-4
+       shift             | The initial diagonal shift after a breakdown. default=1e-3
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqICT (const matrix_type& A, const ParameterTree& config)
+      : SeqICT(A, config.get("fill", 10),
+               config.get<real_field_type>("threshold", 1e-4),
+               config.get<real_field_type>("shift", 1e-3))
+    {}
+
+    /**
+     * \brief constructor
+     *
+     * \param[in]  A          matrix to operate on
+     * \param[in]  p          maximal number of entries left of the diagonal per row
+     * \param[in]  tau        drop tolerance relative to the row norm
+     * \param[in]  shift      initial diagonal shift after a breakdown
+     **/
+    SeqICT ( const matrix_type &A, int p, real_field_type tau, real_field_type shift = real_field_type( 1e-3 ) )
+      : A_( A ),
+        p_( p ),
+        tau_( tau ),
+        shift_( shift ),
+        appliedShift_( 0 )
+    {
+      decomposition_.setBuildMode( matrix_type::row_wise );
+      update();
+    }
+
+    /** \copydoc Preconditioner::pre(X&,Y&) **/
+    void pre ( X &x, Y &b ) override
+    {
+      DUNE_UNUSED_PARAMETER( x );
+      DUNE_UNUSED_PARAMETER( b );
+    }
+
+    /** \copydoc Preconditioner::apply(X&,const Y&) **/
+    void apply ( X &v, const Y &d ) override
+    {
+      if( levelSets_.lower.empty() )
+        bildl_backsolve( decomposition_, v, d, true );
+      else
+        bildl_backsolve( decomposition_, levelSets_, v, d );
+    }
+
+    /** \copydoc Preconditioner::post(X&) **/
+    void post ( X &x ) override
+    {
+      DUNE_UNUSED_PARAMETER( x );
+    }
+
+    /**
+     * \brief recompute the ICT decomposition
+     *
+     * The sparsity pattern of the decomposition is set up anew, so the
+     * pattern of A may have changed.
+     **/
+    void update () override
+    {
+      appliedShift_ = bic_shifted( [ this ] ( real_field_type alpha ) {
+          decomposition_.setSize( A_.N(), A_.M() );
+          bict_decomposition( A_, p_, tau_, alpha, decomposition_ );
+        }, shift_ );
+
+      levelSets_ = ILDLLevelSets();
+      if( Impl::threadsEnabled() )
+        bildl_levelsets( decomposition_, levelSets_ );
+    }
+
+    /** \brief the diagonal shift used by the current decomposition, zero if it did not break down **/
+    real_field_type shift () const { return appliedShift_; }
+
+    /** \copydoc Preconditioner::category() **/
+    SolverCategory::Category category () const override { return SolverCategory::sequential; }
+
+  private:
+    const matrix_type &A_;
+    matrix_type decomposition_;
+    ILDLLevelSets levelSets_;
+    int p_;
+    real_field_type tau_;
+    real_field_type shift_;
+    real_field_type appliedShift_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("ict", defaultPreconditionerCreator<Dune::SeqICT>());
+
+
+  /**
+   * \brief Block Jacobi preconditioner with a sequential preconditioner per subdomain.
+   *
+   * The rows of the matrix are split into contiguous chunks of about equal
+   * size, one for each thread by default. Every chunk is extended by
+   * `overlap` layers of neighboring rows of the matrix graph, the
+   * restriction of the matrix to such a subdomain is preconditioned by a
+   * local preconditioner of type P, e.g. SeqILU or SeqILDL. The subdomains
+   * are set up and applied concurrently if threads are enabled.
+   *
+   * The local corrections are only written to the rows owned by a chunk
+   * (restricted additive Schwarz). Without overlap this is a block
+   * Jacobi method and symmetric if the local preconditioners are.
+   *
+   * \tparam M The matrix type to operate on
+   * \tparam X Type of the update
+   * \tparam Y Type of the defect
+   * \tparam P Type of the local preconditioner, it has to be constructible
+   *           from the local matrix and a ParameterTree.
+   */
+  template<class M, class X, class Y, class P = SeqILU<M,X,Y> >
+  class SeqBlockJacobi : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The type of the local preconditioners.
+    typedef P local_preconditioner_type;
+    //! \brief The type for the row indices.
+    typedef typename matrix_type::size_type size_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param blocks The number of subdomains.
+       \param overlap The number of layers of rows added to each subdomain.
+       \param localConfig The ParameterTree the local preconditioners are constructed with.
+     */
+    SeqBlockJacobi (const M& A, int blocks, int overlap, const ParameterTree& localConfig = ParameterTree())
+      : A_(A)
+    {
+      if (blocks < 1 || overlap < 0)
+        DUNE_THROW(ISTLError, "block Jacobi needs at least one block and a nonnegative overlap");
+
+      const size_type n = A.N();
+      const size_type nBlocks = std::max(std::min(size_type(blocks), n), size_type(1));
+      subdomains_.resize(nBlocks);
+
+      std::vector<std::exception_ptr> errors(nBlocks);
+      Impl::parallelFor(size_type(0), nBlocks, [&](size_type k){
+          try {
+            setupSubdomain(subdomains_[k], k*n/nBlocks, (k+1)*n/nBlocks, overlap, localConfig);
+          }
+          catch (...) {
+            errors[k] = std::current_exception();
+          }
+        }, 1);
+      rethrow(errors);
+    }
+
+    /*!
+      \brief Constructor.
+
+      \param A The assembled linear operator to use.
+      \param configuration ParameterTree containing preconditioner parameters.
+
+      ParameterTree Key | Meaning
+      ------------------|------------
+      blocks            | The number of subdomains. default=number of threads
+      overlap           | The number of layers of rows added to each subdomain. default=0
+      local             | Subtree with the parameters of the local preconditioners.
+
+      See \ref ISTL_Factory for the ParameterTree layout and examples.
+    */
+    SeqBlockJacobi (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqBlockJacobi(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       blocks            | The number of subdomains. default=number of threads
+       overlap           | The number of layers of rows added to each subdomain. default=0
+       local             | Subtree with the parameters of the local preconditioners.
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqBlockJacobi (const M& A, const ParameterTree& configuration)
+      : SeqBlockJacobi(A, configuration.get<int>("blocks", Impl::threadCount()),
+                       configuration.get<int>("overlap", 0),
+                       configuration.sub("local"))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+      DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      Impl::parallelFor(size_type(0), size_type(subdomains_.size()), [&](size_type k){
+          Subdomain& subdomain = subdomains_[k];
+          for (size_type i = 0; i < subdomain.rows.size(); ++i)
+            subdomain.d[i] = d[subdomain.rows[i]];
+          subdomain.v = 0;
+          subdomain.preconditioner->apply(subdomain.v, subdomain.d);
+          for (size_type i = subdomain.ownedBegin; i < subdomain.ownedEnd; ++i)
+            v[subdomain.rows[i]] = subdomain.v[i];
+        }, 1);
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Copies the values of the matrix into the local matrices and updates
+       the local preconditioners.
+     */
+    virtual void update ()
+    {
+      std::vector<std::exception_ptr> errors(subdomains_.size());
+      Impl::parallelFor(size_type(0), size_type(subdomains_.size()), [&](size_type k){
+          try {
+            copyValues(subdomains_[k]);
+            subdomains_[k].preconditioner->update();
+          }
+          catch (...) {
+            errors[k] = std::current_exception();
+          }
+        }, 1);
+      rethrow(errors);
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  private:
+    struct Subdomain
+    {
+      //! the sorted global indices of the rows
+      std::vector<size_type> rows;
+      //! the local indices of the rows owned by the subdomain
+      size_type ownedBegin, ownedEnd;
+      //! the restriction of the matrix to the rows
+      matrix_type A;
+      std::unique_ptr<P> preconditioner;
+      X v;
+      Y d;
+    };
+
+    void setupSubdomain (Subdomain& subdomain, size_type begin, size_type end,
+                         int overlap, const ParameterTree& localConfig)
+    {
+      std::vector<size_type>& rows = subdomain.rows;
+      for (size_type i = begin; i < end; ++i)
+        rows.push_back(i);
+
+      for (int layer = 0; layer < overlap; ++layer)
+      {
+        const size_type size = rows.size();
+        for (size_type i = 0; i < size; ++i)
+          for (auto j = A_[rows[i]].begin(); j != A_[rows[i]].end(); ++j)
+            rows.push_back(j.index());
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+      }
+
+      subdomain.ownedBegin = std::lower_bound(rows.begin(), rows.end(), begin) - rows.begin();
+      subdomain.ownedEnd = subdomain.ownedBegin + (end - begin);
+
+      // the couplings between the rows of the subdomain
+      const size_type m = rows.size();
+      subdomain.A.setBuildMode(matrix_type::row_wise);
+      subdomain.A.setSize(m, m);
+      for (auto row = subdomain.A.createbegin(); row != subdomain.A.createend(); ++row)
+        for (auto j = A_[rows[row.index()]].begin(); j != A_[rows[row.index()]].end(); ++j)
+        {
+          auto local = std::lower_bound(rows.begin(), rows.end(), j.index());
+          if (local != rows.end() && *local == j.index())
+            row.insert(local - rows.begin());
+        }
+      copyValues(subdomain);
+
+      subdomain.v.resize(m);
+      subdomain.d.resize(m);
+      subdomain.preconditioner = std::make_unique<P>(subdomain.A, localConfig);
+    }
+
+    void copyValues (Subdomain& subdomain) const
+    {
+      for (auto row = subdomain.A.begin(); row != subdomain.A.end(); ++row)
+      {
+        auto ij = A_[subdomain.rows[row.index()]].begin();
+        for (auto col = row->begin(); col != row->end(); ++col)
+        {
+          while (ij.index() != subdomain.rows[col.index()])
+            ++ij;
+          *col = *ij;
+        }
+      }
+    }
+
+    static void rethrow (const std::vector<std::exception_ptr>& errors)
+    {
+      for (const auto& error : errors)
+        if (error)
+          std::rethrow_exception(error);
+    }
+
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The subdomains, their local matrices must not be moved after construction.
+    std::vector<Subdomain> subdomains_;
+  };
+  DUNE_REGISTER_PRECONDITIONER("blockjacobi", [](auto tl, const auto& op, const ParameterTree& config){
+                                                using M = typename Dune::TypeListElement<0, decltype(tl)>::type;
+                                                using D = typename Dune::TypeListElement<1, decltype(tl)>::type;
+                                                using R = typename Dune::TypeListElement<2, decltype(tl)>::type;
+                                                std::shared_ptr<Dune::Preconditioner<D,R>> preconditioner;
+                                                const std::string local = config.get<std::string>("local.type", "ilu");
+                                                if (local == "ilu")
+                                                  preconditioner = std::make_shared<SeqBlockJacobi<M,D,R,SeqILU<M,D,R>>>(op, config);
+                                                else if (local == "ildl")
+                                                  preconditioner = std::make_shared<SeqBlockJacobi<M,D,R,SeqILDL<M,D,R>>>(op, config);
+                                                else
+                                                  DUNE_THROW(Dune::Exception, "Unknown local preconditioner for block Jacobi: " << local);
+                                                return preconditioner;
+                                              });
 
   /** @} end documentation */
 
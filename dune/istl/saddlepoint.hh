@@ -0,0 +1,328 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_SADDLEPOINT_HH
+#define DUNE_ISTL_SADDLEPOINT_HH
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/indices.hh>
+#include <dune/common/scalarmatrixview.hh>
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/shared_ptr.hh>
+
+#include <dune/istl/common/threading.hh>
+
+#include "gsetc.hh"
+#include "istlexception.hh"
+#include "preconditioner.hh"
+#include "solvercategory.hh"
+
+/** \file
+ * \brief Block preconditioners for saddle point problems stored as
+ *        2x2 MultiTypeBlockMatrix.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Prec
+          @{
+   */
+
+  /**
+   * \brief Approximate the Schur complement \f$S = D - C\,\mathrm{diag}(A)^{-1}B\f$.
+   *
+   * The matrix M is the 2x2 MultiTypeBlockMatrix \f$\begin{pmatrix}A & B\\ C & D\end{pmatrix}\f$
+   * and diag(A) the block diagonal of A. If S is empty its sparsity pattern is
+   * set up as the union of the patterns of D and \f$CB\f$, otherwise only the
+   * values are recomputed on the existing pattern.
+   *
+   * \throws MatrixBlockError if a diagonal block of A is singular.
+   */
+  template<class M, class S>
+  void diagonalSchurComplement (const M& matrix, S& schur)
+  {
+    using namespace Dune::Indices;
+    typedef typename S::size_type size_type;
+
+    const auto& A = matrix[_0][_0];
+    const auto& B = matrix[_0][_1];
+    const auto& C = matrix[_1][_0];
+    const auto& D = matrix[_1][_1];
+
+    typedef std::decay_t<decltype(A)> matrix_A_type;
+    static_assert(InverseBlockDiagonal<matrix_A_type>::cached,
+                  "the diagonal blocks of A have to be invertible");
+    InverseBlockDiagonal<matrix_A_type> invDiag;
+    invDiag.compute(A);
+
+    if (schur.N() == 0)
+    {
+      schur.setBuildMode(S::row_wise);
+      schur.setSize(D.N(), D.M());
+      std::vector<size_type> cols;
+      for (auto row = schur.createbegin(); row != schur.createend(); ++row)
+      {
+        cols.clear();
+        for (auto j = D[row.index()].begin(); j != D[row.index()].end(); ++j)
+          cols.push_back(j.index());
+        for (auto k = C[row.index()].begin(); k != C[row.index()].end(); ++k)
+          for (auto j = B[k.index()].begin(); j != B[k.index()].end(); ++j)
+            cols.push_back(j.index());
+        std::sort(cols.begin(), cols.end());
+        cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+        for (size_type j : cols)
+          row.insert(j);
+      }
+    }
+
+    schur = 0;
+    for (auto i = D.begin(); i != D.end(); ++i)
+      for (auto j = i->begin(); j != i->end(); ++j)
+        schur[i.index()][j.index()] = *j;
+
+    Impl::parallelFor(size_type(0), C.N(), [&](size_type i){
+        auto&& schurRow = schur[i];
+        for (auto k = C[i].begin(); k != C[i].end(); ++k)
+        {
+          const auto& Cik = Impl::asMatrix(*k);
+          const auto& Dk = Impl::asMatrix(invDiag[k.index()]);
+          for (auto j = B[k.index()].begin(); j != B[k.index()].end(); ++j)
+          {
+            const auto& Bkj = Impl::asMatrix(*j);
+            auto&& Sij = Impl::asMatrix(*schurRow.find(j.index()));
+            // S_ij -= C_ik D_k^{-1} B_kj
+            for (size_type r = 0; r < Cik.N(); ++r)
+              for (size_type m = 0; m < Dk.N(); ++m)
+              {
+                typename S::field_type CD = 0;
+                for (size_type l = 0; l < Dk.N(); ++l)
+                  CD += Cik[r][l] * Dk[l][m];
+                for (size_type c = 0; c < Bkj.M(); ++c)
+                  Sij[r][c] -= CD * Bkj[m][c];
+              }
+          }
+        }
+      });
+  }
+
+  /**
+   * \brief The variants of the SaddlePointPreconditioner.
+   *
+   * For the matrix \f$\begin{pmatrix}A & B\\ C & D\end{pmatrix}\f$ and an
+   * approximation S of its Schur complement the variants apply the inverse of
+   *  - blockDiagonal: \f$\begin{pmatrix}A & 0\\ 0 & S\end{pmatrix}\f$,
+   *  - blockUpperTriangular: \f$\begin{pmatrix}A & B\\ 0 & S\end{pmatrix}\f$,
+   *  - simple: \f$\begin{pmatrix}A & 0\\ C & S\end{pmatrix}
+   *    \begin{pmatrix}I & \mathrm{diag}(A)^{-1}B\\ 0 & I\end{pmatrix}\f$,
+   *
+   * where the inverses of A and S are replaced by the given preconditioners.
+   */
+  struct SaddlePointVariant
+  {
+    enum Variant {
+      blockDiagonal,
+      blockUpperTriangular,
+      simple
+    };
+  };
+
+  /**
+   * \brief Block preconditioner for saddle point problems.
+   *
+   * The matrix is a 2x2 MultiTypeBlockMatrix
+   * \f$\begin{pmatrix}A & B\\ C & D\end{pmatrix}\f$, e.g. from a Stokes or
+   * Darcy problem, and the vectors are MultiTypeBlockVectors with two
+   * blocks. The preconditioner combines a preconditioner for A and one for
+   * an approximation S of the Schur complement, see SaddlePointVariant.
+   * A common choice for S is diagonalSchurComplement.
+   *
+   * For blockDiagonal both preconditioners are applied concurrently if
+   * threads are enabled.
+   *
+   * \tparam M The type of the MultiTypeBlockMatrix.
+   * \tparam X The type of the update.
+   * \tparam Y The type of the defect.
+   */
+  template<class M, class X, class Y = X>
+  class SaddlePointPreconditioner : public Preconditioner<X,Y> {
+    static_assert(M::N() == 2 && M::M() == 2, "SaddlePointPreconditioner needs a 2x2 MultiTypeBlockMatrix");
+
+    typedef std::decay_t<decltype(std::declval<X&>()[Indices::_0])> X0;
+    typedef std::decay_t<decltype(std::declval<X&>()[Indices::_1])> X1;
+    typedef std::decay_t<decltype(std::declval<Y&>()[Indices::_0])> Y0;
+    typedef std::decay_t<decltype(std::declval<Y&>()[Indices::_1])> Y1;
+
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The type of the preconditioner for the first diagonal block.
+    typedef Preconditioner<X0,Y0> preconditioner_A_type;
+    //! \brief The type of the preconditioner for the Schur complement.
+    typedef Preconditioner<X1,Y1> preconditioner_S_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param precA The preconditioner for the first diagonal block.
+       \param precS The preconditioner for the approximate Schur complement.
+       \param variant The variant of the block preconditioner.
+     */
+    SaddlePointPreconditioner (const M& A, preconditioner_A_type& precA, preconditioner_S_type& precS,
+                               SaddlePointVariant::Variant variant = SaddlePointVariant::blockUpperTriangular)
+      : SaddlePointPreconditioner(A, stackobject_to_shared_ptr(precA), stackobject_to_shared_ptr(precS), variant)
+    {}
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param precA The preconditioner for the first diagonal block.
+       \param precS The preconditioner for the approximate Schur complement.
+       \param variant The variant of the block preconditioner.
+     */
+    SaddlePointPreconditioner (const M& A,
+                               const std::shared_ptr<preconditioner_A_type>& precA,
+                               const std::shared_ptr<preconditioner_S_type>& precS,
+                               SaddlePointVariant::Variant variant = SaddlePointVariant::blockUpperTriangular)
+      : A_(A), precA_(precA), precS_(precS), variant_(variant)
+    {
+      using namespace Dune::Indices;
+      if (variant_ == SaddlePointVariant::simple)
+        invDiag_.compute(A_[_0][_0]);
+    }
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre (X& x, Y& b)
+    {
+      using namespace Dune::Indices;
+      precA_->pre(x[_0], b[_0]);
+      precS_->pre(x[_1], b[_1]);
+    }
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      using namespace Dune::Indices;
+      const auto& B = A_[_0][_1];
+      const auto& C = A_[_1][_0];
+
+      switch (variant_)
+      {
+      case SaddlePointVariant::blockDiagonal :
+      {
+        // the two blocks are independent, exceptions may not leave the threaded loop
+        std::array<std::exception_ptr,2> errors;
+        Impl::parallelFor(0, 2, [&](int block){
+            try {
+              if (block == 0)
+                precA_->apply(v[_0], d[_0]);
+              else
+                precS_->apply(v[_1], d[_1]);
+            }
+            catch (...) {
+              errors[block] = std::current_exception();
+            }
+          }, 1);
+        for (const auto& error : errors)
+          if (error)
+            std::rethrow_exception(error);
+        break;
+      }
+
+      case SaddlePointVariant::blockUpperTriangular :
+        // v1 = S^{-1} d1, v0 = A^{-1}(d0 - B v1)
+        precS_->apply(v[_1], d[_1]);
+        r0_ = d[_0];
+        B.mmv(v[_1], r0_);
+        precA_->apply(v[_0], r0_);
+        break;
+
+      case SaddlePointVariant::simple :
+        // v0* = A^{-1} d0, v1 = S^{-1}(d1 - C v0*), v0 = v0* - diag(A)^{-1} B v1
+        precA_->apply(v[_0], d[_0]);
+        r1_ = d[_1];
+        C.mmv(v[_0], r1_);
+        precS_->apply(v[_1], r1_);
+        r0_ = d[_0];
+        B.mv(v[_1], r0_);
+        for (std::size_t i = 0; i < r0_.size(); ++i)
+          Impl::asMatrix(invDiag_[i]).mmv(Impl::asVector(r0_[i]), Impl::asVector(v[_0][i]));
+        break;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post (X& x)
+    {
+      using namespace Dune::Indices;
+      precA_->post(x[_0]);
+      precS_->post(x[_1]);
+    }
+
+    /*!
+       \brief Update the preconditioner.
+
+       Updates both preconditioners, the matrix of the Schur complement
+       approximation has to be updated before, e.g. by diagonalSchurComplement.
+     */
+    virtual void update ()
+    {
+      using namespace Dune::Indices;
+      if (variant_ == SaddlePointVariant::simple)
+        invDiag_.compute(A_[_0][_0]);
+      precA_->update();
+      precS_->update();
+    }
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+  private:
+    typedef std::decay_t<decltype(std::declval<const M&>()[Indices::_0][Indices::_0])> matrix_A_type;
+
+    //! \brief The matrix we operate on.
+    const M& A_;
+    //! \brief The preconditioner for the first diagonal block.
+    std::shared_ptr<preconditioner_A_type> precA_;
+    //! \brief The preconditioner for the Schur complement.
+    std::shared_ptr<preconditioner_S_type> precS_;
+    //! \brief The variant of the block preconditioner.
+    SaddlePointVariant::Variant variant_;
+    //! \brief The inverted diagonal blocks of the first diagonal block, only used by simple.
+    InverseBlockDiagonal<matrix_A_type> invDiag_;
+    //! \brief Temporaries for the right hand sides of the blocks.
+    Y0 r0_;
+    Y1 r1_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
@@ -3,21 +3,40 @@
 #ifndef DUNE_ISTL_SCALARPRODUCTS_HH
 #define DUNE_ISTL_SCALARPRODUCTS_HH
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/shared_ptr.hh>
+#include <dune/common/parallel/future.hh>
+#include <dune/common/simd/simd.hh>
 
 #include "bvector.hh"
 #include "solvercategory.hh"
 
 
 namespace Dune {
+
+  namespace Impl {
+
+    //! Whether the vector type provides the fused multi-dot kernel mdot
+    template<class X, class = void>
+    struct HasMDot : std::false_type {};
+
+    template<class X>
+    struct HasMDot<X, std::void_t<decltype(std::declval<const X&>().mdot(std::declval<const std::vector<const X*>&>()))> >
+      : std::true_type {};
+
+  } // end namespace Impl
+
   /**
    * @defgroup ISTL_SP Scalar products
    * @ingroup ISTL_Solvers
@@ -71,6 +90,44 @@ namespace Dune {
       return x.two_norm();
     }
 
+    /*! \brief Start the computation of several dot products.
+
+       Computes the dot products of x[k] and y[k] for all k. Parallel
+       scalar products sum the local contributions in a single non-blocking
+       reduction, so the communication can be overlapped with other work
+       until the result is requested from the returned future. The vectors
+       must not be changed before.
+     */
+    virtual Future<std::vector<field_type> > idot (const std::vector<const X*>& x, const std::vector<const X*>& y) const
+    {
+      std::vector<field_type> result(x.size());
+      for (std::size_t k=0; k<x.size(); k++)
+        result[k] = dot(*x[k],*y[k]);
+      return PseudoFuture<std::vector<field_type> >(std::move(result));
+    }
+
+    /*! \brief Block dot product of two multi-vectors.
+
+       For a SIMD field type the lanes are interpreted as the columns of
+       multi-vectors, e.g. for several right hand sides. Returns the matrix
+       of the scalar products of all columns, entry a*lanes+b is the product
+       of column a of x and column b of y. Parallel scalar products sum the
+       whole matrix in a single reduction. For scalar field types this is
+       the dot product.
+     */
+    virtual std::vector<Simd::Scalar<field_type> > blockDot (const X& x, const X& y) const
+    {
+      constexpr std::size_t lanes = Simd::lanes<field_type>();
+      if constexpr (lanes == 1)
+        return { Simd::lane(0,dot(x,y)) };
+      else
+      {
+        std::vector<Simd::Scalar<field_type> > result(lanes*lanes, 0);
+        Imp::addLaneGram<field_type>(result, x, y, 1);
+        return result;
+      }
+    }
+
     //! Category of the scalar product (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -149,6 +206,27 @@ namespace Dune {
       return _communication->norm(x);
     }
 
+    /*! \brief Start the computation of several dot products.
+       The vectors must be consistent on the interior+border partition, the
+       local contributions are summed in a single non-blocking reduction.
+     */
+    virtual Future<std::vector<field_type> > idot (const std::vector<const X*>& x, const std::vector<const X*>& y) const override
+    {
+      return _communication->template idot<X,field_type>(x,y);
+    }
+
+    /*! \brief Block dot product of two multi-vectors.
+       The vectors must be consistent on the interior+border partition, the
+       local scalar products of all columns are summed in a single reduction.
+     */
+    virtual std::vector<Simd::Scalar<field_type> > blockDot (const X& x, const X& y) const override
+    {
+      if constexpr (Simd::lanes<field_type>() == 1)
+        return { Simd::lane(0,dot(x,y)) };
+      else
+        return _communication->template blockDot<X>(x,y);
+    }
+
     //! Category of the scalar product (see SolverCategory::Category)
     virtual SolverCategory::Category category() const override
     {
@@ -165,6 +243,37 @@ namespace Dune {
   class SeqScalarProduct : public ScalarProduct<X>
   {
     using ScalarProduct<X>::ScalarProduct;
+
+  public:
+    typedef typename ScalarProduct<X>::field_type field_type;
+
+    /*! \brief Start the computation of several dot products.
+
+       If X provides the fused kernel mdot, e.g. the BlockVector, consecutive
+       products with the same second vector are computed in a single sweep
+       over the vectors.
+     */
+    virtual Future<std::vector<field_type> > idot (const std::vector<const X*>& x, const std::vector<const X*>& y) const override
+    {
+      if constexpr (Impl::HasMDot<X>::value)
+      {
+        std::vector<field_type> result(x.size());
+        std::vector<const X*> left;
+        for (std::size_t k=0; k<x.size(); )
+        {
+          std::size_t end = k+1;
+          while (end<x.size() && y[end]==y[k])
+            ++end;
+          left.assign(x.begin()+k, x.begin()+end);
+          auto dots = y[k]->mdot(left);
+          std::copy(dots.begin(), dots.end(), result.begin()+k);
+          k = end;
+        }
+        return PseudoFuture<std::vector<field_type> >(std::move(result));
+      }
+      else
+        return ScalarProduct<X>::idot(x,y);
+    }
   };
 
   /**
@@ -225,7 +334,7 @@ namespace Dune {
     {
       case SolverCategory::sequential:
         return
-          std::make_shared<ScalarProduct<X>>();
+          std::make_shared<SeqScalarProduct<X>>();
       default:
         return
           std::make_shared<ParallelScalarProduct<X,Comm>>(comm,category);
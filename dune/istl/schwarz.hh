@@ -230,6 +230,13 @@ namespace Dune {
      */
     virtual void post (X& x) {}
 
+    /*!
+       \brief Update the preconditioner.
+
+       Nothing to recompute, the matrix is used directly in each application.
+     */
+    virtual void update () {}
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -358,6 +365,26 @@ namespace Dune {
       _preconditioner->post(x);
     }
 
+    /*!
+       \brief Update the preconditioner.
+
+       \copydoc Preconditioner::update()
+     */
+    virtual void update ()
+    {
+      _preconditioner->update();
+    }
+
+    /*!
+       \brief Forward the progress of the outer iteration.
+
+       \copydoc Preconditioner::setOuterDefect(double,double)
+     */
+    virtual void setOuterDefect (double relativeDefect, double reduction)
+    {
+      _preconditioner->setOuterDefect(relativeDefect, reduction);
+    }
+
     //! Category of the preconditioner (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -4,10 +4,14 @@
 #ifndef DUNE_ISTL_SOLVER_HH
 #define DUNE_ISTL_SOLVER_HH
 
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <functional>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/shared_ptr.hh>
@@ -59,6 +63,16 @@ namespace Dune
       conv_rate = 1;
       elapsed = 0;
       condition_estimate = -1;
+      min_eigenvalue_estimate = -1;
+      max_eigenvalue_estimate = -1;
+      residual_history.clear();
+      operator_applications = 0;
+      preconditioner_applications = 0;
+      reductions = 0;
+      operator_time = 0;
+      preconditioner_time = 0;
+      reduction_time = 0;
+      update_time = 0;
     }
 
     /** \brief Number of iterations */
@@ -76,10 +90,309 @@ namespace Dune
     /** \brief Estimate of condition number */
     double condition_estimate = -1;
 
+    /** \brief Estimate of the smallest eigenvalue magnitude of the preconditioned operator, -1 if not computed
+     *
+     * Computed from the Lanczos or Arnoldi coefficients of the solver
+     * without additional operator applications.
+     */
+    double min_eigenvalue_estimate = -1;
+
+    /** \brief Estimate of the largest eigenvalue magnitude of the preconditioned operator, -1 if not computed */
+    double max_eigenvalue_estimate = -1;
+
     /** \brief Elapsed time in seconds */
     double elapsed;
+
+    /** \name Instrumentation
+     *
+     * Only collected by iterative solvers with enabled instrumentation, see
+     * IterativeSolver::setInstrumentation().
+     * @{
+     */
+
+    /** \brief Defect norm of every iteration, starting with the initial defect */
+    std::vector<double> residual_history;
+
+    /** \brief Number of applications of the operator (sparse matrix-vector products) */
+    int operator_applications;
+
+    /** \brief Number of applications of the preconditioner */
+    int preconditioner_applications;
+
+    /** \brief Number of scalar products and norms, fused ones count once */
+    int reductions;
+
+    /** \brief Time spent in the operator in seconds */
+    double operator_time;
+
+    /** \brief Time spent in the preconditioner in seconds */
+    double preconditioner_time;
+
+    /** \brief Time spent in scalar products and norms in seconds */
+    double reduction_time;
+
+    /** \brief Remaining time of the solver in seconds, mostly vector updates */
+    double update_time;
+
+    /** @} */
+
+    /** \brief Write the statistics as a JSON object */
+    void writeJSON (std::ostream& s) const
+    {
+      auto number = [&](double value) {
+        if (std::isfinite(value))
+          s << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+        else
+          s << "null";
+      };
+      auto field = [&](const char* name, double value) {
+        s << "\"" << name << "\": ";
+        number(value);
+        s << ", ";
+      };
+      const auto flags = s.flags();
+      const auto precision = s.precision();
+      s << "{\"iterations\": " << iterations << ", ";
+      s << "\"converged\": " << (converged ? "true" : "false") << ", ";
+      field("reduction", reduction);
+      field("conv_rate", conv_rate);
+      field("condition_estimate", condition_estimate);
+      field("min_eigenvalue_estimate", min_eigenvalue_estimate);
+      field("max_eigenvalue_estimate", max_eigenvalue_estimate);
+      field("elapsed", elapsed);
+      s << "\"operator_applications\": " << operator_applications << ", ";
+      s << "\"preconditioner_applications\": " << preconditioner_applications << ", ";
+      s << "\"reductions\": " << reductions << ", ";
+      field("operator_time", operator_time);
+      field("preconditioner_time", preconditioner_time);
+      field("reduction_time", reduction_time);
+      field("update_time", update_time);
+      s << "\"residual_history\": [";
+      for (std::size_t i=0; i<residual_history.size(); ++i)
+      {
+        if (i > 0)
+          s << ", ";
+        number(residual_history[i]);
+      }
+      s << "]}";
+      s.flags(flags);
+      s.precision(precision);
+    }
   };
 
+  namespace Impl {
+
+    //! counters and timers shared by the instrumented parts of an iterative solver
+    struct SolverInstrumentation
+    {
+      int operatorApplications = 0;
+      int preconditionerApplications = 0;
+      int reductions = 0;
+      double operatorTime = 0;
+      double preconditionerTime = 0;
+      double reductionTime = 0;
+
+      void clear ()
+      {
+        *this = SolverInstrumentation();
+      }
+    };
+
+    //! linear operator measuring the time of the wrapped one
+    template<class X, class Y>
+    class InstrumentedOperator : public LinearOperator<X,Y>
+    {
+    public:
+      typedef typename LinearOperator<X,Y>::field_type field_type;
+
+      InstrumentedOperator (std::shared_ptr<LinearOperator<X,Y>> op, std::shared_ptr<SolverInstrumentation> stats)
+        : _op(op), _stats(stats)
+      {}
+
+      virtual void apply (const X& x, Y& y) const
+      {
+        Timer watch;
+        _op->apply(x,y);
+        _stats->operatorTime += watch.elapsed();
+        ++_stats->operatorApplications;
+      }
+
+      virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const
+      {
+        Timer watch;
+        _op->applyscaleadd(alpha,x,y);
+        _stats->operatorTime += watch.elapsed();
+        ++_stats->operatorApplications;
+      }
+
+      virtual SolverCategory::Category category() const
+      {
+        return _op->category();
+      }
+
+      std::shared_ptr<LinearOperator<X,Y>> wrapped () const
+      {
+        return _op;
+      }
+
+    private:
+      std::shared_ptr<LinearOperator<X,Y>> _op;
+      std::shared_ptr<SolverInstrumentation> _stats;
+    };
+
+    //! preconditioner measuring the time of the wrapped one
+    template<class X, class Y>
+    class InstrumentedPreconditioner : public Preconditioner<X,Y>
+    {
+    public:
+      InstrumentedPreconditioner (std::shared_ptr<Preconditioner<X,Y>> prec, std::shared_ptr<SolverInstrumentation> stats)
+        : _prec(prec), _stats(stats)
+      {}
+
+      virtual void pre (X& x, Y& b)
+      {
+        Timer watch;
+        _prec->pre(x,b);
+        _stats->preconditionerTime += watch.elapsed();
+      }
+
+      virtual void apply (X& v, const Y& d)
+      {
+        Timer watch;
+        _prec->apply(v,d);
+        _stats->preconditionerTime += watch.elapsed();
+        ++_stats->preconditionerApplications;
+      }
+
+      virtual void post (X& x)
+      {
+        Timer watch;
+        _prec->post(x);
+        _stats->preconditionerTime += watch.elapsed();
+      }
+
+      virtual void update ()
+      {
+        _prec->update();
+      }
+
+      virtual void setOuterDefect (double relativeDefect, double reduction)
+      {
+        _prec->setOuterDefect(relativeDefect, reduction);
+      }
+
+      virtual SolverCategory::Category category() const
+      {
+        return _prec->category();
+      }
+
+      std::shared_ptr<Preconditioner<X,Y>> wrapped () const
+      {
+        return _prec;
+      }
+
+    private:
+      std::shared_ptr<Preconditioner<X,Y>> _prec;
+      std::shared_ptr<SolverInstrumentation> _stats;
+    };
+
+    //! scalar product measuring the time of the wrapped one
+    template<class X>
+    class InstrumentedScalarProduct : public ScalarProduct<X>
+    {
+    public:
+      typedef typename ScalarProduct<X>::field_type field_type;
+      typedef typename ScalarProduct<X>::real_type real_type;
+
+      InstrumentedScalarProduct (std::shared_ptr<ScalarProduct<X>> sp, std::shared_ptr<SolverInstrumentation> stats)
+        : _sp(sp), _stats(stats)
+      {}
+
+      virtual field_type dot (const X& x, const X& y) const
+      {
+        Timer watch;
+        field_type result = _sp->dot(x,y);
+        _stats->reductionTime += watch.elapsed();
+        ++_stats->reductions;
+        return result;
+      }
+
+      virtual real_type norm (const X& x) const
+      {
+        Timer watch;
+        real_type result = _sp->norm(x);
+        _stats->reductionTime += watch.elapsed();
+        ++_stats->reductions;
+        return result;
+      }
+
+      virtual Future<std::vector<field_type> > idot (const std::vector<const X*>& x, const std::vector<const X*>& y) const
+      {
+        Timer watch;
+        Future<std::vector<field_type> > result = _sp->idot(x,y);
+        _stats->reductionTime += watch.elapsed();
+        ++_stats->reductions;
+        // the time of waiting for the result belongs to the reduction as well
+        return TimedFuture{std::move(result), _stats};
+      }
+
+      virtual std::vector<Simd::Scalar<field_type> > blockDot (const X& x, const X& y) const
+      {
+        Timer watch;
+        auto result = _sp->blockDot(x,y);
+        _stats->reductionTime += watch.elapsed();
+        ++_stats->reductions;
+        return result;
+      }
+
+      virtual SolverCategory::Category category() const
+      {
+        return _sp->category();
+      }
+
+      std::shared_ptr<ScalarProduct<X>> wrapped () const
+      {
+        return _sp;
+      }
+
+    private:
+      struct TimedFuture
+      {
+        Future<std::vector<field_type> > future;
+        std::shared_ptr<SolverInstrumentation> stats;
+
+        void wait ()
+        {
+          Timer watch;
+          future.wait();
+          stats->reductionTime += watch.elapsed();
+        }
+
+        bool ready () const
+        {
+          return future.ready();
+        }
+
+        bool valid () const
+        {
+          return future.valid();
+        }
+
+        std::vector<field_type> get ()
+        {
+          Timer watch;
+          auto result = future.get();
+          stats->reductionTime += watch.elapsed();
+          return result;
+        }
+      };
+
+      std::shared_ptr<ScalarProduct<X>> _sp;
+      std::shared_ptr<SolverInstrumentation> _stats;
+    };
+
+  } // end namespace Impl
+
 
   //=====================================================================
   /*!
@@ -282,6 +595,7 @@ namespace Dune
        reduction         | The relative defect reduction to achieve when applying the operator
        maxit             | The maximum number of iteration steps allowed when applying the operator
        verbose           | The verbosity level
+       instrumentation   | Collect the residual history and a timing breakdown, see setInstrumentation(). default=false
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
@@ -290,7 +604,9 @@ namespace Dune
         configuration.get<real_type>("reduction"),
         configuration.get<int>("maxit"),
         configuration.get<int>("verbose"))
-    {}
+    {
+      setInstrumentation(configuration.get<bool>("instrumentation", false));
+    }
 
     /*!
        \brief Constructor.
@@ -305,6 +621,7 @@ namespace Dune
        reduction         | The relative defect reduction to achieve when applying the operator
        maxit             | The maximum number of iteration steps allowed when applying the operator
        verbose           | The verbosity level
+       instrumentation   | Collect the residual history and a timing breakdown, see setInstrumentation(). default=false
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
@@ -313,7 +630,9 @@ namespace Dune
         configuration.get<scalar_real_type>("reduction"),
         configuration.get<int>("maxit"),
         configuration.get<int>("verbose"))
-    {}
+    {
+      setInstrumentation(configuration.get<bool>("instrumentation", false));
+    }
 
     /**
         \brief General constructor to initialize an iterative solver
@@ -388,6 +707,34 @@ namespace Dune
       return name.substr(0, name.find("<"));
     }
 
+    /*!
+       \brief Enable or disable the detailed instrumentation.
+
+       If enabled, the operator, the preconditioner and the scalar product
+       are wrapped to count their applications and to measure the time spent
+       in them. Each apply then records the defect of every iteration and
+       this breakdown in the InverseOperatorResult, the remaining time is
+       reported as update_time. The cost is a timer call per wrapped
+       operation.
+     */
+    void setInstrumentation (bool enable)
+    {
+      if (enable && !_instrumentation)
+      {
+        _instrumentation = std::make_shared<Impl::SolverInstrumentation>();
+        _op = std::make_shared<Impl::InstrumentedOperator<X,Y>>(_op, _instrumentation);
+        _prec = std::make_shared<Impl::InstrumentedPreconditioner<X,Y>>(_prec, _instrumentation);
+        _sp = std::make_shared<Impl::InstrumentedScalarProduct<X>>(_sp, _instrumentation);
+      }
+      else if (!enable && _instrumentation)
+      {
+        _op = std::static_pointer_cast<Impl::InstrumentedOperator<X,Y>>(_op)->wrapped();
+        _prec = std::static_pointer_cast<Impl::InstrumentedPreconditioner<X,Y>>(_prec)->wrapped();
+        _sp = std::static_pointer_cast<Impl::InstrumentedScalarProduct<X>>(_sp)->wrapped();
+        _instrumentation = nullptr;
+      }
+    }
+
       /*!
      \brief Class for controlling iterative methods
 
@@ -415,6 +762,8 @@ namespace Dune
         , _valid(true)
       {
         res.clear();
+        if(_parent._instrumentation)
+          _parent._instrumentation->clear();
         if(_parent._verbose>0){
           std::cout << "=== " << parent.name() << std::endl;
           if(_parent._verbose > 1)
@@ -462,6 +811,8 @@ namespace Dune
         }
         if(i == 0)
           _def0 = def;
+        if(_parent._instrumentation)
+          _res.residual_history.push_back(static_cast<double>(Simd::max(def)));
         if(_parent._verbose > 1){
           if(i!=0)
             _parent.printOutput(std::cout,i,def,_def);
@@ -481,6 +832,19 @@ namespace Dune
         _res.reduction = static_cast<double>(Simd::max(_def/_def0));
         _res.conv_rate  = pow(_res.reduction,1.0/_i);
         _res.elapsed = _watch.elapsed();
+        if(_parent._instrumentation)
+        {
+          const Impl::SolverInstrumentation& stats = *_parent._instrumentation;
+          _res.operator_applications = stats.operatorApplications;
+          _res.preconditioner_applications = stats.preconditionerApplications;
+          _res.reductions = stats.reductions;
+          _res.operator_time = stats.operatorTime;
+          _res.preconditioner_time = stats.preconditionerTime;
+          _res.reduction_time = stats.reductionTime;
+          using std::max;
+          _res.update_time = max(0.0, _res.elapsed - stats.operatorTime
+                                 - stats.preconditionerTime - stats.reductionTime);
+        }
         if (_parent._verbose>0)                 // final print
           {
             std::cout << "=== rate=" << _res.conv_rate
@@ -506,6 +870,7 @@ namespace Dune
     int _maxit;
     int _verbose;
     SolverCategory::Category _category;
+    std::shared_ptr<Impl::SolverInstrumentation> _instrumentation;
   };
 
   /**
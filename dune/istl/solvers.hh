@@ -4,15 +4,20 @@
 #ifndef DUNE_ISTL_SOLVERS_HH
 #define DUNE_ISTL_SOLVERS_HH
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <random>
+#include <string>
 #include <type_traits>
 #include <vector>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/math.hh>
 #include <dune/common/simd/io.hh>
 #include <dune/common/simd/simd.hh>
@@ -183,6 +188,248 @@ namespace Dune {
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("gradientsolver", defaultIterativeSolverCreator<Dune::GradientSolver>());
 
+  namespace Impl {
+
+    /*!
+       \brief Compute the eigenvalues of a small upper Hessenberg matrix.
+
+       Uses the shifted QR algorithm with Wilkinson shifts in complex
+       arithmetic. It is meant for the Ritz values of Krylov methods, where
+       a moderate accuracy suffices. The matrix is overwritten.
+     */
+    template<class K>
+    std::vector<std::complex<K> > hessenbergEigenvalues (std::vector<std::vector<std::complex<K> > >& H)
+    {
+      using std::abs;
+      using std::conj;
+      using std::sqrt;
+      typedef std::complex<K> C;
+      const int n = H.size();
+      const K eps = std::numeric_limits<K>::epsilon();
+      std::vector<C> lambda(n), sn(n);
+      std::vector<K> cs(n);
+
+      int iter = 0;
+      for (int hi = n-1; hi >= 0; )
+      {
+        // search for a negligible subdiagonal entry
+        int lo = hi;
+        while (lo > 0 && abs(H[lo][lo-1]) > eps*(abs(H[lo-1][lo-1]) + abs(H[lo][lo])))
+          --lo;
+        if (lo == hi || iter > 30)
+        {
+          lambda[hi] = H[hi][hi];
+          --hi;
+          iter = 0;
+          continue;
+        }
+
+        // Wilkinson shift from the trailing 2x2 block, exceptional shift if stagnating
+        const C a = H[hi-1][hi-1], b = H[hi-1][hi], c = H[hi][hi-1], d = H[hi][hi];
+        const C t = (a+d)/K(2), r = sqrt((a-d)*(a-d)/K(4) + b*c);
+        C mu = (abs(t+r-d) < abs(t-r-d)) ? t+r : t-r;
+        if (iter % 10 == 9)
+          mu += abs(c);
+        ++iter;
+
+        // H - mu I = QR, H = RQ + mu I on the active block
+        for (int k = lo; k <= hi; ++k)
+          H[k][k] -= mu;
+        for (int k = lo; k < hi; ++k)
+        {
+          const K nx = abs(H[k][k]), ny = abs(H[k+1][k]);
+          const K nr = sqrt(nx*nx + ny*ny);
+          cs[k] = (nr > 0) ? nx/nr : K(1);
+          sn[k] = (nr > 0) ? ((nx > 0) ? H[k][k]/nx : C(1))*conj(H[k+1][k])/nr : C(0);
+          for (int l = k; l <= hi; ++l)
+          {
+            const C x = H[k][l], y = H[k+1][l];
+            H[k][l] = cs[k]*x + sn[k]*y;
+            H[k+1][l] = -conj(sn[k])*x + cs[k]*y;
+          }
+        }
+        for (int k = lo; k < hi; ++k)
+          for (int l = lo; l <= std::min(k+2, hi); ++l)
+          {
+            const C x = H[l][k], y = H[l][k+1];
+            H[l][k] = x*cs[k] + y*conj(sn[k]);
+            H[l][k+1] = -x*sn[k] + y*cs[k];
+          }
+        for (int k = lo; k <= hi; ++k)
+          H[k][k] += mu;
+      }
+      return lambda;
+    }
+
+    /*!
+       \brief Number of eigenvalues of a real symmetric tridiagonal matrix below x.
+
+       Counts the negative pivots of the LDL^T decomposition of T - xI
+       (Sturm sequence), d is the diagonal and e the off-diagonal of T.
+     */
+    template<class K>
+    int sturmCount (const std::vector<K>& d, const std::vector<K>& e, K x)
+    {
+      using std::abs;
+      const K tiny = std::numeric_limits<K>::min();
+      int count = 0;
+      K q = 1;
+      for (std::size_t k = 0; k < d.size(); ++k)
+      {
+        q = d[k] - x - ((k > 0) ? e[k-1]*e[k-1]/q : K(0));
+        if (abs(q) < tiny)
+          q = -tiny;
+        if (q < 0)
+          ++count;
+      }
+      return count;
+    }
+
+    /*!
+       \brief The k-th smallest eigenvalue of a real symmetric tridiagonal matrix.
+
+       Bisection with Sturm sequence counts starting from the Gershgorin
+       interval, so it costs O(n) operations per bisection step.
+     */
+    template<class K>
+    K tridiagonalEigenvalue (const std::vector<K>& d, const std::vector<K>& e, int k)
+    {
+      using std::abs;
+      using std::max;
+      using std::min;
+      const int n = d.size();
+      K lo = d[0], hi = d[0];
+      for (int j = 0; j < n; ++j)
+      {
+        const K radius = ((j > 0) ? abs(e[j-1]) : K(0)) + ((j+1 < n) ? abs(e[j]) : K(0));
+        lo = min(lo, d[j] - radius);
+        hi = max(hi, d[j] + radius);
+      }
+      const K eps = std::numeric_limits<K>::epsilon();
+      for (int step = 0; step < 200 && hi - lo > eps*(abs(lo) + abs(hi)); ++step)
+      {
+        const K mid = (lo + hi)/2;
+        if (sturmCount(d, e, mid) > k)
+          hi = mid;
+        else
+          lo = mid;
+      }
+      return (lo + hi)/2;
+    }
+
+    /*!
+       \brief Eigenvalue estimates from a Lanczos tridiagonal matrix.
+
+       The extreme eigenvalues of the symmetric tridiagonal matrix with
+       diagonal d and off-diagonal e approximate those of the (preconditioned)
+       operator of the Lanczos process. Each SIMD lane gives a matrix of its
+       own. Sets the smallest and largest eigenvalue in magnitude and their
+       ratio as condition estimate in res.
+     */
+    template<class F>
+    void lanczosEigenvalueEstimates (const std::vector<F>& d, const std::vector<F>& e, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::max;
+      using std::min;
+      using std::real;
+      typedef Simd::Scalar<typename FieldTraits<F>::real_type> K;
+      const int n = d.size();
+      if (n == 0)
+        return;
+      K minEigenvalue = std::numeric_limits<K>::max(), maxEigenvalue = 0;
+      std::vector<K> dl(n), el(n-1);
+      for (std::size_t l = 0; l < Simd::lanes<F>(); ++l)
+      {
+        for (int k = 0; k < n; ++k)
+          dl[k] = real(Simd::lane(l, d[k]));
+        for (int k = 0; k+1 < n; ++k)
+          el[k] = real(Simd::lane(l, e[k]));
+        const K first = tridiagonalEigenvalue(dl, el, 0);
+        const K last = tridiagonalEigenvalue(dl, el, n-1);
+        maxEigenvalue = max(maxEigenvalue, max(abs(first), abs(last)));
+        if (first > 0)
+          minEigenvalue = min(minEigenvalue, first);
+        else if (last < 0)
+          minEigenvalue = min(minEigenvalue, abs(last));
+        else
+        {
+          // indefinite: the eigenvalues next to zero
+          const int negative = sturmCount(dl, el, K(0));
+          minEigenvalue = min(minEigenvalue, abs(tridiagonalEigenvalue(dl, el, negative-1)));
+          if (negative < n)
+            minEigenvalue = min(minEigenvalue, abs(tridiagonalEigenvalue(dl, el, negative)));
+        }
+      }
+      res.min_eigenvalue_estimate = minEigenvalue;
+      res.max_eigenvalue_estimate = maxEigenvalue;
+      res.condition_estimate = maxEigenvalue/minEigenvalue;
+    }
+
+    /*!
+       \brief Eigenvalue estimates from the coefficients of a conjugate gradient method.
+
+       Builds the Lanczos tridiagonal matrix from the step lengths lambda and
+       the scalar products rho = (z,r) of preconditioned and unpreconditioned
+       defect, see Y. Saad, 'Iterative Methods for Sparse Linear Systems',
+       section 6.7.3, and passes it to lanczosEigenvalueEstimates().
+     */
+    template<class F>
+    void cgEigenvalueEstimates (const std::vector<F>& lambda, const std::vector<F>& rho, InverseOperatorResult& res)
+    {
+      using std::sqrt;
+      const std::size_t n = lambda.size();
+      if (n == 0)
+        return;
+      std::vector<F> d(n), e(n-1);
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        d[j] = F(1.0)/lambda[j];
+        if (j > 0)
+          d[j] += rho[j]/rho[j-1]/lambda[j-1];
+        if (j+1 < n)
+          e[j] = sqrt(rho[j+1]/rho[j])/lambda[j];
+      }
+      lanczosEigenvalueEstimates(d, e, res);
+    }
+
+    /*!
+       \brief Eigenvalue estimates from the Hessenberg matrix of an Arnoldi process.
+
+       The Ritz values, i.e. the eigenvalues of the leading n x n part of H,
+       approximate the eigenvalues of the (preconditioned) operator. Each
+       SIMD lane gives a matrix of its own. Sets the smallest and largest
+       magnitude of the Ritz values in res.
+     */
+    template<class H>
+    void arnoldiEigenvalueEstimates (const H& hessenberg, int n, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::max;
+      using std::min;
+      typedef typename std::decay_t<decltype(hessenberg[0][0])> F;
+      typedef Simd::Scalar<typename FieldTraits<F>::real_type> K;
+      if (n <= 0)
+        return;
+      K minEigenvalue = std::numeric_limits<K>::max(), maxEigenvalue = 0;
+      std::vector<std::vector<std::complex<K> > > Hc(n, std::vector<std::complex<K> >(n));
+      for (std::size_t l = 0; l < Simd::lanes<F>(); ++l)
+      {
+        for (int a = 0; a < n; ++a)
+          for (int c = 0; c < n; ++c)
+            Hc[a][c] = (a <= c+1) ? std::complex<K>(Simd::lane(l, hessenberg[a][c])) : std::complex<K>(0);
+        for (const auto& theta : hessenbergEigenvalues(Hc))
+        {
+          minEigenvalue = min(minEigenvalue, abs(theta));
+          maxEigenvalue = max(maxEigenvalue, abs(theta));
+        }
+      }
+      res.min_eigenvalue_estimate = minEigenvalue;
+      res.max_eigenvalue_estimate = maxEigenvalue;
+    }
+
+  } // end namespace Impl
+
   //! \brief conjugate gradient method
   template<class X>
   class CGSolver : public IterativeSolver<X,X> {
@@ -378,6 +625,8 @@ namespace Dune {
           arpack.computeSymMaxMagnitude (eps, eigv, max_eigv);
 
           res.condition_estimate = max_eigv / min_eigv;
+          res.min_eigenvalue_estimate = min_eigv;
+          res.max_eigenvalue_estimate = max_eigv;
 
           if (this->_verbose > 0) {
             std::cout << "Min eigv estimate: " << Simd::io(min_eigv) << '\n';
@@ -387,7 +636,22 @@ namespace Dune {
           }
         }
 #else
-      std::cerr << "WARNING: Condition estimate was requested. This requires ARPACK, but ARPACK was not found!" << std::endl;
+        // without ARPACK the extreme eigenvalues of T are computed by bisection
+        if constexpr (enableConditionEstimate) {
+          if (!lambdas.empty()) {
+            // the ratios beta = rho_{j+1}/rho_j determine rho up to a factor
+            std::vector<real_type> rhos(lambdas.size(), 1.0);
+            for (std::size_t row = 1; row < rhos.size(); ++row)
+              rhos[row] = rhos[row-1] * betas[row-1];
+            Impl::cgEigenvalueEstimates(lambdas, rhos, res);
+
+            if (this->_verbose > 0) {
+              std::cout << "Min eigv estimate: " << res.min_eigenvalue_estimate << '\n';
+              std::cout << "Max eigv estimate: " << res.max_eigenvalue_estimate << '\n';
+              std::cout << "Condition estimate: " << res.condition_estimate << std::endl;
+            }
+          }
+        }
 #endif
       }
     }
@@ -410,6 +674,125 @@ namespace Dune {
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("cgsolver", defaultIterativeSolverCreator<Dune::CGSolver>());
 
+  /*!
+     \brief Pipelined conjugate gradient method
+
+     Variant of the preconditioned conjugate gradient method by Ghysels and
+     Vanroose, which needs a single global reduction per iteration instead
+     of two. The reduction is started by ScalarProduct::idot and overlapped
+     with the application of the preconditioner and the operator, which
+     hides its latency on large numbers of processes.
+
+     The method stores six vectors more than CGSolver and its recurrences
+     accumulate rounding errors faster, so the attainable accuracy can be
+     slightly lower.
+
+     See P. Ghysels, W. Vanroose, Hiding global synchronization latency in the
+     preconditioned Conjugate Gradient algorithm, Parallel Computing 40 (2014).
+   */
+  template<class X>
+  class PipelinedCGSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+    // copy base class constructors
+    using IterativeSolver<X,X>::IterativeSolver;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::sqrt;
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect r
+
+      X u(x), w(x), m(x), n(x);    // u=M^{-1}r, w=Au, m=M^{-1}w, n=Am
+      X p(x), s(x), q(x), z(x);    // search direction p and s=Ap, q=M^{-1}s, z=Aq
+
+      u = 0;
+      _prec->apply(u,b);
+      _op->apply(u,w);
+
+      // (u,r), (u,w) and (r,r) in one reduction
+      const std::vector<const X*> left = {&u, &u, &b};
+      const std::vector<const X*> right = {&b, &w, &b};
+
+      field_type gamma, delta, alpha, beta;
+      field_type gammalast(0), alphalast(0);
+
+      for (int i=0; ; ++i)
+      {
+        auto dots = _sp->idot(left,right);
+
+        // overlap the reduction with preconditioner and operator
+        m = 0;
+        _prec->apply(m,w);           // m=M^{-1}w
+        _op->apply(m,n);             // n=Am
+
+        const std::vector<field_type> result = dots.get();
+        gamma = result[0];
+        delta = result[1];
+
+        // convergence test
+        real_type def = sqrt(abs(result[2]));
+        if (iteration.step(i, def) || i == _maxit)
+          break;
+
+        // update the recurrences
+        if (i == 0)
+        {
+          alpha = gamma/delta;
+          z = n;
+          q = m;
+          s = w;
+          p = u;
+        }
+        else
+        {
+          beta = gamma/gammalast;
+          alpha = gamma/(delta - beta*gamma/alphalast);
+          z *= beta;
+          z += n;
+          q *= beta;
+          q += m;
+          s *= beta;
+          s += w;
+          p *= beta;
+          p += u;
+        }
+        x.axpy(alpha,p);            // update solution
+        b.axpy(-alpha,s);           // update defect
+        u.axpy(-alpha,q);
+        w.axpy(-alpha,z);
+
+        gammalast = gamma;
+        alphalast = alpha;
+      }
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("pipecgsolver", defaultIterativeSolverCreator<Dune::PipelinedCGSolver>());
+
   // Ronald Kriemanns BiCG-STAB implementation from Sumo
   //! \brief Bi-conjugate Gradient Stabilized (BiCG-STAB)
   template<class X>
@@ -645,6 +1028,9 @@ namespace Dune {
       // the rhs vector of the min problem
       std::array<field_type,2> xi{{1.0,0.0}};
 
+      // the full tridiagonal matrix of the Lanczos process for the eigenvalue estimates
+      std::vector<field_type> lanczosDiagonal, lanczosOffDiagonal;
+
       // some temporary vectors
       X z(b), dummy(b);
 
@@ -696,6 +1082,9 @@ namespace Dune {
         // since it is the norm of the basis vectors (in unpreconditioned case)
         beta = sqrt(_sp->dot(q[i2],z));
 
+        lanczosDiagonal.push_back(alpha);
+        lanczosOffDiagonal.push_back(beta);
+
         q[i2] *= real_type(1.0)/beta;
         z *= real_type(1.0)/beta;
 
@@ -741,6 +1130,13 @@ namespace Dune {
         }
       } // end for
 
+      // extreme eigenvalues of the preconditioned operator from the Ritz values
+      if (!lanczosDiagonal.empty())
+      {
+        lanczosOffDiagonal.pop_back();
+        Impl::lanczosEigenvalueEstimates(lanczosDiagonal, lanczosOffDiagonal, res);
+      }
+
         // postprocess preconditioner
         _prec->post(x);
     }
@@ -793,6 +1189,81 @@ namespace Dune {
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("minressolver", defaultIterativeSolverCreator<Dune::MINRESSolver>());
 
+  /**
+     \brief The orthogonalization of a new Krylov vector against the previous
+            ones in RestartedGMResSolver, RestartedFlexibleGMResSolver and
+            RestartedFCGSolver.
+
+     - mgs: modified Gram-Schmidt, one reduction per previous vector,
+     - cgs: classical Gram-Schmidt, all projections in a single reduction,
+     - cgs2: classical Gram-Schmidt with one reorthogonalization,
+     - icgs: iterated classical Gram-Schmidt, which reorthogonalizes (up to
+       three passes) while a pass reduces the norm of the vector by more than
+       a factor of \f$1/\sqrt{2}\f$.
+
+     The classical variants compute the scalar products of a pass by one
+     call of ScalarProduct::idot, i.e. with a single global reduction and,
+     for the BlockVector, in a single sweep over the vectors (see
+     block_vector_unmanaged::mdot and block_vector_unmanaged::maxpy).
+     Classical Gram-Schmidt loses orthogonality for ill-conditioned Krylov
+     bases, with one reorthogonalization it is as stable as modified
+     Gram-Schmidt.
+
+     The classical variants need the Krylov vectors to be of the domain type
+     of the solver, RestartedFCGSolver does not support icgs. The
+     constructors of the solvers throw NotImplemented otherwise.
+   */
+  struct Orthogonalization
+  {
+    enum Type {
+      mgs,
+      cgs,
+      cgs2,
+      icgs
+    };
+  };
+
+  namespace Impl {
+
+    //! Parse the name of an orthogonalization as used in a ParameterTree
+    inline Orthogonalization::Type orthogonalizationFromString (const std::string& name)
+    {
+      if (name == "mgs")
+        return Orthogonalization::mgs;
+      if (name == "cgs")
+        return Orthogonalization::cgs;
+      if (name == "cgs2")
+        return Orthogonalization::cgs2;
+      if (name == "icgs")
+        return Orthogonalization::icgs;
+      DUNE_THROW(ISTLError, "Unknown orthogonalization '" << name << "'");
+    }
+
+    //! Check that an orthogonalization is available for Krylov vectors of type F and the domain type X
+    template<class X, class F>
+    Orthogonalization::Type checkOrthogonalization (Orthogonalization::Type orthogonalization)
+    {
+      if (orthogonalization != Orthogonalization::mgs && !std::is_convertible<F*,X*>::value)
+        DUNE_THROW(NotImplemented, "classical Gram-Schmidt needs the Krylov vectors to be of the domain type");
+      return orthogonalization;
+    }
+
+    template<class X, class A>
+    using MAxpyOp = decltype(std::declval<X&>().maxpy(std::declval<const A&>(), std::declval<const std::vector<const X*>&>()));
+
+    //! x += a[k] y[k] for all k, in a single sweep if X provides maxpy
+    template<class X, class A>
+    void maxpy (X& x, const A& a, const std::vector<const X*>& y)
+    {
+      if constexpr (Std::is_detected<MAxpyOp, X, A>::value)
+        x.maxpy(a,y);
+      else
+        for (std::size_t k=0; k<y.size(); ++k)
+          x.axpy(a[k],*y[k]);
+    }
+
+  } // end namespace Impl
+
   /**
      \brief implements the Generalized Minimal Residual (GMRes) method
 
@@ -800,6 +1271,9 @@ namespace Dune {
      Generalized Minimal Residual method as described the SIAM Templates
      book (http://www.netlib.org/templates/templates.pdf).
 
+     The Arnoldi process uses modified Gram-Schmidt by default, see
+     Orthogonalization for variants with fewer global reductions.
+
      \tparam X trial vector, vector type of the solution
      \tparam Y test vector, vector type of the RHS
      \tparam F vector type for orthonormal basis of Krylov space
@@ -830,10 +1304,12 @@ namespace Dune {
 
        \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
        \param restart number of GMRes cycles before restart
+       \param orthogonalization the orthogonalization of the Arnoldi process
      */
-    RestartedGMResSolver (LinearOperator<X,Y>& op, Preconditioner<X,Y>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+    RestartedGMResSolver (LinearOperator<X,Y>& op, Preconditioner<X,Y>& prec, scalar_real_type reduction, int restart, int maxit, int verbose,
+                          Orthogonalization::Type orthogonalization = Orthogonalization::mgs) :
       IterativeSolver<X,Y>::IterativeSolver(op,prec,reduction,maxit,verbose),
-      _restart(restart)
+      _restart(restart), _orthogonalization(Impl::checkOrthogonalization<X,F>(orthogonalization))
     {}
 
     /*!
@@ -841,10 +1317,12 @@ namespace Dune {
 
        \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
        \param restart number of GMRes cycles before restart
+       \param orthogonalization the orthogonalization of the Arnoldi process
      */
-    RestartedGMResSolver (LinearOperator<X,Y>& op, ScalarProduct<X>& sp, Preconditioner<X,Y>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+    RestartedGMResSolver (LinearOperator<X,Y>& op, ScalarProduct<X>& sp, Preconditioner<X,Y>& prec, scalar_real_type reduction, int restart, int maxit, int verbose,
+                          Orthogonalization::Type orthogonalization = Orthogonalization::mgs) :
       IterativeSolver<X,Y>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
-      _restart(restart)
+      _restart(restart), _orthogonalization(Impl::checkOrthogonalization<X,F>(orthogonalization))
     {}
 
     /*!
@@ -856,17 +1334,20 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        restart           | number of GMRes cycles before restart
+       orthogonalization | orthogonalization of the Arnoldi process, "mgs", "cgs", "cgs2" or "icgs". default=mgs
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     RestartedGMResSolver (std::shared_ptr<LinearOperator<X,Y> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
       IterativeSolver<X,Y>::IterativeSolver(op,prec,configuration),
-      _restart(configuration.get<int>("restart"))
+      _restart(configuration.get<int>("restart")),
+      _orthogonalization(Impl::checkOrthogonalization<X,F>(Impl::orthogonalizationFromString(configuration.get<std::string>("orthogonalization", "mgs"))))
     {}
 
     RestartedGMResSolver (std::shared_ptr<LinearOperator<X,Y> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
       IterativeSolver<X,Y>::IterativeSolver(op,sp,prec,configuration),
-      _restart(configuration.get<int>("restart"))
+      _restart(configuration.get<int>("restart")),
+      _orthogonalization(Impl::checkOrthogonalization<X,F>(Impl::orthogonalizationFromString(configuration.get<std::string>("orthogonalization", "mgs"))))
     {}
 
     /*!
@@ -874,13 +1355,15 @@ namespace Dune {
 
       \copydoc LoopSolver::LoopSolver(std::shared_ptr<L>,std::shared_ptr<S>,std::shared_ptr<P>,double,int,int)
        \param restart number of GMRes cycles before restart
+       \param orthogonalization the orthogonalization of the Arnoldi process
      */
     RestartedGMResSolver (std::shared_ptr<LinearOperator<X,Y>> op,
                           std::shared_ptr<ScalarProduct<X>> sp,
                           std::shared_ptr<Preconditioner<X,Y>> prec,
-                          scalar_real_type reduction, int restart, int maxit, int verbose) :
+                          scalar_real_type reduction, int restart, int maxit, int verbose,
+                          Orthogonalization::Type orthogonalization = Orthogonalization::mgs) :
       IterativeSolver<X,Y>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
-      _restart(restart)
+      _restart(restart), _orthogonalization(Impl::checkOrthogonalization<X,F>(orthogonalization))
     {}
 
     /*!
@@ -919,6 +1402,11 @@ namespace Dune {
       Y w(b);
       std::vector< std::vector<field_type,fAlloc> > H(m+1,s);
       std::vector<F> v(m+1,b);
+      // Hessenberg matrix of the current cycle before the QR factorization
+      // and the one of the longest last cycle, whose eigenvalues approximate
+      // those of the preconditioned operator
+      std::vector< std::vector<field_type,fAlloc> > hessenberg(H), arnoldi(H);
+      int cycle = 0;
 
       Iteration iteration(*this,res);
 
@@ -950,19 +1438,12 @@ namespace Dune {
           // do Arnoldi algorithm
           _op->apply(v[i],v[i+1]);
           _prec->apply(w,v[i+1]);
-          for(int k=0; k<i+1; k++) {
-            // notice that _sp->dot(v[k],w) = v[k]\adjoint w
-            // so one has to pay attention to the order
-            // in the scalar product for the complex case
-            // doing the modified Gram-Schmidt algorithm
-            H[k][i] = _sp->dot(v[k],w);
-            // w -= H[k][i] * v[k]
-            w.axpy(-H[k][i],v[k]);
-          }
-          H[i+1][i] = _sp->norm(w);
+          H[i+1][i] = orthogonalize(v,i,w,H);
           if(Simd::allTrue(abs(H[i+1][i]) < EPSILON))
             DUNE_THROW(SolverAbort,
                        "breakdown in GMRes - |w| == 0.0 after " << j << " iterations");
+          for(int k=0; k<i+2; k++)
+            hessenberg[k][i] = H[k][i];
 
           // normalize new vector
           v[i+1] = w; v[i+1] *= real_type(1.0)/H[i+1][i];
@@ -983,6 +1464,11 @@ namespace Dune {
           iteration.step(j, norm);
 
         } // end for
+        // a final cycle shorter than the previous ones gives worse estimates
+        if (i >= cycle) {
+          std::swap(hessenberg, arnoldi);
+          cycle = i;
+        }
 
         // calculate update vector
         w = 0.0;
@@ -1009,12 +1495,75 @@ namespace Dune {
 
       } //end while
 
+      // Ritz values of the last full cycle
+      Impl::arnoldiEigenvalueEstimates(arnoldi, cycle, res);
+
       // postprocess preconditioner
       _prec->post(x);
     }
 
   protected :
 
+    /* Orthogonalize w against v[0], ..., v[i], store the coefficients in
+     * the column i of H and return the norm of the orthogonalized vector.
+     */
+    template<class V, class W>
+    real_type orthogonalize (const std::vector<V>& v, int i, W& w,
+                             std::vector<std::vector<field_type,fAlloc> >& H)
+    {
+      using std::abs;
+      if (_orthogonalization == Orthogonalization::mgs) {
+        for(int k=0; k<i+1; k++) {
+          // notice that _sp->dot(v[k],w) = v[k]\adjoint w
+          // so one has to pay attention to the order
+          // in the scalar product for the complex case
+          // doing the modified Gram-Schmidt algorithm
+          H[k][i] = _sp->dot(v[k],w);
+          // w -= H[k][i] * v[k]
+          w.axpy(-H[k][i],v[k]);
+        }
+        return _sp->norm(w);
+      }
+
+      if constexpr (std::is_convertible<const V*,const X*>::value && std::is_convertible<W*,X*>::value) {
+        const int passes = (_orthogonalization == Orthogonalization::cgs) ? 1
+          : (_orthogonalization == Orthogonalization::cgs2) ? 2 : 3;
+        const bool iterated = (_orthogonalization == Orthogonalization::icgs);
+
+        // all scalar products of a pass in one reduction, for icgs
+        // including the norm of w before the pass
+        std::vector<const X*> basis(i+1), left, right;
+        for(int k=0; k<i+1; k++)
+          basis[k] = &v[k];
+        left = basis;
+        if (iterated)
+          left.push_back(&w);
+        right.assign(left.size(), &w);
+
+        std::vector<field_type,fAlloc> h(i+1);
+        for(int k=0; k<i+1; k++)
+          H[k][i] = 0.0;
+        for (int pass = 0; pass < passes; ++pass) {
+          const std::vector<field_type> dots = _sp->idot(left,right).get();
+          real_type projected(0.0);
+          for(int k=0; k<i+1; k++) {
+            H[k][i] += dots[k];
+            h[k] = -dots[k];
+            projected += abs(dots[k])*abs(dots[k]);
+          }
+          // w -= sum_k dots[k] v[k]
+          Impl::maxpy(w,h,basis);
+          // the norm of w after the pass follows from Pythagoras' theorem,
+          // a reduction by less than 1/sqrt(2) needs no further pass
+          if (iterated && Simd::allTrue(abs(dots[i+1]) - projected > real_type(0.5)*abs(dots[i+1])))
+            break;
+        }
+        return _sp->norm(w);
+      }
+      else
+        DUNE_THROW(NotImplemented, "classical Gram-Schmidt needs the Krylov vectors to be of the domain type");
+    }
+
     void update(X& w, int i,
                 const std::vector<std::vector<field_type,fAlloc> >& H,
                 const std::vector<field_type,fAlloc>& s,
@@ -1095,176 +1644,2358 @@ namespace Dune {
     using IterativeSolver<X,Y>::_verbose;
     using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
     int _restart;
+    Orthogonalization::Type _orthogonalization;
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("restartedgmressolver", defaultIterativeSolverCreator<Dune::RestartedGMResSolver>());
 
-  /**
-     \brief implements the Flexible Generalized Minimal Residual (FGMRes) method (right preconditioned)
-
-     FGMRes solves the right-preconditioned unsymmetric linear system Ax = b using the
-     Flexible Generalized Minimal Residual method. It is flexible because the preconditioner can change in every iteration,
-     which allows to use Krylov solvers without fixed number of iterations as preconditioners. Needs more memory than GMRes.
-
-     \tparam X trial vector, vector type of the solution
-     \tparam Y test vector, vector type of the RHS
-     \tparam F vector type for orthonormal basis of Krylov space
-
-   */
+  namespace Impl {
 
-  template<class X, class Y=X, class F = Y>
-  class RestartedFlexibleGMResSolver : public RestartedGMResSolver<X,Y>
-  {
-  public:
-    using typename RestartedGMResSolver<X,Y>::domain_type;
-    using typename RestartedGMResSolver<X,Y>::range_type;
-    using typename RestartedGMResSolver<X,Y>::field_type;
-    using typename RestartedGMResSolver<X,Y>::real_type;
+    /*!
+       \brief Reduce a small square matrix to upper Hessenberg form.
 
-  private:
-    using typename RestartedGMResSolver<X,Y>::scalar_real_type;
+       Uses Householder reflections, the matrix is overwritten by a similar
+       upper Hessenberg matrix, e.g. as input for hessenbergEigenvalues.
+     */
+    template<class K>
+    void hessenbergReduction (std::vector<std::vector<std::complex<K> > >& A)
+    {
+      using std::abs;
+      using std::conj;
+      using std::sqrt;
+      typedef std::complex<K> C;
+      const int n = A.size();
+      std::vector<C> u(n);
+      for (int j = 0; j+2 < n; ++j)
+      {
+        K xnorm2 = 0;
+        for (int r = j+1; r < n; ++r)
+          xnorm2 += std::norm(A[r][j]);
+        if (xnorm2 == K(0))
+          continue;
+
+        // u = x + phase(x_1)|x| e_1
+        const C phase = (abs(A[j+1][j]) > K(0)) ? A[j+1][j]/abs(A[j+1][j]) : C(1);
+        for (int r = j+1; r < n; ++r)
+          u[r] = A[r][j];
+        u[j+1] += phase*sqrt(xnorm2);
+        K unorm2 = 0;
+        for (int r = j+1; r < n; ++r)
+          unorm2 += std::norm(u[r]);
+
+        // A = (I - 2uu^H/|u|^2) A (I - 2uu^H/|u|^2)
+        for (int c = j; c < n; ++c)
+        {
+          C t = 0;
+          for (int r = j+1; r < n; ++r)
+            t += conj(u[r])*A[r][c];
+          t *= K(2)/unorm2;
+          for (int r = j+1; r < n; ++r)
+            A[r][c] -= t*u[r];
+        }
+        for (int r = 0; r < n; ++r)
+        {
+          C t = 0;
+          for (int c = j+1; c < n; ++c)
+            t += A[r][c]*u[c];
+          t *= K(2)/unorm2;
+          for (int c = j+1; c < n; ++c)
+            A[r][c] -= t*conj(u[c]);
+        }
+        for (int r = j+2; r < n; ++r)
+          A[r][j] = 0;
+      }
+    }
 
-    //! \brief field_type Allocator retrieved from domain type
-    using fAlloc = typename RestartedGMResSolver<X,Y>::fAlloc;
-    //! \brief real_type Allocator retrieved from domain type
-    using rAlloc = typename RestartedGMResSolver<X,Y>::rAlloc;
+    /*!
+       \brief LU factorization of a small square matrix with partial pivoting.
 
-  public:
-    // copy base class constructors
-    using RestartedGMResSolver<X,Y>::RestartedGMResSolver;
+       The factors overwrite the matrix. Pivots below a tolerance relative
+       to the largest entry are replaced by it, so nearly singular matrices,
+       as in inverse iteration, can be solved as well.
+     */
+    template<class K>
+    void denseLUFactor (std::vector<std::vector<K> >& A, std::vector<int>& pivot)
+    {
+      using std::abs;
+      typedef typename FieldTraits<K>::real_type real_type;
+      const int n = A.size();
+      real_type scale = 0;
+      for (const auto& row : A)
+        for (const auto& a : row)
+          scale = std::max(scale, real_type(abs(a)));
+      const real_type tiny = std::numeric_limits<real_type>::epsilon()*((scale > real_type(0)) ? scale : real_type(1));
+
+      pivot.resize(n);
+      for (int c = 0; c < n; ++c)
+      {
+        int p = c;
+        for (int r = c+1; r < n; ++r)
+          if (abs(A[r][c]) > abs(A[p][c]))
+            p = r;
+        pivot[c] = p;
+        std::swap(A[c], A[p]);
+        if (abs(A[c][c]) < tiny)
+          A[c][c] = tiny;
+        for (int r = c+1; r < n; ++r)
+        {
+          A[r][c] /= A[c][c];
+          for (int l = c+1; l < n; ++l)
+            A[r][l] -= A[r][c]*A[c][l];
+        }
+      }
+    }
 
-    // don't shadow four-argument version of apply defined in the base class
-    using RestartedGMResSolver<X,Y>::apply;
+    //! Solve with the factors computed by denseLUFactor, b is overwritten by the solution
+    template<class K>
+    void denseLUSolve (const std::vector<std::vector<K> >& LU, const std::vector<int>& pivot, std::vector<K>& b)
+    {
+      const int n = LU.size();
+      for (int c = 0; c < n; ++c)
+        std::swap(b[c], b[pivot[c]]);
+      for (int r = 0; r < n; ++r)
+        for (int l = 0; l < r; ++l)
+          b[r] -= LU[r][l]*b[l];
+      for (int r = n-1; r >= 0; --r)
+      {
+        for (int l = r+1; l < n; ++l)
+          b[r] -= LU[r][l]*b[l];
+        b[r] /= LU[r][r];
+      }
+    }
 
     /*!
-       \brief Apply inverse operator.
-
-       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+       \brief Sort points into Leja order.
 
-       \note Currently, the RestartedFlexibleGMResSolver aborts when it detects a
-             breakdown.
+       The first point has the largest modulus, each further point maximizes
+       the product of the distances to the previous ones. If conjugatePairs
+       is set, a point with positive imaginary part is directly followed by
+       its complex conjugate and points with negative imaginary part are only
+       chosen this way.
      */
-    void apply (X& x, Y& b, double reduction, InverseOperatorResult& res) override
+    template<class K>
+    void lejaOrder (std::vector<std::complex<K> >& z, bool conjugatePairs)
     {
       using std::abs;
-      const Simd::Scalar<real_type> EPSILON = 1e-80;
-      const int m = _restart;
-      real_type norm = 0.0;
-      int i, j = 1, k;
-      std::vector<field_type,fAlloc> s(m+1), sn(m);
-      std::vector<real_type,rAlloc> cs(m);
-      // helper vector
-      Y tmp(b);
+      using std::log;
+      const K eps = std::sqrt(std::numeric_limits<K>::epsilon());
+      auto isComplex = [&](const std::complex<K>& p){
+        return abs(p.imag()) > eps*abs(p);
+      };
+
+      for (std::size_t i = 0; i < z.size(); ++i)
+      {
+        std::size_t best = i;
+        K bestValue = std::numeric_limits<K>::lowest();
+        for (std::size_t l = i; l < z.size(); ++l)
+        {
+          if (conjugatePairs && isComplex(z[l]) && z[l].imag() < 0)
+            continue;
+          K value = (i == 0) ? abs(z[l]) : K(0);
+          for (std::size_t p = 0; p < i; ++p)
+            value += log(abs(z[l] - z[p]) + std::numeric_limits<K>::min());
+          if (value > bestValue)
+          {
+            best = l;
+            bestValue = value;
+          }
+        }
+        std::swap(z[i], z[best]);
+
+        if (conjugatePairs && isComplex(z[i]) && i+1 < z.size())
+        {
+          // the partner is the remaining point closest to the conjugate
+          std::size_t partner = i+1;
+          for (std::size_t l = i+1; l < z.size(); ++l)
+            if (abs(z[l] - conj(z[i])) < abs(z[partner] - conj(z[i])))
+              partner = l;
+          std::swap(z[++i], z[partner]);
+        }
+      }
+    }
+
+  } // end namespace Impl
+
+  /**
+     \brief The basis used by the SStepGMResSolver to generate Krylov vectors.
+
+     The monomial basis computes \f$v_{j+1} = W^{-1}A v_j\f$, the Newton basis
+     \f$v_{j+1} = (W^{-1}A - \theta_j)v_j\f$ with Leja ordered Ritz values
+     \f$\theta_j\f$ from the first restart cycle, which keeps the basis
+     better conditioned for larger s.
+   */
+  struct SStepBasis
+  {
+    enum Type {
+      monomial,
+      newton
+    };
+  };
+
+  /**
+     \brief implements the communication-avoiding s-step GMRes method
+
+     Left preconditioned GMRes (as RestartedGMResSolver), which generates s
+     Krylov vectors at once and orthogonalizes them as a block by classical
+     Gram-Schmidt with reorthogonalization and Cholesky QR. Each of the two
+     passes needs a single global reduction (see ScalarProduct::idot), so
+     the number of reductions per iteration drops by roughly a factor of s
+     compared to the modified Gram-Schmidt of RestartedGMResSolver.
+
+     The Hessenberg matrix of the Arnoldi relation is recovered from the
+     change of basis and the triangular factors of the block
+     orthogonalization, see M. Hoemmen, Communication-avoiding Krylov
+     subspace methods, PhD thesis, UC Berkeley (2010). If a block turns out
+     to be numerically rank deficient, it is truncated to its independent
+     vectors.
+
+     For SIMD field types only the monomial basis is available.
+
+     \tparam X vector type of the solution, the right hand side and the basis
+   */
+  template<class X>
+  class SStepGMResSolver : public RestartedGMResSolver<X>
+  {
+  public:
+    using typename RestartedGMResSolver<X>::domain_type;
+    using typename RestartedGMResSolver<X>::range_type;
+    using typename RestartedGMResSolver<X>::field_type;
+    using typename RestartedGMResSolver<X>::real_type;
+
+  private:
+    using typename RestartedGMResSolver<X>::scalar_real_type;
+
+    //! \brief field_type Allocator retrieved from domain type
+    using fAlloc = typename RestartedGMResSolver<X>::fAlloc;
+    //! \brief real_type Allocator retrieved from domain type
+    using rAlloc = typename RestartedGMResSolver<X>::rAlloc;
+
+    typedef std::vector<std::vector<field_type,fAlloc> > DenseMatrix;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using RestartedGMResSolver<X>::apply;
+
+    /*!
+       \brief Set up SStepGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart
+       \param sstep number of Krylov vectors generated and orthogonalized at once
+       \param basis the basis of the generated Krylov vectors
+     */
+    SStepGMResSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int sstep, int maxit, int verbose,
+                      SStepBasis::Type basis = SStepBasis::newton) :
+      RestartedGMResSolver<X>(op,prec,reduction,restart,maxit,verbose),
+      _sstep(sstep), _basis(basis)
+    {}
+
+    /*!
+       \brief Set up SStepGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart
+       \param sstep number of Krylov vectors generated and orthogonalized at once
+       \param basis the basis of the generated Krylov vectors
+     */
+    SStepGMResSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int sstep, int maxit, int verbose,
+                      SStepBasis::Type basis = SStepBasis::newton) :
+      RestartedGMResSolver<X>(op,sp,prec,reduction,restart,maxit,verbose),
+      _sstep(sstep), _basis(basis)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(L&,S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       restart           | number of GMRes cycles before restart
+       sstep             | number of Krylov vectors generated at once. default=4
+       basis             | basis of the generated Krylov vectors, "newton" or "monomial". default=newton
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SStepGMResSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      RestartedGMResSolver<X>(op,prec,configuration),
+      _sstep(configuration.get<int>("sstep", 4)), _basis(basisFromString(configuration.get<std::string>("basis", "newton")))
+    {}
+
+    SStepGMResSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      RestartedGMResSolver<X>(op,sp,prec,configuration),
+      _sstep(configuration.get<int>("sstep", 4)), _basis(basisFromString(configuration.get<std::string>("basis", "newton")))
+    {}
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+
+       \note Currently, the SStepGMResSolver aborts when it detects a
+             breakdown.
+     */
+    void apply (X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+      using std::abs;
+      typedef Simd::Scalar<real_type> K;
+      const int m = _restart;
+      const int sstep = std::max(1, std::min(_sstep, m));
+      real_type norm = 0.0;
+      int j = 1;
+      std::vector<field_type,fAlloc> s(m+1), sn(m);
+      std::vector<real_type,rAlloc> cs(m);
+      // need copy of rhs if GMRes has to be restarted
+      X b2(b);
+      // helper vectors
+      X w(b), y(b);
+      // Hessenberg matrix of the Arnoldi relation and its QR factorization
+      DenseMatrix H(m+1,s), R(m+1,s);
+      std::vector<X> v(m+1,b);
+      // shifts of the Newton basis
+      std::vector<std::complex<K> > theta;
+
+      Iteration iteration(*this,res);
+
+      _prec->pre(x,b);
+
+      // calculate defect and overwrite rhs with it
+      _op->applyscaleadd(-1.0,x,b); // b -= Ax
+      // calculate preconditioned defect
+      v[0] = 0.0; _prec->apply(v[0],b); // r = W^-1 b
+      norm = _sp->norm(v[0]);
+      if(iteration.step(0, norm)){
+        _prec->post(x);
+        return;
+      }
+
+      while(j <= _maxit && res.converged != true) {
+
+        int i = 0;
+        v[0] *= real_type(1.0)/norm;
+        s[0] = norm;
+        for(i=1; i<m+1; i++)
+          s[i] = 0.0;
+
+        i = 0;
+        while(i < m && j <= _maxit && res.converged != true) {
+          // generate the next block of Krylov vectors from v[i]
+          int block = std::min(sstep, m-i);
+          DenseMatrix B(block+1, std::vector<field_type,fAlloc>(block, 0.0));
+          generateBasis(v, i, block, theta, B, y);
+
+          // orthogonalize it against the previous basis and itself
+          DenseMatrix C, T;
+          block = orthogonalizeBlock(v, i, block, C, T);
+          if(block == 0)
+            DUNE_THROW(SolverAbort,
+                       "breakdown in s-step GMRes - Krylov block is linearly dependent after " << j << " iterations");
+
+          // recover the new columns of the Hessenberg matrix and update its QR factorization
+          hessenbergColumns(H, i, block, B, C, T);
+          for(int t=0; t < block && j <= _maxit && res.converged != true; t++, i++, j++) {
+            for(int k=0; k<i+2; k++)
+              R[k][i] = H[k][i];
+            for(int k=0; k<i; k++)
+              this->applyPlaneRotation(R[k][i],R[k+1][i],cs[k],sn[k]);
+            this->generatePlaneRotation(R[i][i],R[i+1][i],cs[i],sn[i]);
+            this->applyPlaneRotation(R[i][i],R[i+1][i],cs[i],sn[i]);
+            this->applyPlaneRotation(s[i],s[i+1],cs[i],sn[i]);
+
+            // norm of the defect is the last component the vector s
+            norm = abs(s[i+1]);
+            iteration.step(j, norm);
+          }
+        }
+
+        // Ritz values of the first cycle are the shifts of the Newton basis
+        if constexpr (std::is_same<field_type,Simd::Scalar<field_type> >::value)
+          if(_basis == SStepBasis::newton && theta.empty() && i > 0)
+            theta = ritzValues(H, std::min(i, m));
+
+        // calculate update vector
+        w = 0.0;
+        this->update(w,i,R,s,v);
+        // and current iterate
+        x += w;
+
+        // restart GMRes if convergence was not achieved,
+        // i.e. linear defect has not reached desired reduction
+        // and if j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit ) {
+
+          if(_verbose > 0)
+            std::cout << "=== GMRes::restart" << std::endl;
+          // get saved rhs
+          b = b2;
+          // calculate new defect
+          _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+          // calculate preconditioned defect
+          v[0] = 0.0;
+          _prec->apply(v[0],b);
+          norm = _sp->norm(v[0]);
+        }
+
+      } //end while
+
+      // postprocess preconditioner
+      _prec->post(x);
+    }
+
+  protected:
+    static SStepBasis::Type basisFromString (const std::string& basis)
+    {
+      if (basis == "newton")
+        return SStepBasis::newton;
+      if (basis == "monomial")
+        return SStepBasis::monomial;
+      DUNE_THROW(ISTLError, "Unknown s-step basis '" << basis << "'");
+    }
+
+    static real_type realPart (const field_type& f)
+    {
+      if constexpr (std::is_same<field_type,real_type>::value)
+        return f;
+      else {
+        using std::real;
+        return real(f);
+      }
+    }
+
+    /* Generate v[i+1], ..., v[i+block] from v[i] and store the change of
+     * basis W^{-1}A [v_i ... v_{i+block-1}] = [v_i ... v_{i+block}] B.
+     * For real field types a complex conjugate pair of shifts a+ib, a-ib
+     * is applied in real arithmetic as (W^{-1}A - a)^2 + b^2.
+     */
+    template<class K>
+    void generateBasis (std::vector<X>& v, int i, int block, const std::vector<std::complex<K> >& theta,
+                        DenseMatrix& B, X& y)
+    {
+      K pending = 0.0;
+      for (int t = 0; t < block; ++t)
+      {
+        _op->apply(v[i+t],y);
+        v[i+t+1] = 0.0;
+        _prec->apply(v[i+t+1],y);
+        B[t+1][t] = 1.0;
+        if (theta.empty())
+          continue;
+
+        const std::complex<K>& shift = theta[t % theta.size()];
+        if constexpr (std::is_same<field_type,real_type>::value)
+        {
+          v[i+t+1].axpy(-shift.real(),v[i+t]);
+          B[t][t] = shift.real();
+          if (t > 0 && pending != K(0.0))
+          {
+            v[i+t+1].axpy(pending,v[i+t-1]);
+            B[t-1][t] = -pending;
+            pending = 0.0;
+          }
+          else if (shift.imag() > 0)
+            pending = shift.imag()*shift.imag();
+        }
+        else
+        {
+          v[i+t+1].axpy(-field_type(shift),v[i+t]);
+          B[t][t] = field_type(shift);
+        }
+      }
+    }
+
+    /* Orthogonalize v[i+1], ..., v[i+block] against v[0], ..., v[i] and among
+     * each other by two passes of block classical Gram-Schmidt with Cholesky
+     * QR, each with a single reduction. On return the old block equals
+     * [v_0 ... v_i] C + [v_{i+1} ... v_{i+rank}] T with upper triangular T,
+     * the numerical rank is returned.
+     */
+    int orthogonalizeBlock (std::vector<X>& v, int i, int block, DenseMatrix& C, DenseMatrix& T)
+    {
+      using std::sqrt;
+      const Simd::Scalar<real_type> tolerance = 1e4*std::numeric_limits<Simd::Scalar<real_type> >::epsilon();
+
+      C.assign(i+1, std::vector<field_type,fAlloc>(block, 0.0));
+      T.assign(block, std::vector<field_type,fAlloc>(block, 0.0));
+      for (int c = 0; c < block; ++c)
+        T[c][c] = 1.0;
+
+      DenseMatrix Cp(i+1, std::vector<field_type,fAlloc>(block)), G(block, std::vector<field_type,fAlloc>(block)),
+        Rp(block, std::vector<field_type,fAlloc>(block, 0.0));
+      std::vector<const X*> left, right;
+      for (int pass = 0; pass < 2 && block > 0; ++pass)
+      {
+        // all scalar products of the pass in one reduction
+        // (grouped by the second vector, which allows a fused computation)
+        left.clear();
+        right.clear();
+        for (int c = 0; c < block; ++c)
+          for (int a = 0; a <= i; ++a) {
+            left.push_back(&v[a]);
+            right.push_back(&v[i+1+c]);
+          }
+        for (int c2 = 0; c2 < block; ++c2)
+          for (int c1 = 0; c1 <= c2; ++c1) {
+            left.push_back(&v[i+1+c1]);
+            right.push_back(&v[i+1+c2]);
+          }
+        const std::vector<field_type> dots = _sp->idot(left,right).get();
+
+        // project out the previous basis, the Gram matrix of the projected
+        // block follows from Pythagoras' theorem
+        std::size_t n = 0;
+        for (int c = 0; c < block; ++c)
+          for (int a = 0; a <= i; ++a)
+            Cp[a][c] = dots[n++];
+        std::vector<real_type> norm2(block);
+        for (int c2 = 0; c2 < block; ++c2)
+          for (int c1 = 0; c1 <= c2; ++c1) {
+            G[c1][c2] = dots[n++];
+            if (c1 == c2)
+              norm2[c1] = realPart(G[c1][c1]);
+            for (int a = 0; a <= i; ++a)
+              G[c1][c2] -= this->conjugate(Cp[a][c1])*Cp[a][c2];
+          }
+        std::vector<const X*> basis(left.begin(), left.begin()+i+1);
+        std::vector<field_type,fAlloc> coefficients(i+1);
+        for (int c = 0; c < block; ++c) {
+          for (int a = 0; a <= i; ++a)
+            coefficients[a] = -Cp[a][c];
+          Impl::maxpy(v[i+1+c],coefficients,basis);
+        }
+
+        // Cholesky factorization G = Rp^H Rp up to the first dependent vector
+        int rank = block;
+        for (int c = 0; c < block && rank == block; ++c) {
+          real_type d = realPart(G[c][c]);
+          for (int l = 0; l < c; ++l)
+            d -= realPart(this->conjugate(Rp[l][c])*Rp[l][c]);
+          if (Simd::anyTrue(d <= tolerance*norm2[c])) {
+            rank = c;
+            break;
+          }
+          Rp[c][c] = sqrt(d);
+          for (int c2 = c+1; c2 < block; ++c2) {
+            field_type r = G[c][c2];
+            for (int l = 0; l < c; ++l)
+              r -= this->conjugate(Rp[l][c])*Rp[l][c2];
+            Rp[c][c2] = r/Rp[c][c];
+          }
+        }
+
+        // v = v Rp^{-1}
+        for (int c = 0; c < rank; ++c) {
+          for (int l = 0; l < c; ++l)
+            v[i+1+c].axpy(-Rp[l][c],v[i+1+l]);
+          v[i+1+c] *= real_type(1.0)/Rp[c][c];
+        }
+
+        // C += Cp T, T = Rp T
+        for (int a = 0; a <= i; ++a)
+          for (int c = 0; c < rank; ++c)
+            for (int l = 0; l <= c; ++l)
+              C[a][c] += Cp[a][l]*T[l][c];
+        std::vector<field_type,fAlloc> column(rank);
+        for (int c = 0; c < rank; ++c) {
+          for (int l = 0; l <= c; ++l) {
+            column[l] = 0.0;
+            for (int p = l; p <= c; ++p)
+              column[l] += Rp[l][p]*T[p][c];
+          }
+          for (int l = 0; l <= c; ++l)
+            T[l][c] = column[l];
+        }
+        block = rank;
+      }
+      return block;
+    }
+
+    /* Columns i, ..., i+block-1 of the Hessenberg matrix, H = Rall Bext Rlead^{-1},
+     * where [v_0 ... v_i, old block] = [v_0 ... v_{i+block}] Rall, Bext holds
+     * the previous columns of H and the change of basis B, and Rlead is the
+     * leading square part of Rall.
+     */
+    void hessenbergColumns (DenseMatrix& H, int i, int block, const DenseMatrix& B,
+                            const DenseMatrix& C, const DenseMatrix& T)
+    {
+      const int n = i+block+1;
+      DenseMatrix Rall(n, std::vector<field_type,fAlloc>(n, 0.0));
+      for (int a = 0; a <= i; ++a) {
+        Rall[a][a] = 1.0;
+        for (int c = 0; c < block; ++c)
+          Rall[a][i+1+c] = C[a][c];
+      }
+      for (int l = 0; l < block; ++l)
+        for (int c = l; c < block; ++c)
+          Rall[i+1+l][i+1+c] = T[l][c];
+
+      std::vector<field_type,fAlloc> y(n), z(n);
+      for (int t = 0; t < block; ++t) {
+        const int col = i+t;
+        // y = Rlead^{-1} e_col
+        std::fill(y.begin(), y.end(), field_type(0.0));
+        y[col] = field_type(1.0)/Rall[col][col];
+        for (int a = col-1; a >= 0; --a) {
+          field_type r = 0.0;
+          for (int c = a+1; c <= col; ++c)
+            r += Rall[a][c]*y[c];
+          y[a] = -r/Rall[a][a];
+        }
+        // z = Bext y
+        std::fill(z.begin(), z.end(), field_type(0.0));
+        for (int c = 0; c <= col; ++c) {
+          if (c < i)
+            for (int a = 0; a <= c+1; ++a)
+              z[a] += H[a][c]*y[c];
+          else
+            for (int a = 0; a <= block; ++a)
+              z[i+a] += B[a][c-i]*y[c];
+        }
+        // H[:][col] = Rall z
+        for (int a = 0; a <= col+1; ++a) {
+          field_type h = 0.0;
+          for (int c = a; c < n; ++c)
+            h += Rall[a][c]*z[c];
+          H[a][col] = h;
+        }
+      }
+    }
+
+    // the eigenvalues of the square part of H in Leja order
+    std::vector<std::complex<Simd::Scalar<real_type> > > ritzValues (const DenseMatrix& H, int n)
+    {
+      typedef Simd::Scalar<real_type> K;
+      std::vector<std::vector<std::complex<K> > > Hc(n, std::vector<std::complex<K> >(n));
+      for (int a = 0; a < n; ++a)
+        for (int c = 0; c < n; ++c)
+          Hc[a][c] = H[a][c];
+      auto theta = Impl::hessenbergEigenvalues(Hc);
+      Impl::lejaOrder(theta, std::is_same<field_type,real_type>::value);
+      return theta;
+    }
+
+    using RestartedGMResSolver<X>::_op;
+    using RestartedGMResSolver<X>::_prec;
+    using RestartedGMResSolver<X>::_sp;
+    using RestartedGMResSolver<X>::_maxit;
+    using RestartedGMResSolver<X>::_verbose;
+    using RestartedGMResSolver<X>::_restart;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _sstep;
+    SStepBasis::Type _basis;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("sstepgmressolver", defaultIterativeSolverCreator<Dune::SStepGMResSolver>());
+
+  /**
+     \brief implements the Flexible Generalized Minimal Residual (FGMRes) method (right preconditioned)
+
+     FGMRes solves the right-preconditioned unsymmetric linear system Ax = b using the
+     Flexible Generalized Minimal Residual method. It is flexible because the preconditioner can change in every iteration,
+     which allows to use Krylov solvers without fixed number of iterations as preconditioners. Needs more memory than GMRes.
+
+     \tparam X trial vector, vector type of the solution
+     \tparam Y test vector, vector type of the RHS
+     \tparam F vector type for orthonormal basis of Krylov space
+
+   */
+
+  template<class X, class Y=X, class F = Y>
+  class RestartedFlexibleGMResSolver : public RestartedGMResSolver<X,Y,F>
+  {
+  public:
+    using typename RestartedGMResSolver<X,Y,F>::domain_type;
+    using typename RestartedGMResSolver<X,Y,F>::range_type;
+    using typename RestartedGMResSolver<X,Y,F>::field_type;
+    using typename RestartedGMResSolver<X,Y,F>::real_type;
+
+  private:
+    using typename RestartedGMResSolver<X,Y,F>::scalar_real_type;
+
+    //! \brief field_type Allocator retrieved from domain type
+    using fAlloc = typename RestartedGMResSolver<X,Y,F>::fAlloc;
+    //! \brief real_type Allocator retrieved from domain type
+    using rAlloc = typename RestartedGMResSolver<X,Y,F>::rAlloc;
+
+  public:
+    // copy base class constructors
+    using RestartedGMResSolver<X,Y,F>::RestartedGMResSolver;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using RestartedGMResSolver<X,Y,F>::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+
+       \note Currently, the RestartedFlexibleGMResSolver aborts when it detects a
+             breakdown.
+     */
+    void apply (X& x, Y& b, double reduction, InverseOperatorResult& res) override
+    {
+      using std::abs;
+      const Simd::Scalar<real_type> EPSILON = 1e-80;
+      const int m = _restart;
+      real_type norm = 0.0;
+      int i, j = 1, k;
+      std::vector<field_type,fAlloc> s(m+1), sn(m);
+      std::vector<real_type,rAlloc> cs(m);
+      // helper vector
+      Y tmp(b);
       std::vector< std::vector<field_type,fAlloc> > H(m+1,s);
       std::vector<F> v(m+1,b);
       std::vector<X> w(m+1,b);
 
       Iteration iteration(*this,res);
-      // setup preconditioner if it does something in pre
+      // setup preconditioner if it does something in pre
+
+      // calculate residual and overwrite a copy of the rhs with it
+      _prec->pre(x, b);
+      v[0] = b;
+      _op->applyscaleadd(-1.0, x, v[0]); // b -= Ax
+
+      norm = _sp->norm(v[0]); // the residual norm
+      if(iteration.step(0, norm)){
+        _prec->post(x);
+        return;
+      }
+      const real_type norm_0 = norm;
+
+      // start iterations
+      res.converged = false;;
+      while(j <= _maxit && res.converged != true)
+      {
+        v[0] *= (1.0 / norm);
+        s[0] = norm;
+        for(i=1; i<m+1; ++i)
+          s[i] = 0.0;
+
+        // inner loop
+        for(i=0; i < m && j <= _maxit && res.converged != true; i++, j++)
+        {
+          w[i] = 0.0;
+          // the preconditioner may solve less accurately as the defect decreases
+          _prec->setOuterDefect(static_cast<double>(Simd::max(norm/norm_0)), _reduction);
+          // compute wi = M^-1*vi (also called zi)
+          _prec->apply(w[i], v[i]);
+          // compute vi = A*wi
+          // use v[i+1] as temporary vector for w
+          _op->apply(w[i], v[i+1]);
+          // do Arnoldi algorithm
+          H[i+1][i] = this->orthogonalize(v, i, v[i+1], H);
+          if(Simd::allTrue(abs(H[i+1][i]) < EPSILON))
+            DUNE_THROW(SolverAbort, "breakdown in fGMRes - |w| (-> "
+                                     << w[i] << ") == 0.0 after "
+                                     << j << " iterations");
+
+          // v[i+1] = w*1/H[i+1][i]
+          v[i+1] *= real_type(1.0)/H[i+1][i];
+
+          // update QR factorization
+          for(k=0; k<i; k++)
+            this->applyPlaneRotation(H[k][i],H[k+1][i],cs[k],sn[k]);
+
+          // compute new givens rotation
+          this->generatePlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+
+          // finish updating QR factorization
+          this->applyPlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+          this->applyPlaneRotation(s[i],s[i+1],cs[i],sn[i]);
+
+          // norm of the residual is the last component of vector s
+          using std::abs;
+          norm = abs(s[i+1]);
+          iteration.step(j, norm);
+        } // end inner for loop
+
+        // calculate update vector
+        tmp = 0.0;
+        this->update(tmp, i, H, s, w);
+        // and update current iterate
+        x += tmp;
+
+        // restart fGMRes if convergence was not achieved,
+        // i.e. linear residual has not reached desired reduction
+        // and if still j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit)
+        {
+          if (_verbose > 0)
+            std::cout << "=== fGMRes::restart" << std::endl;
+          // get rhs
+          v[0] = b;
+          // calculate new defect
+          _op->applyscaleadd(-1.0, x,v[0]); // b -= Ax;
+          // calculate preconditioned defect
+          norm = _sp->norm(v[0]); // update the residual norm
+        }
+
+      } // end outer while loop
+
+      // post-process preconditioner
+      _prec->post(x);
+    }
+
+private:
+    using RestartedGMResSolver<X,Y,F>::_op;
+    using RestartedGMResSolver<X,Y,F>::_prec;
+    using RestartedGMResSolver<X,Y,F>::_sp;
+    using RestartedGMResSolver<X,Y,F>::_reduction;
+    using RestartedGMResSolver<X,Y,F>::_maxit;
+    using RestartedGMResSolver<X,Y,F>::_verbose;
+    using RestartedGMResSolver<X,Y,F>::_restart;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("restartedflexiblegmressolver", defaultIterativeSolverCreator<Dune::RestartedFlexibleGMResSolver>());
+
+  /**
+     \brief implements the GCRO-DR method, GMRes with Krylov subspace recycling
+
+     GCRO-DR (generalized conjugate residual method with inner
+     orthogonalization and deflated restarting) is meant for sequences of
+     linear systems with the same or a slowly changing operator. It keeps a
+     subspace U of dimension k spanned by harmonic Ritz vectors of the
+     preconditioned operator \f$W^{-1}A\f$ for the eigenvalues of smallest
+     magnitude, both across restarts and between calls of apply. Each cycle
+     removes the part of the defect in the range of \f$C = W^{-1}AU\f$ and
+     runs restart-k Arnoldi steps with \f$(I - CC^H)W^{-1}A\f$, see
+     M. Parks, E. de Sturler, G. Mackey, D. Johnson, S. Maiti, Recycling
+     Krylov subspaces for sequences of linear systems, SIAM J. Sci. Comput.
+     28(5), 2006.
+
+     As the RestartedGMResSolver it is left preconditioned. At the beginning
+     of apply, C is recomputed from U, so the recycled space stays valid
+     if the operator or the preconditioner changed since the previous solve.
+     This costs k applications of both.
+
+     SIMD field types are not supported.
+
+     \tparam X vector type of the solution, the right hand side and the basis
+   */
+  template<class X>
+  class GCRODRSolver : public RestartedGMResSolver<X>
+  {
+  public:
+    using typename RestartedGMResSolver<X>::domain_type;
+    using typename RestartedGMResSolver<X>::range_type;
+    using typename RestartedGMResSolver<X>::field_type;
+    using typename RestartedGMResSolver<X>::real_type;
+
+  private:
+    using typename RestartedGMResSolver<X>::scalar_real_type;
+
+    //! \brief field_type Allocator retrieved from domain type
+    using fAlloc = typename RestartedGMResSolver<X>::fAlloc;
+    //! \brief real_type Allocator retrieved from domain type
+    using rAlloc = typename RestartedGMResSolver<X>::rAlloc;
+
+    typedef std::vector<std::vector<field_type,fAlloc> > DenseMatrix;
+    typedef std::complex<Simd::Scalar<real_type> > complex_type;
+    typedef std::vector<std::vector<complex_type> > ComplexMatrix;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using RestartedGMResSolver<X>::apply;
+
+    /*!
+       \brief Set up GCRODRSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart, including the recycled vectors
+       \param recycle dimension of the recycled subspace, smaller than restart
+       \param orthogonalization the orthogonalization of the Arnoldi process
+     */
+    GCRODRSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int recycle, int maxit, int verbose,
+                  Orthogonalization::Type orthogonalization = Orthogonalization::mgs) :
+      RestartedGMResSolver<X>(op,prec,reduction,restart,maxit,verbose,orthogonalization),
+      _recycle(recycle)
+    {
+      checkRecycle();
+    }
+
+    /*!
+       \brief Set up GCRODRSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart, including the recycled vectors
+       \param recycle dimension of the recycled subspace, smaller than restart
+       \param orthogonalization the orthogonalization of the Arnoldi process
+     */
+    GCRODRSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int recycle, int maxit, int verbose,
+                  Orthogonalization::Type orthogonalization = Orthogonalization::mgs) :
+      RestartedGMResSolver<X>(op,sp,prec,reduction,restart,maxit,verbose,orthogonalization),
+      _recycle(recycle)
+    {
+      checkRecycle();
+    }
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(L&,S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       restart           | number of GMRes cycles before restart, including the recycled vectors
+       recycle           | dimension of the recycled subspace. default=min(10,restart/2)
+       orthogonalization | orthogonalization of the Arnoldi process, "mgs", "cgs", "cgs2" or "icgs". default=mgs
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    GCRODRSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      RestartedGMResSolver<X>(op,prec,configuration),
+      _recycle(configuration.get<int>("recycle", std::min(10, configuration.get<int>("restart")/2)))
+    {
+      checkRecycle();
+    }
+
+    GCRODRSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      RestartedGMResSolver<X>(op,sp,prec,configuration),
+      _recycle(configuration.get<int>("recycle", std::min(10, configuration.get<int>("restart")/2)))
+    {
+      checkRecycle();
+    }
+
+    //! \brief The current dimension of the recycled subspace.
+    std::size_t recycledDimension () const
+    {
+      return _U.size();
+    }
+
+    //! \brief Discard the recycled subspace, e.g. if the next system is unrelated.
+    void clearRecycledSpace ()
+    {
+      _U.clear();
+      _C.clear();
+    }
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+
+       \note Currently, the GCRODRSolver aborts when it detects a
+             breakdown.
+     */
+    void apply (X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+      if constexpr (!std::is_same<Simd::Scalar<field_type>,field_type>::value)
+        DUNE_THROW(NotImplemented, "the GCRODRSolver does not support SIMD field types");
+      else
+      {
+        using std::abs;
+        const real_type EPSILON = 1e-80;
+        const int m = _restart;
+        real_type norm = 0.0;
+        int j = 1;
+        std::vector<field_type,fAlloc> s(m+1), sn(m), y(m), coefficients;
+        std::vector<real_type,rAlloc> cs(m), scaling;
+        DenseMatrix H(m+1, std::vector<field_type,fAlloc>(m)), G(H), G0(H);
+        // need copy of rhs for the restarts
+        X b2(b);
+        // helper vectors
+        X w(b), r(b);
+        std::vector<X> v(m+1,b);
+        std::vector<const X*> left, right;
+
+        Iteration iteration(*this,res);
+        _prec->pre(x,b);
+
+        // the recycled space of previous solves has to fit the current operator
+        if (!_U.empty())
+          updateOperator(w);
+
+        // calculate defect and overwrite rhs with it
+        _op->applyscaleadd(-1.0,x,b); // b -= Ax
+        // calculate preconditioned defect
+        r = 0.0; _prec->apply(r,b); // r = W^-1 b
+        norm = _sp->norm(r);
+        if(iteration.step(0, norm)){
+          _prec->post(x);
+          return;
+        }
+
+        while(j <= _maxit && res.converged != true) {
+          const int k = _U.size();
+          if (k > 0) {
+            project(x,r);
+            norm = _sp->norm(r);
+            if (norm < EPSILON) {
+              // the solution lies in the recycled space
+              iteration.step(j, norm);
+              break;
+            }
+          }
+
+          // G = [D B; 0 H] with the scaling D of U to unit vectors
+          for (auto& row : G0)
+            std::fill(row.begin(), row.end(), field_type(0.0));
+          left = pointers(_U);
+          const std::vector<field_type> norms2 = _sp->idot(left,left).get();
+          scaling.resize(k);
+          for (int l = 0; l < k; ++l) {
+            using std::sqrt;
+            scaling[l] = real_type(1.0)/sqrt(abs(norms2[l]));
+            G0[l][l] = scaling[l];
+          }
+          G = G0;
+
+          v[0] = r; v[0] *= real_type(1.0)/norm;
+          std::fill(s.begin(), s.end(), field_type(0.0));
+          s[k] = norm;
+
+          int i = 0;
+          for(i=0; i < m-k && j <= _maxit && res.converged != true; i++, j++) {
+            const int col = k+i;
+            // use v[i+1] as temporary vector
+            v[i+1] = 0.0;
+            _op->apply(v[i],v[i+1]);
+            w = 0.0;
+            _prec->apply(w,v[i+1]);
+
+            // orthogonalize against C, then against the Arnoldi basis
+            if (k > 0) {
+              left = pointers(_C);
+              right.assign(k, &w);
+              const std::vector<field_type> dots = _sp->idot(left,right).get();
+              coefficients.resize(k);
+              for (int l = 0; l < k; ++l) {
+                G0[l][col] = dots[l];
+                coefficients[l] = -dots[l];
+              }
+              Impl::maxpy(w,coefficients,left);
+            }
+            H[i+1][i] = this->orthogonalize(v,i,w,H);
+            if(abs(H[i+1][i]) < EPSILON)
+              DUNE_THROW(SolverAbort,
+                         "breakdown in GCRODR - |w| == 0.0 after " << j << " iterations");
+
+            // normalize new vector
+            v[i+1] = w; v[i+1] *= real_type(1.0)/H[i+1][i];
+
+            for (int l = 0; l <= i+1; ++l)
+              G0[k+l][col] = H[l][i];
+            for (int l = 0; l <= col+1; ++l)
+              G[l][col] = G0[l][col];
+
+            // update QR factorization, the leading k rows are not rotated
+            for (int l = 0; l < i; ++l)
+              this->applyPlaneRotation(G[k+l][col],G[k+l+1][col],cs[l],sn[l]);
+            this->generatePlaneRotation(G[col][col],G[col+1][col],cs[i],sn[i]);
+            this->applyPlaneRotation(G[col][col],G[col+1][col],cs[i],sn[i]);
+            this->applyPlaneRotation(s[col],s[col+1],cs[i],sn[i]);
+
+            // norm of the defect is the last component the vector s
+            norm = abs(s[col+1]);
+
+            iteration.step(j, norm);
+          }
+
+          // backsolve and update the iterate with [UD V]y
+          const int n = k+i;
+          for (int a = n-1; a >= 0; --a) {
+            field_type rhs(s[a]);
+            for (int c = a+1; c < n; ++c)
+              rhs -= G[a][c]*y[c];
+            y[a] = rhs/G[a][a];
+          }
+          left = pointers(_U);
+          coefficients.resize(n);
+          for (int l = 0; l < k; ++l)
+            coefficients[l] = y[l]*scaling[l];
+          for (int l = 0; l < i; ++l) {
+            left.push_back(&v[l]);
+            coefficients[k+l] = y[k+l];
+          }
+          Impl::maxpy(x,coefficients,left);
+
+          // recycle harmonic Ritz vectors of this cycle
+          updateRecycledSpace(v,k,i,G0,scaling);
+
+          if (res.converged != true && j <= _maxit) {
+            if(_verbose > 0)
+              std::cout << "=== GCRODR::restart" << std::endl;
+            // get saved rhs
+            b = b2;
+            // calculate new defect
+            _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+            // calculate preconditioned defect
+            r = 0.0;
+            _prec->apply(r,b);
+            norm = _sp->norm(r);
+          }
+        }
+
+        // postprocess preconditioner
+        _prec->post(x);
+      }
+    }
+
+  private:
+    void checkRecycle () const
+    {
+      if (_recycle < 0 || _recycle >= _restart)
+        DUNE_THROW(ISTLError, "the dimension of the recycled space has to be smaller than restart");
+    }
+
+    static std::vector<const X*> pointers (const std::vector<X>& vectors)
+    {
+      std::vector<const X*> result(vectors.size());
+      for (std::size_t l = 0; l < vectors.size(); ++l)
+        result[l] = &vectors[l];
+      return result;
+    }
+
+    /* Recompute C = W^{-1}AU for the current operator and orthonormalize it
+     * by modified Gram-Schmidt, the same transformation is applied to U.
+     * Vectors which became dependent are removed.
+     */
+    void updateOperator (X& tmp)
+    {
+      const Simd::Scalar<real_type> tolerance = 1e4*std::numeric_limits<Simd::Scalar<real_type> >::epsilon();
+      for (std::size_t l = 0; l < _U.size(); ) {
+        tmp = 0.0;
+        _op->apply(_U[l],tmp);
+        _C[l] = 0.0;
+        _prec->apply(_C[l],tmp);
+        const real_type before = _sp->norm(_C[l]);
+        for (std::size_t p = 0; p < l; ++p) {
+          const field_type rpl = _sp->dot(_C[p],_C[l]);
+          _C[l].axpy(-rpl,_C[p]);
+          _U[l].axpy(-rpl,_U[p]);
+        }
+        const real_type rll = _sp->norm(_C[l]);
+        if (rll <= tolerance*before) {
+          _U.erase(_U.begin()+l);
+          _C.erase(_C.begin()+l);
+          continue;
+        }
+        _C[l] *= real_type(1.0)/rll;
+        _U[l] *= real_type(1.0)/rll;
+        ++l;
+      }
+    }
+
+    //! x += U C^H r, r -= C C^H r in a single reduction
+    void project (X& x, X& r) const
+    {
+      const std::vector<const X*> left = pointers(_C), right(_C.size(), &r);
+      std::vector<field_type> dots = _sp->idot(left,right).get();
+      Impl::maxpy(x,dots,pointers(_U));
+      for (auto& d : dots)
+        d = -d;
+      Impl::maxpy(r,dots,left);
+    }
+
+    // eigenvector of M for the eigenvalue mu by inverse iteration
+    static std::vector<complex_type> eigenvector (const ComplexMatrix& M, const complex_type& mu)
+    {
+      using std::abs;
+      const int n = M.size();
+      ComplexMatrix S(M);
+      for (int a = 0; a < n; ++a)
+        S[a][a] -= mu;
+      std::vector<int> pivot;
+      Impl::denseLUFactor(S,pivot);
+      std::vector<complex_type> z(n);
+      for (int a = 0; a < n; ++a)
+        z[a] = 1.0 + Simd::Scalar<real_type>(a)/n;
+      for (int iteration = 0; iteration < 3; ++iteration) {
+        Impl::denseLUSolve(S,pivot,z);
+        Simd::Scalar<real_type> zmax = 0;
+        for (const auto& za : z)
+          zmax = std::max(zmax, abs(za));
+        for (auto& za : z)
+          za /= zmax;
+      }
+      return z;
+    }
+
+    /* Compute the new recycled space from the cycle with the basis
+     * V = [UD v_0 ... v_{i-1}], W = [C v_0 ... v_i] and W^{-1}AV = WG. The
+     * harmonic Ritz vectors Vp solve G^H G p = theta G^H W^H V p, with
+     * GP = QR the new spaces are C = WQ and U = VPR^{-1}.
+     */
+    void updateRecycledSpace (const std::vector<X>& v, int k, int i, const DenseMatrix& G0,
+                              const std::vector<real_type,rAlloc>& scaling)
+    {
+      using std::abs;
+      using std::conj;
+      using std::sqrt;
+      typedef Simd::Scalar<real_type> scalar_type;
+      const int n = k+i;
+      const int dimension = std::min(_recycle, n);
+      if (dimension == 0)
+        return;
+
+      // Phi = W^H V, only the products with U need a reduction
+      ComplexMatrix phi(n+1, std::vector<complex_type>(n, 0.0));
+      if (k > 0) {
+        std::vector<const X*> left, right;
+        for (int c = 0; c < k; ++c) {
+          for (int a = 0; a < k; ++a)
+            left.push_back(&_C[a]);
+          for (int a = 0; a <= i; ++a)
+            left.push_back(&v[a]);
+          right.resize(left.size(), &_U[c]);
+        }
+        const std::vector<field_type> dots = _sp->idot(left,right).get();
+        std::size_t l = 0;
+        for (int c = 0; c < k; ++c)
+          for (int a = 0; a <= n; ++a)
+            phi[a][c] = dots[l++]*scaling[c];
+      }
+      for (int l = 0; l < i; ++l)
+        phi[k+l][k+l] = 1.0;
+
+      // A1 = G^H G, A2 = G^H Phi
+      ComplexMatrix A1(n, std::vector<complex_type>(n, 0.0)), A2(A1);
+      for (int a = 0; a < n; ++a)
+        for (int c = 0; c < n; ++c)
+          for (int l = 0; l <= n; ++l) {
+            A1[a][c] += conj(complex_type(G0[l][a]))*complex_type(G0[l][c]);
+            A2[a][c] += conj(complex_type(G0[l][a]))*phi[l][c];
+          }
+
+      // the harmonic Ritz values of smallest magnitude are the eigenvalues
+      // mu = 1/theta of A1^{-1} A2 of largest magnitude
+      std::vector<int> pivot;
+      Impl::denseLUFactor(A1,pivot);
+      ComplexMatrix M(n, std::vector<complex_type>(n));
+      std::vector<complex_type> column(n);
+      for (int c = 0; c < n; ++c) {
+        for (int a = 0; a < n; ++a)
+          column[a] = A2[a][c];
+        Impl::denseLUSolve(A1,pivot,column);
+        for (int a = 0; a < n; ++a)
+          M[a][c] = column[a];
+      }
+      ComplexMatrix T(M);
+      Impl::hessenbergReduction(T);
+      std::vector<complex_type> mu = Impl::hessenbergEigenvalues(T);
+      std::sort(mu.begin(), mu.end(), [](const complex_type& a, const complex_type& b){
+          return abs(a) > abs(b);
+        });
+
+      // the coefficients P, for real field types the real and imaginary
+      // part of the eigenvector of one of a complex conjugate pair
+      const scalar_type tolerance = sqrt(std::numeric_limits<scalar_type>::epsilon());
+      std::vector<std::vector<field_type,fAlloc> > P;
+      for (int l = 0; l < n && int(P.size()) < dimension; ++l) {
+        const bool isComplex = abs(mu[l].imag()) > tolerance*abs(mu[l]);
+        if constexpr (std::is_same<field_type,real_type>::value) {
+          if (isComplex && mu[l].imag() < 0)
+            continue;
+        }
+        const std::vector<complex_type> z = eigenvector(M,mu[l]);
+        std::vector<field_type,fAlloc> p(n);
+        if constexpr (std::is_same<field_type,real_type>::value) {
+          for (int a = 0; a < n; ++a)
+            p[a] = z[a].real();
+          P.push_back(p);
+          if (isComplex && int(P.size()) < dimension) {
+            for (int a = 0; a < n; ++a)
+              p[a] = z[a].imag();
+            P.push_back(p);
+          }
+        }
+        else {
+          for (int a = 0; a < n; ++a)
+            p[a] = z[a];
+          P.push_back(p);
+        }
+      }
+
+      // GP = QR by modified Gram-Schmidt with reorthogonalization,
+      // dependent columns are removed together with their column of P
+      std::vector<std::vector<field_type,fAlloc> > Q, R, Pkept;
+      for (const auto& p : P) {
+        std::vector<field_type,fAlloc> q(n+1, 0.0), rcol(P.size(), 0.0);
+        for (int a = 0; a <= n; ++a)
+          for (int c = 0; c < n; ++c)
+            q[a] += G0[a][c]*p[c];
+        auto norm = [&](){
+          scalar_type sum = 0;
+          for (const auto& qa : q)
+            sum += abs(qa)*abs(qa);
+          return sqrt(sum);
+        };
+        const scalar_type before = norm();
+        for (int pass = 0; pass < 2; ++pass)
+          for (std::size_t l = 0; l < Q.size(); ++l) {
+            field_type d = 0.0;
+            for (int a = 0; a <= n; ++a)
+              d += this->conjugate(Q[l][a])*q[a];
+            rcol[l] += d;
+            for (int a = 0; a <= n; ++a)
+              q[a] -= d*Q[l][a];
+          }
+        const scalar_type after = norm();
+        if (after <= tolerance*before)
+          continue;
+        for (auto& qa : q)
+          qa /= after;
+        rcol[Q.size()] = after;
+        Q.push_back(q);
+        R.push_back(rcol);
+        Pkept.push_back(p);
+      }
+
+      // C = WQ, U = VPR^{-1}
+      std::vector<const X*> W = pointers(_C), V = pointers(_U);
+      for (int l = 0; l <= i; ++l)
+        W.push_back(&v[l]);
+      for (int l = 0; l < i; ++l)
+        V.push_back(&v[l]);
+      std::vector<X> C(Q.size(), v[0]), U(Q.size(), v[0]);
+      std::vector<field_type,fAlloc> coefficients(n);
+      for (std::size_t c = 0; c < Q.size(); ++c) {
+        C[c] = 0.0;
+        Impl::maxpy(C[c],Q[c],W);
+        for (int a = 0; a < n; ++a)
+          coefficients[a] = (a < k) ? Pkept[c][a]*scaling[a] : Pkept[c][a];
+        U[c] = 0.0;
+        Impl::maxpy(U[c],coefficients,V);
+        for (std::size_t l = 0; l < c; ++l)
+          U[c].axpy(-R[c][l],U[l]);
+        U[c] *= field_type(1.0)/R[c][c];
+      }
+      _C = std::move(C);
+      _U = std::move(U);
+    }
+
+    using RestartedGMResSolver<X>::_op;
+    using RestartedGMResSolver<X>::_prec;
+    using RestartedGMResSolver<X>::_sp;
+    using RestartedGMResSolver<X>::_maxit;
+    using RestartedGMResSolver<X>::_verbose;
+    using RestartedGMResSolver<X>::_restart;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _recycle;
+    //! \brief The recycled subspace U and its image C = W^{-1}AU with orthonormal columns.
+    std::vector<X> _U, _C;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("gcrodrsolver", defaultIterativeSolverCreator<Dune::GCRODRSolver>());
+
+  namespace Impl {
+
+    /* Cholesky factorization G = R^H R of the Hermitian lanes x lanes matrix
+     * G, stored row wise. A lane whose pivot is small relative to its
+     * diagonal entry of G, i.e. which depends linearly on the previous
+     * lanes, is deactivated and gets a zero row in R.
+     */
+    template<class S>
+    void laneCholesky (const std::vector<S>& G, std::vector<S>& R, std::vector<bool>& active)
+    {
+      using std::real;
+      using std::sqrt;
+      typedef typename FieldTraits<S>::real_type real_type;
+      const std::size_t k = active.size();
+      const real_type tolerance = sqrt(std::numeric_limits<real_type>::epsilon());
+      std::fill(R.begin(), R.end(), S(0));
+      for (std::size_t c = 0; c < k; ++c)
+      {
+        const real_type diagonal = real(G[c*k+c]);
+        real_type pivot = diagonal;
+        for (std::size_t l = 0; l < c; ++l)
+          pivot -= real(conjugateComplex(R[l*k+c])*R[l*k+c]);
+        active[c] = active[c] && diagonal > 0 && pivot > tolerance*diagonal;
+        if (!active[c])
+          continue;
+        R[c*k+c] = sqrt(pivot);
+        for (std::size_t j = c+1; j < k; ++j)
+        {
+          S sum = G[c*k+j];
+          for (std::size_t l = 0; l < c; ++l)
+            sum -= conjugateComplex(R[l*k+c])*R[l*k+j];
+          R[c*k+j] = sum/R[c*k+c];
+        }
+      }
+    }
+
+    //! Inverse of the upper triangular R on the active lanes, zero elsewhere
+    template<class S>
+    std::vector<S> laneTriangularInverse (const std::vector<S>& R, const std::vector<bool>& active)
+    {
+      const std::size_t k = active.size();
+      std::vector<S> T(k*k, S(0));
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        if (!active[j])
+          continue;
+        T[j*k+j] = S(1)/R[j*k+j];
+        for (std::size_t i = j; i-- > 0; )
+        {
+          if (!active[i])
+            continue;
+          S sum = 0;
+          for (std::size_t l = i+1; l <= j; ++l)
+            sum += R[i*k+l]*T[l*k+j];
+          T[i*k+j] = -sum/R[i*k+i];
+        }
+      }
+      return T;
+    }
+
+    /* Orthonormalize the lanes of w by Cholesky QR applied twice, w = QR.
+     * On return w holds Q, whose lanes that are not active are zero.
+     */
+    template<class X, class S>
+    void laneOrthonormalize (const ScalarProduct<X>& sp, X& w, std::vector<S>& R, std::vector<bool>& active)
+    {
+      typedef typename X::field_type field_type;
+      const std::size_t k = active.size();
+      std::vector<S> R1(k*k), R2(k*k);
+      X q(w);
+      laneCholesky(sp.blockDot(w,w), R1, active);
+      q = 0.0;
+      Imp::addLaneCombination<field_type>(q, w, laneTriangularInverse(R1, active));
+      laneCholesky(sp.blockDot(q,q), R2, active);
+      w = 0.0;
+      Imp::addLaneCombination<field_type>(w, q, laneTriangularInverse(R2, active));
+      for (std::size_t a = 0; a < k; ++a)
+        for (std::size_t b = 0; b < k; ++b)
+        {
+          R[a*k+b] = 0;
+          for (std::size_t l = a; l <= b; ++l)
+            R[a*k+b] += R2[a*k+l]*R1[l*k+b];
+        }
+    }
+
+    /* Solve AX = B for the Hermitian positive definite lanes x lanes matrix
+     * A restricted to the active lanes, B is overwritten by X. The rows of
+     * X for lanes that are not active are zero.
+     */
+    template<class S>
+    void laneSolve (const std::vector<S>& A, std::vector<S>& B, std::vector<bool> active)
+    {
+      const std::size_t k = active.size();
+      std::vector<S> R(k*k);
+      laneCholesky(A, R, active);
+      for (std::size_t b = 0; b < k; ++b)
+      {
+        // R^H y = B, then R x = y
+        for (std::size_t i = 0; i < k; ++i)
+        {
+          if (!active[i])
+          {
+            B[i*k+b] = 0;
+            continue;
+          }
+          for (std::size_t l = 0; l < i; ++l)
+            B[i*k+b] -= conjugateComplex(R[l*k+i])*B[l*k+b];
+          B[i*k+b] /= conjugateComplex(R[i*k+i]);
+        }
+        for (std::size_t i = k; i-- > 0; )
+        {
+          if (!active[i])
+            continue;
+          for (std::size_t l = i+1; l < k; ++l)
+            B[i*k+b] -= R[i*k+l]*B[l*k+b];
+          B[i*k+b] /= R[i*k+i];
+        }
+      }
+    }
+
+    //! Givens rotation for scalar field types, zeroes dy
+    template<class S>
+    void laneGivens (const S& dx, const S& dy, typename FieldTraits<S>::real_type& cs, S& sn)
+    {
+      using std::abs;
+      using std::sqrt;
+      typedef typename FieldTraits<S>::real_type real_type;
+      const real_type nx = abs(dx), ny = abs(dy);
+      const real_type nr = sqrt(nx*nx + ny*ny);
+      cs = (nr > 0) ? nx/nr : real_type(1);
+      sn = (nr > 0) ? ((nx > 0) ? dx/nx : S(1))*conjugateComplex(dy)/nr : S(0);
+    }
+
+    template<class S>
+    void laneApplyGivens (S& dx, S& dy, const typename FieldTraits<S>::real_type& cs, const S& sn)
+    {
+      const S temp = cs*dx + sn*dy;
+      dy = -conjugateComplex(sn)*dx + cs*dy;
+      dx = temp;
+    }
+
+  } // end namespace Impl
+
+  /**
+     \brief Breakdown-free block conjugate gradient method
+
+     Solves for several right hand sides at once. The lanes of a SIMD
+     field_type are the columns of the multi-vectors, e.g. a
+     BlockVector<FieldVector<LoopSIMD<double,n>,1> > holds n right hand
+     sides. Applying a matrix with scalar entries to such a vector is a
+     sparse matrix times multi-vector product, and all scalar products of
+     the columns of two multi-vectors are computed in one reduction by
+     ScalarProduct::blockDot.
+
+     The search space is shared by all right hand sides, so each of them
+     converges at least as fast as with the CGSolver. Linearly dependent
+     columns of the search directions are dropped, see H. Ji, Y. Li, A
+     breakdown-free block conjugate gradient method, BIT Numer. Math. 57,
+     2017. For scalar field types the method reduces to the CGSolver.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class BlockCGSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+    // copy base class constructors
+    using IterativeSolver<X,X>::IterativeSolver;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      typedef Simd::Scalar<field_type> scalar_type;
+      constexpr std::size_t k = Simd::lanes<field_type>();
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect
+
+      real_type def = _sp->norm(b); // compute norm
+      if(iteration.step(0, def)){
+        _prec->post(x);
+        return;
+      }
+
+      X p(x);              // the search directions
+      X q(x);              // the search directions times the operator
+      X z(x);              // the preconditioned defect
+
+      std::vector<scalar_type> R(k*k);
+      std::vector<bool> active(k, true);
+
+      // determine initial search directions
+      p = 0;
+      _prec->apply(p,b);
+      Impl::laneOrthonormalize(*_sp,p,R,active);
+
+      // the loop
+      int i=1;
+      for ( ; i<=_maxit; i++ )
+      {
+        // minimize in the space of the search directions, alpha = (P^H AP)^{-1} P^H R
+        _op->apply(p,q);
+        const auto pq = _sp->blockDot(p,q);
+        auto alpha = _sp->blockDot(p,b);
+        Impl::laneSolve(pq,alpha,active);
+        Imp::addLaneCombination<field_type>(x,p,alpha);
+        for (auto& a : alpha)
+          a = -a;
+        Imp::addLaneCombination<field_type>(b,q,alpha);
+
+        // convergence test
+        def=_sp->norm(b);
+        if(iteration.step(i, def))
+          break;
+
+        // new search directions, P = orth(Z + P beta) with beta = -(P^H AP)^{-1} Q^H Z
+        z = 0;
+        _prec->apply(z,b);
+        auto beta = _sp->blockDot(q,z);
+        Impl::laneSolve(pq,beta,active);
+        for (auto& a : beta)
+          a = -a;
+        Imp::addLaneCombination<field_type>(z,p,beta);
+        p = z;
+        std::fill(active.begin(), active.end(), true);
+        Impl::laneOrthonormalize(*_sp,p,R,active);
+        if (std::none_of(active.begin(), active.end(), [](bool a){ return a; }))
+          DUNE_THROW(SolverAbort,
+                     "breakdown in BlockCG - no search direction left after " << i << " iterations");
+      }
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("blockcgsolver", defaultIterativeSolverCreator<Dune::BlockCGSolver>());
+
+  /**
+     \brief implements the block GMRes method for several right hand sides
+
+     The multi-vectors are vectors with a SIMD field_type as for the
+     BlockCGSolver. All right hand sides share the block Krylov space of
+     the left preconditioned operator, the block Arnoldi process
+     orthogonalizes by block classical Gram-Schmidt applied twice, where
+     each block scalar product is a single reduction, and Cholesky QR.
+     The residual norms of all right hand sides are minimized by a QR
+     factorization of the banded block Hessenberg matrix. Linearly
+     dependent columns of the Krylov basis are dropped. For scalar field
+     types the method reduces to the RestartedGMResSolver.
+
+     \tparam X vector type of the solution, the right hand side and the basis
+   */
+  template<class X>
+  class BlockGMResSolver : public IterativeSolver<X,X>
+  {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+  private:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Set up BlockGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
+       \param restart number of block Arnoldi steps before restart
+     */
+    BlockGMResSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,reduction,maxit,verbose),
+      _restart(restart)
+    {}
+
+    /*!
+       \brief Set up BlockGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
+       \param restart number of block Arnoldi steps before restart
+     */
+    BlockGMResSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
+      _restart(restart)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(L&,S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       restart           | number of block Arnoldi steps before restart
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    BlockGMResSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,configuration),
+      _restart(configuration.get<int>("restart"))
+    {}
+
+    BlockGMResSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,configuration),
+      _restart(configuration.get<int>("restart"))
+    {}
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::sqrt;
+      typedef Simd::Scalar<field_type> scalar_type;
+      typedef typename FieldTraits<scalar_type>::real_type scalar_real;
+      typedef std::vector<std::vector<scalar_type> > DenseMatrix;
+      const std::size_t k = Simd::lanes<field_type>();
+      const int m = _restart;
+      const std::size_t rows = (m+1)*k, cols = m*k;
+
+      // need copy of rhs if GMRes has to be restarted
+      X b2(b);
+      // helper vector
+      X w(b);
+      std::vector<X> v(m+1,b);
+      // the block Hessenberg matrix, its Givens rotations and the rotated block right hand side
+      DenseMatrix H(rows, std::vector<scalar_type>(cols)), s(rows, std::vector<scalar_type>(k));
+      std::vector<std::vector<scalar_real> > cs(cols, std::vector<scalar_real>(k));
+      DenseMatrix sn(cols, std::vector<scalar_type>(k));
+      std::vector<std::vector<bool> > active(m+1, std::vector<bool>(k));
+      std::vector<scalar_type> R(k*k), Y(k*k);
+      real_type def;
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);
+
+      // calculate defect and overwrite rhs with it
+      _op->applyscaleadd(-1.0,x,b); // b -= Ax
+      // calculate preconditioned defect
+      v[0] = 0.0; _prec->apply(v[0],b); // r = W^-1 b
+      def = _sp->norm(v[0]);
+      if(iteration.step(0, def)){
+        _prec->post(x);
+        return;
+      }
+
+      int j = 1;
+      while(j <= _maxit && res.converged != true) {
+
+        // QR factorization of the defect, the first basis block
+        std::fill(active[0].begin(), active[0].end(), true);
+        Impl::laneOrthonormalize(*_sp,v[0],R,active[0]);
+        for (auto& row : H)
+          std::fill(row.begin(), row.end(), scalar_type(0));
+        for (std::size_t r = 0; r < rows; ++r)
+          for (std::size_t c = 0; c < k; ++c)
+            s[r][c] = (r < k) ? R[r*k+c] : scalar_type(0);
+
+        int i = 0;
+        for(i=0; i < m && j <= _maxit && res.converged != true; i++, j++) {
+          // block Arnoldi step with block classical Gram-Schmidt applied twice
+          _op->apply(v[i],w);
+          v[i+1] = 0.0;
+          _prec->apply(v[i+1],w);
+          for (int pass = 0; pass < 2; ++pass)
+            for (int l = 0; l <= i; ++l) {
+              auto h = _sp->blockDot(v[l],v[i+1]);
+              for (std::size_t a = 0; a < k; ++a)
+                for (std::size_t c = 0; c < k; ++c) {
+                  H[l*k+a][i*k+c] += h[a*k+c];
+                  h[a*k+c] = -h[a*k+c];
+                }
+              Imp::addLaneCombination<field_type>(v[i+1],v[l],h);
+            }
+          std::fill(active[i+1].begin(), active[i+1].end(), true);
+          Impl::laneOrthonormalize(*_sp,v[i+1],R,active[i+1]);
+          for (std::size_t a = 0; a < k; ++a)
+            for (std::size_t c = 0; c < k; ++c)
+              H[(i+1)*k+a][i*k+c] = R[a*k+c];
+
+          // update the QR factorization column by column, the columns
+          // of dropped basis vectors are zero and get a unit diagonal
+          for (std::size_t c = i*k; c < (i+1)*k; ++c) {
+            if (!active[i][c-i*k])
+              H[c][c] = 1.0;
+            for (std::size_t l = 0; l < c; ++l)
+              for (std::size_t t = 0; t < k; ++t)
+                Impl::laneApplyGivens(H[l+k-t-1][c],H[l+k-t][c],cs[l][t],sn[l][t]);
+            for (std::size_t t = 0; t < k; ++t) {
+              const std::size_t r = c+k-t;
+              Impl::laneGivens(H[r-1][c],H[r][c],cs[c][t],sn[c][t]);
+              Impl::laneApplyGivens(H[r-1][c],H[r][c],cs[c][t],sn[c][t]);
+              for (std::size_t e = 0; e < k; ++e)
+                Impl::laneApplyGivens(s[r-1][e],s[r][e],cs[c][t],sn[c][t]);
+            }
+          }
+
+          // the norms of the defects are the norms of the columns of the last block of s
+          for (std::size_t e = 0; e < k; ++e) {
+            scalar_real norm2 = 0.0;
+            for (std::size_t r = (i+1)*k; r < (i+2)*k; ++r)
+              norm2 += abs(s[r][e])*abs(s[r][e]);
+            Simd::lane(e,def) = sqrt(norm2);
+          }
+
+          iteration.step(j, def);
+
+        } // end for
+
+        // solve the triangular system and update the iterate, x += V y
+        const std::size_t n = i*k;
+        DenseMatrix y(n, std::vector<scalar_type>(k));
+        for (std::size_t r = n; r-- > 0; )
+          for (std::size_t e = 0; e < k; ++e) {
+            scalar_type sum = s[r][e];
+            for (std::size_t c = r+1; c < n; ++c)
+              sum -= H[r][c]*y[c][e];
+            y[r][e] = sum/H[r][r];
+          }
+        for (int l = 0; l < i; ++l) {
+          for (std::size_t a = 0; a < k; ++a)
+            for (std::size_t e = 0; e < k; ++e)
+              Y[a*k+e] = y[l*k+a][e];
+          Imp::addLaneCombination<field_type>(x,v[l],Y);
+        }
+
+        // restart GMRes if convergence was not achieved,
+        // i.e. linear defect has not reached desired reduction
+        // and if j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit ) {
+
+          if(_verbose > 0)
+            std::cout << "=== BlockGMRes::restart" << std::endl;
+          // get saved rhs
+          b = b2;
+          // calculate new defect
+          _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+          // calculate preconditioned defect
+          v[0] = 0.0;
+          _prec->apply(v[0],b);
+        }
+
+      } //end while
+
+      // postprocess preconditioner
+      _prec->post(x);
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using IterativeSolver<X,X>::_verbose;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _restart;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("blockgmressolver", defaultIterativeSolverCreator<Dune::BlockGMResSolver>());
+
+  namespace Impl {
+
+    //! Fill a (possibly nested) vector with pseudo random numbers in [-1,1]
+    template<class V, class G>
+    void randomize (V& v, G& generator)
+    {
+      if constexpr (IsNumber<V>::value)
+      {
+        typedef typename FieldTraits<Simd::Scalar<V> >::real_type real_type;
+        std::uniform_real_distribution<real_type> distribution(-1.0, 1.0);
+        for (std::size_t l = 0; l < Simd::lanes<V>(); ++l)
+          Simd::lane(l,v) = distribution(generator);
+      }
+      else
+        Hybrid::forEach(v, [&](auto&& block) { randomize(block, generator); });
+    }
+
+  } // end namespace Impl
+
+  /**
+     \brief Induced dimension reduction method IDR(s)
+
+     IDR(s) for nonsymmetric systems with short recurrences, in the
+     variant with biorthogonalization of M. B. van Gijzen, P. Sonneveld,
+     Algorithm 913: An elegant IDR(s) variant that efficiently exploits
+     biorthogonality properties, ACM Trans. Math. Softw. 38(1), 2011.
+     It stores 3s+3 vectors, for s=1 it is mathematically equivalent to
+     BiCGSTAB, larger s usually converge in fewer iterations and are more
+     robust for convection dominated problems.
+
+     The shadow space is spanned by s orthonormalized pseudo random
+     vectors. The s scalar products with the shadow vectors needed in each
+     step are computed by a single call of ScalarProduct::idot and the
+     vector updates by the fused kernel maxpy, so each iteration needs two
+     global reductions. The method is right preconditioned, i.e. the
+     defect norm is the one of the unpreconditioned system. One iteration
+     is one application of the operator and the preconditioner.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class IDRSSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+  private:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Set up IDRSSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
+       \param s dimension of the shadow space
+     */
+    IDRSSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int s, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,reduction,maxit,verbose),
+      _s(s)
+    {
+      checkShadowSpace();
+    }
+
+    /*!
+       \brief Set up IDRSSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
+       \param s dimension of the shadow space
+     */
+    IDRSSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int s, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
+      _s(s)
+    {
+      checkShadowSpace();
+    }
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(L&,S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       s                 | dimension of the shadow space. default=4
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    IDRSSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,configuration),
+      _s(configuration.get<int>("s", 4))
+    {
+      checkShadowSpace();
+    }
+
+    IDRSSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,configuration),
+      _s(configuration.get<int>("s", 4))
+    {
+      checkShadowSpace();
+    }
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+
+       \note Currently, the IDRSSolver aborts when it detects a breakdown.
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::sqrt;
+      const Simd::Scalar<real_type> EPSILON=1e-80;
+      // minimal angle between t and r for the choice of omega
+      const real_type kappa = 0.7;
+      const int s = _s;
+
+      X& r=b;
+      X v(x);
+      X t(x);
+      std::vector<X> P(s,x), G(s,x), U(s,x);
+      // M = P^H G is lower triangular due to the biorthogonalization
+      std::vector<std::vector<field_type> > M(s, std::vector<field_type>(s, 0.0));
+      std::vector<field_type> f(s), c(s), coefficients;
+      std::vector<const X*> shadow(s), left;
+      field_type omega = 1.0;
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,r);             // prepare preconditioner
 
-      // calculate residual and overwrite a copy of the rhs with it
-      _prec->pre(x, b);
-      v[0] = b;
-      _op->applyscaleadd(-1.0, x, v[0]); // b -= Ax
+      _op->applyscaleadd(-1,x,r);  // overwrite b with defect
 
-      norm = _sp->norm(v[0]); // the residual norm
+      real_type norm = _sp->norm(r);
       if(iteration.step(0, norm)){
         _prec->post(x);
         return;
       }
 
-      // start iterations
-      res.converged = false;;
-      while(j <= _maxit && res.converged != true)
-      {
-        v[0] *= (1.0 / norm);
-        s[0] = norm;
-        for(i=1; i<m+1; ++i)
-          s[i] = 0.0;
+      // the shadow space
+      std::mt19937 generator;
+      for (int k = 0; k < s; ++k) {
+        Impl::randomize(P[k], generator);
+        for (int l = 0; l < k; ++l)
+          P[k].axpy(-_sp->dot(P[l],P[k]),P[l]);
+        P[k] *= real_type(1.0)/_sp->norm(P[k]);
+        shadow[k] = &P[k];
+        G[k] = 0.0;
+        U[k] = 0.0;
+        M[k][k] = 1.0;
+      }
 
-        // inner loop
-        for(i=0; i < m && j <= _maxit && res.converged != true; i++, j++)
-        {
-          w[i] = 0.0;
-          // compute wi = M^-1*vi (also called zi)
-          _prec->apply(w[i], v[i]);
-          // compute vi = A*wi
-          // use v[i+1] as temporary vector for w
-          _op->apply(w[i], v[i+1]);
-          // do Arnoldi algorithm
-          for(int k=0; k<i+1; k++)
-          {
-            // notice that _sp->dot(v[k],v[i+1]) = v[k]\adjoint v[i+1]
-            // so one has to pay attention to the order
-            // in the scalar product for the complex case
-            // doing the modified Gram-Schmidt algorithm
-            H[k][i] = _sp->dot(v[k],v[i+1]);
-            // w -= H[k][i] * v[k]
-            v[i+1].axpy(-H[k][i], v[k]);
+      int i = 0;
+      bool converged = false;
+      while (i < _maxit && !converged) {
+        // f = P^H r
+        f = _sp->idot(shadow, std::vector<const X*>(s,&r)).get();
+
+        for (int k = 0; k < s && i < _maxit; ++k) {
+          // solve the lower triangular system M(k:s,k:s) c = f(k:s)
+          for (int l = k; l < s; ++l) {
+            c[l] = f[l];
+            for (int m = k; m < l; ++m)
+              c[l] -= M[l][m]*c[m];
+            c[l] /= M[l][l];
           }
-          H[i+1][i] = _sp->norm(v[i+1]);
-          if(Simd::allTrue(abs(H[i+1][i]) < EPSILON))
-            DUNE_THROW(SolverAbort, "breakdown in fGMRes - |w| (-> "
-                                     << w[i] << ") == 0.0 after "
-                                     << j << " iterations");
 
-          // v[i+1] = w*1/H[i+1][i]
-          v[i+1] *= real_type(1.0)/H[i+1][i];
+          // v = W^-1 (r - G(:,k:s) c)
+          left.assign(s-k, nullptr);
+          coefficients.resize(s-k);
+          for (int l = k; l < s; ++l) {
+            left[l-k] = &G[l];
+            coefficients[l-k] = -c[l];
+          }
+          t = r;
+          Impl::maxpy(t,coefficients,left);
+          v = 0;
+          _prec->apply(v,t);
+
+          // U(:,k) = omega v + U(:,k:s) c, G(:,k) = A U(:,k)
+          for (int l = k; l < s; ++l) {
+            left[l-k] = &U[l];
+            coefficients[l-k] = c[l];
+          }
+          t = v;
+          t *= omega;
+          Impl::maxpy(t,coefficients,left);
+          U[k] = t;
+          _op->apply(U[k],G[k]);
+          ++i;
 
-          // update QR factorization
-          for(k=0; k<i; k++)
-            this->applyPlaneRotation(H[k][i],H[k+1][i],cs[k],sn[k]);
+          // make G(:,k) orthogonal to P(:,0:k), all products in one reduction
+          auto d = _sp->idot(shadow, std::vector<const X*>(s,&G[k])).get();
+          coefficients.resize(k);
+          for (int l = 0; l < k; ++l) {
+            c[l] = d[l];
+            for (int m = 0; m < l; ++m)
+              c[l] -= M[l][m]*c[m];
+            c[l] /= M[l][l];
+            coefficients[l] = -c[l];
+          }
+          if (k > 0) {
+            left.assign(k, nullptr);
+            for (int l = 0; l < k; ++l)
+              left[l] = &G[l];
+            Impl::maxpy(G[k],coefficients,left);
+            for (int l = 0; l < k; ++l)
+              left[l] = &U[l];
+            Impl::maxpy(U[k],coefficients,left);
+          }
 
-          // compute new givens rotation
-          this->generatePlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+          // new column of M = P^H G
+          for (int l = k; l < s; ++l) {
+            M[l][k] = d[l];
+            for (int m = 0; m < k; ++m)
+              M[l][k] -= c[m]*M[l][m];
+          }
+          if (Simd::allTrue(abs(M[k][k]) <= EPSILON))
+            DUNE_THROW(SolverAbort,"breakdown in IDR(s) - M[k][k] "
+                       << Simd::io(M[k][k]) << " <= EPSILON " << EPSILON
+                       << " after " << i << " iterations");
+
+          // make r orthogonal to P(:,0:k+1)
+          const field_type beta = f[k]/M[k][k];
+          r.axpy(-beta,G[k]);
+          x.axpy(beta,U[k]);
+
+          norm = _sp->norm(r);
+          if (iteration.step(i, norm)) {
+            converged = true;
+            break;
+          }
 
-          // finish updating QR factorization
-          this->applyPlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
-          this->applyPlaneRotation(s[i],s[i+1],cs[i],sn[i]);
+          for (int l = k+1; l < s; ++l)
+            f[l] -= beta*M[l][k];
+        }
 
-          // norm of the residual is the last component of vector s
-          using std::abs;
-          norm = abs(s[i+1]);
-          iteration.step(j, norm);
-        } // end inner for loop
+        if (converged || i >= _maxit)
+          break;
 
-        // calculate update vector
-        tmp = 0.0;
-        this->update(tmp, i, H, s, w);
-        // and update current iterate
-        x += tmp;
+        // dimension reduction step, enter the next space
+        v = 0;
+        _prec->apply(v,r);
+        _op->apply(v,t);
+        ++i;
+
+        // omega = (t,r)/(t,t), increased if t and r are almost orthogonal
+        auto tr = _sp->idot({&t,&t}, {&r,&t}).get();
+        omega = tr[0]/tr[1];
+        const real_type rho = abs(tr[0])/(sqrt(abs(tr[1]))*norm);
+        omega = Simd::cond(rho < kappa, field_type(omega*kappa/rho), omega);
+        if (Simd::allTrue(abs(omega) <= EPSILON))
+          DUNE_THROW(SolverAbort,"breakdown in IDR(s) - omega "
+                     << Simd::io(omega) << " <= EPSILON " << EPSILON
+                     << " after " << i << " iterations");
 
-        // restart fGMRes if convergence was not achieved,
-        // i.e. linear residual has not reached desired reduction
-        // and if still j < _maxit (do not restart on last iteration)
-        if( res.converged != true && j < _maxit)
-        {
-          if (_verbose > 0)
-            std::cout << "=== fGMRes::restart" << std::endl;
-          // get rhs
-          v[0] = b;
-          // calculate new defect
-          _op->applyscaleadd(-1.0, x,v[0]); // b -= Ax;
-          // calculate preconditioned defect
-          norm = _sp->norm(v[0]); // update the residual norm
+        r.axpy(-omega,t);
+        x.axpy(omega,v);
+
+        norm = _sp->norm(r);
+        if (iteration.step(i, norm))
+          break;
+      }
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  private:
+    void checkShadowSpace () const
+    {
+      if (_s < 1)
+        DUNE_THROW(InvalidStateException, "IDRSSolver: the dimension of the shadow space has to be positive");
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _s;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("idrssolver", defaultIterativeSolverCreator<Dune::IDRSSolver>());
+
+  /**
+     \brief BiCGStab(l), BiCGSTAB with stabilizing polynomials of degree l
+
+     Each cycle performs l BiCG steps followed by the minimization of the
+     defect over a polynomial of degree l, which repairs the stagnation of
+     BiCGSTAB for operators with eigenvalues close to the imaginary axis,
+     e.g. for convection dominated problems, see G. L. G. Sleijpen,
+     D. R. Fokkema, BiCGstab(l) for linear equations involving unsymmetric
+     matrices with complex spectrum, ETNA 1, 1993. For l=1 it is
+     mathematically equivalent to BiCGSTAB. It stores 2l+5 vectors.
+
+     The minimization uses the normal equations, whose matrix is computed
+     by a single call of ScalarProduct::idot, and the vector updates use
+     the fused kernel maxpy. The method is right preconditioned, i.e. the
+     defect norm is the one of the unpreconditioned system and the defect
+     is checked after each cycle. One iteration is one BiCG step, i.e. two
+     applications of the operator and the preconditioner as for the
+     BiCGSTABSolver.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class BiCGSTABLSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+  private:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Set up BiCGSTABLSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,P&,double,int,int)
+       \param l degree of the stabilizing polynomials
+     */
+    BiCGSTABLSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int l, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,reduction,maxit,verbose),
+      _l(l)
+    {
+      checkDegree();
+    }
+
+    /*!
+       \brief Set up BiCGSTABLSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(L&,S&,P&,double,int,int)
+       \param l degree of the stabilizing polynomials
+     */
+    BiCGSTABLSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int l, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
+      _l(l)
+    {
+      checkDegree();
+    }
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(L&,S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       l                 | degree of the stabilizing polynomials. default=2
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    BiCGSTABLSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,configuration),
+      _l(configuration.get<int>("l", 2))
+    {
+      checkDegree();
+    }
+
+    BiCGSTABLSolver (std::shared_ptr<LinearOperator<X,X> > op, std::shared_ptr<ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,configuration),
+      _l(configuration.get<int>("l", 2))
+    {
+      checkDegree();
+    }
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+
+       \note Currently, the BiCGSTABLSolver aborts when it detects a breakdown.
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::abs;
+      const Simd::Scalar<real_type> EPSILON=1e-80;
+      const int l = _l;
+
+      // the defects and search directions of the BiCG steps, the shadow
+      // defect and the update in the preconditioned variables
+      std::vector<X> rh(l+1,x), uh(l+1,x);
+      X rt(x);
+      X xt(x);
+      X v(x);
+      std::vector<field_type> gamma(l), coefficients(l);
+      std::vector<const X*> left, right;
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect
+
+      real_type norm = _sp->norm(b);
+      if(iteration.step(0, norm)){
+        _prec->post(x);
+        return;
+      }
+
+      rt = b;
+      rh[0] = b;
+      uh[0] = 0.0;
+      xt = 0.0;
+      field_type rho0 = 1.0, rho1, alpha = 0.0, omega = 1.0, beta, sigma;
+
+      // the pairs of the Gram matrix of rh[1..l] and its products with
+      // rh[0], grouped by the second vector
+      for (int q = 0; q <= l; ++q)
+        for (int p = 1; p <= (q == 0 ? l : q); ++p) {
+          left.push_back(&rh[p]);
+          right.push_back(&rh[q]);
         }
 
-      } // end outer while loop
+      int i = 0;
+      while (i < _maxit) {
+        rho0 *= -omega;
+
+        // BiCG part
+        for (int j = 0; j < l; ++j) {
+          rho1 = _sp->dot(rt,rh[j]);
+          if (Simd::allTrue(abs(rho0) <= EPSILON))
+            DUNE_THROW(SolverAbort,"breakdown in BiCGSTAB(l) - rho "
+                       << Simd::io(rho0) << " <= EPSILON " << EPSILON
+                       << " after " << i << " iterations");
+          beta = alpha*rho1/rho0;
+          rho0 = rho1;
+          for (int k = 0; k <= j; ++k) {
+            uh[k] *= -beta;
+            uh[k] += rh[k];
+          }
+          v = 0;
+          _prec->apply(v,uh[j]);
+          _op->apply(v,uh[j+1]);
+
+          sigma = _sp->dot(rt,uh[j+1]);
+          if (Simd::allTrue(abs(sigma) <= EPSILON))
+            DUNE_THROW(SolverAbort,"breakdown in BiCGSTAB(l) - sigma "
+                       << Simd::io(sigma) << " <= EPSILON " << EPSILON
+                       << " after " << i << " iterations");
+          alpha = rho0/sigma;
+          for (int k = 0; k <= j; ++k)
+            rh[k].axpy(-alpha,uh[k+1]);
+          v = 0;
+          _prec->apply(v,rh[j]);
+          _op->apply(v,rh[j+1]);
+          xt.axpy(alpha,uh[0]);
+          ++i;
+        }
 
-      // post-process preconditioner
-      _prec->post(x);
+        // minimize the defect rh[0] - sum_j gamma_j rh[j+1], the normal
+        // equations are set up with a single reduction
+        auto products = _sp->idot(left,right).get();
+        std::vector<std::vector<field_type> > Z(l, std::vector<field_type>(l));
+        std::size_t n = 0;
+        for (int p = 0; p < l; ++p)
+          gamma[p] = products[n++];
+        for (int q = 0; q < l; ++q)
+          for (int p = 0; p <= q; ++p) {
+            Z[p][q] = products[n++];
+            Z[q][p] = conjugateComplex(Z[p][q]);
+          }
+        for (int p = 0; p < l; ++p) {
+          if (Simd::allTrue(abs(Z[p][p]) <= EPSILON))
+            DUNE_THROW(SolverAbort,"breakdown in BiCGSTAB(l) - singular minimization after "
+                       << i << " iterations");
+          for (int q = p+1; q < l; ++q) {
+            const field_type factor = Z[q][p]/Z[p][p];
+            for (int m = p; m < l; ++m)
+              Z[q][m] -= factor*Z[p][m];
+            gamma[q] -= factor*gamma[p];
+          }
+        }
+        for (int p = l-1; p >= 0; --p) {
+          for (int m = p+1; m < l; ++m)
+            gamma[p] -= Z[p][m]*gamma[m];
+          gamma[p] /= Z[p][p];
+        }
+        omega = gamma[l-1];
+
+        // xt += sum_j gamma_j rh[j], rh[0] -= sum_j gamma_j rh[j+1], uh[0] -= sum_j gamma_j uh[j+1]
+        std::vector<const X*> basis(l);
+        for (int p = 0; p < l; ++p) {
+          basis[p] = &rh[p];
+          coefficients[p] = -gamma[p];
+        }
+        Impl::maxpy(xt,gamma,basis);
+        for (int p = 0; p < l; ++p)
+          basis[p] = &rh[p+1];
+        Impl::maxpy(rh[0],coefficients,basis);
+        for (int p = 0; p < l; ++p)
+          basis[p] = &uh[p+1];
+        Impl::maxpy(uh[0],coefficients,basis);
+
+        norm = _sp->norm(rh[0]);
+        if (iteration.step(i, norm))
+          break;
+      }
+
+      // transform the update back, x += W^-1 xt
+      v = 0;
+      _prec->apply(v,xt);
+      x += v;
+      b = rh[0];
+
+      _prec->post(x);                  // postprocess preconditioner
     }
 
-private:
-    using RestartedGMResSolver<X,Y>::_op;
-    using RestartedGMResSolver<X,Y>::_prec;
-    using RestartedGMResSolver<X,Y>::_sp;
-    using RestartedGMResSolver<X,Y>::_reduction;
-    using RestartedGMResSolver<X,Y>::_maxit;
-    using RestartedGMResSolver<X,Y>::_verbose;
-    using RestartedGMResSolver<X,Y>::_restart;
+  private:
+    void checkDegree () const
+    {
+      if (_l < 1)
+        DUNE_THROW(InvalidStateException, "BiCGSTABLSolver: the degree of the polynomials has to be positive");
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
     using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _l;
   };
-  DUNE_REGISTER_ITERATIVE_SOLVER("restartedflexiblegmressolver", defaultIterativeSolverCreator<Dune::RestartedFlexibleGMResSolver>());
+  DUNE_REGISTER_ITERATIVE_SOLVER("bicgstablsolver", defaultIterativeSolverCreator<Dune::BiCGSTABLSolver>());
 
   /**
    * @brief Generalized preconditioned conjugate gradient solver.
@@ -1386,6 +4117,9 @@ private:
       // some local variables
       field_type rho, lambda;
 
+      // coefficients of all steps for the eigenvalue estimates
+      std::vector<field_type> lambdas, rhos;
+
       int i=0;
       int ii=0;
       // determine initial search direction
@@ -1397,11 +4131,14 @@ private:
       lambda = rho/pp[0];         // minimization
       x.axpy(lambda,*(p[0]));               // update solution
       b.axpy(-lambda,q);              // update defect
+      lambdas.push_back(lambda);
+      rhos.push_back(rho);
 
       // convergence test
       def=_sp->norm(b);    // comp defect norm
       ++i;
       if(iteration.step(i, def)){
+        Impl::cgEigenvalueEstimates(lambdas, rhos, res);
         _prec->post(x);
         return;
       }
@@ -1431,12 +4168,15 @@ private:
           lambda = rho/pp[ii];             // minimization
           x.axpy(lambda,*(p[ii]));                   // update solution
           b.axpy(-lambda,q);                  // update defect
+          lambdas.push_back(lambda);
+          rhos.push_back(rho);
 
           // convergence test
           def = _sp->norm(b);        // comp defect norm
 
           ++i;
-          iteration.step(i, def);
+          if(iteration.step(i, def))
+            break;
         }
         if(res.converged)
           break;
@@ -1446,6 +4186,10 @@ private:
         }
       }
 
+      // extreme eigenvalues of the preconditioned operator, exact for a
+      // fixed symmetric positive definite preconditioner
+      Impl::cgEigenvalueEstimates(lambdas, rhos, res);
+
       // postprocess preconditioner
       _prec->post(x);
 
@@ -1473,6 +4217,10 @@ private:
      but it is much faster, depending on the operator and dimension.
      On the other hand for large mmax it uses noticeably more memory.
 
+     The new search direction is A-orthogonalized against the previous ones
+     by classical Gram-Schmidt in a single reduction by default, see
+     Orthogonalization.
+
  */
   template<class X>
   class RestartedFCGSolver : public IterativeSolver<X,X> {
@@ -1492,9 +4240,12 @@ private:
       \brief Constructor to initialize a RestartedFCG solver.
       \copydetails IterativeSolver::IterativeSolver(LinearOperator<X,Y>&, Preconditioner<X,Y>&, real_type, int, int, int)
       \param mmax is the maximal number of previous vectors which are orthogonalized against the new search direction.
+      \param orthogonalization the orthogonalization of the search directions, icgs throws NotImplemented.
     */
     RestartedFCGSolver (LinearOperator<X,X>& op, Preconditioner<X,X>& prec,
-                        scalar_real_type reduction, int maxit, int verbose, int mmax = 10) : IterativeSolver<X,X>(op, prec, reduction, maxit, verbose), _mmax(mmax)
+                        scalar_real_type reduction, int maxit, int verbose, int mmax = 10,
+                        Orthogonalization::Type orthogonalization = Orthogonalization::cgs)
+      : IterativeSolver<X,X>(op, prec, reduction, maxit, verbose), _mmax(mmax), _orthogonalization(checkOrthogonalization(orthogonalization))
     {
     }
 
@@ -1502,9 +4253,12 @@ private:
       \brief Constructor to initialize a RestartedFCG solver.
       \copydetails IterativeSolver::IterativeSolver(LinearOperator<X,Y>&, ScalarProduct<X>&, Preconditioner<X,Y>&, real_type, int, int,int)
       \param mmax is the maximal number of previous vectors which are orthogonalized against the new search direction.
+      \param orthogonalization the orthogonalization of the search directions, icgs throws NotImplemented.
     */
     RestartedFCGSolver (LinearOperator<X,X>& op, ScalarProduct<X>& sp, Preconditioner<X,X>& prec,
-                        scalar_real_type reduction, int maxit, int verbose, int mmax = 10) : IterativeSolver<X,X>(op, sp, prec, reduction, maxit, verbose), _mmax(mmax)
+                        scalar_real_type reduction, int maxit, int verbose, int mmax = 10,
+                        Orthogonalization::Type orthogonalization = Orthogonalization::cgs)
+      : IterativeSolver<X,X>(op, sp, prec, reduction, maxit, verbose), _mmax(mmax), _orthogonalization(checkOrthogonalization(orthogonalization))
     {
     }
 
@@ -1512,13 +4266,15 @@ private:
       \brief Constructor to initialize a RestartedFCG solver.
       \copydetails IterativeSolver::IterativeSolver(std::shared_ptr<LinearOperator<X,Y>>, std::shared_ptr<ScalarProduct<X>>, std::shared_ptr<Preconditioner<X,Y>>, real_type, int, int,int)
       \param mmax is the maximal number of previous vectors which are orthogonalized against the new search direction.
+      \param orthogonalization the orthogonalization of the search directions, icgs throws NotImplemented.
     */
     RestartedFCGSolver (std::shared_ptr<LinearOperator<X,X>> op,
                         std::shared_ptr<ScalarProduct<X>> sp,
                         std::shared_ptr<Preconditioner<X,X>> prec,
                         scalar_real_type reduction, int maxit, int verbose,
-                        int mmax = 10)
-      : IterativeSolver<X,X>(op, sp, prec, reduction, maxit, verbose), _mmax(mmax)
+                        int mmax = 10,
+                        Orthogonalization::Type orthogonalization = Orthogonalization::cgs)
+      : IterativeSolver<X,X>(op, sp, prec, reduction, maxit, verbose), _mmax(mmax), _orthogonalization(checkOrthogonalization(orthogonalization))
     {}
 
     /*!
@@ -1530,20 +4286,23 @@ private:
        ParameterTree Key | Meaning
        ------------------|------------
        mmax              | number of FCG cycles before restart. default=10
+       orthogonalization | orthogonalization of the search directions, "mgs", "cgs" or "cgs2". default=cgs
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     RestartedFCGSolver (std::shared_ptr<LinearOperator<X,X>> op,
                         std::shared_ptr<Preconditioner<X,X>> prec,
                         const ParameterTree& config)
-      : IterativeSolver<X,X>(op, prec, config), _mmax(config.get("mmax", 10))
+      : IterativeSolver<X,X>(op, prec, config), _mmax(config.get("mmax", 10)),
+        _orthogonalization(checkOrthogonalization(Impl::orthogonalizationFromString(config.get<std::string>("orthogonalization", "cgs"))))
     {}
 
     RestartedFCGSolver (std::shared_ptr<LinearOperator<X,X>> op,
                         std::shared_ptr<ScalarProduct<X>> sp,
                         std::shared_ptr<Preconditioner<X,X>> prec,
                         const ParameterTree& config)
-      : IterativeSolver<X,X>(op, sp, prec, config), _mmax(config.get("mmax", 10))
+      : IterativeSolver<X,X>(op, sp, prec, config), _mmax(config.get("mmax", 10)),
+        _orthogonalization(checkOrthogonalization(Impl::orthogonalizationFromString(config.get<std::string>("orthogonalization", "cgs"))))
     {}
 
     /*!
@@ -1577,6 +4336,7 @@ private:
         _prec->post(x);
         return;
       }
+      const real_type def0 = def;
 
       // some local variables
       field_type alpha;
@@ -1587,6 +4347,7 @@ private:
       while(i<=_maxit && !res.converged) {
         for (; i_bounded <= _mmax && i<= _maxit; i_bounded++) {
           d[i_bounded] = 0;                   // reset search direction
+          _prec->setOuterDefect(static_cast<double>(Simd::max(def/def0)), _reduction);
           _prec->apply(d[i_bounded], b);     // apply preconditioner
           w = d[i_bounded];                 // copy of current d[i]
           // orthogonalization with previous directions
@@ -1621,9 +4382,7 @@ private:
     //This function is called every iteration to orthogonalize against the last search directions
     virtual void orthogonalizations(const int& i_bounded,const std::vector<X>& Ad, const X& w, const std::vector<field_type,ReboundAllocatorType<X,field_type>>& ddotAd,std::vector<X>& d) {
       // The RestartedFCGSolver uses only values with lower array index;
-      for (int k = 0; k < i_bounded; k++) {
-        d[i_bounded].axpy(-_sp->dot(Ad[k], w) / ddotAd[k], d[k]); // d[i] -= <<Ad[k],w>/<d[k],Ad[k]>>d[k]
-      }
+      orthogonalize(i_bounded, i_bounded, Ad, w, ddotAd, d);
     }
 
     // This function is called every mmax iterations to handle limited array sizes.
@@ -1636,7 +4395,50 @@ private:
     }
 
   protected:
+    /* A-orthogonalize d[i_bounded] against d[k] for all k < end except
+     * i_bounded, w is a copy of d[i_bounded] before the orthogonalization.
+     */
+    void orthogonalize(int i_bounded, int end, const std::vector<X>& Ad, const X& w, const std::vector<field_type,ReboundAllocatorType<X,field_type>>& ddotAd, std::vector<X>& d) {
+      if (_orthogonalization == Orthogonalization::mgs) {
+        for (int k = 0; k < end; k++)
+          if (k != i_bounded)
+            d[i_bounded].axpy(-_sp->dot(Ad[k], d[i_bounded]) / ddotAd[k], d[k]); // d[i] -= <<Ad[k],d[i]>/<d[k],Ad[k]>>d[k]
+        return;
+      }
+
+      // all scalar products of a pass in one reduction
+      std::vector<const X*> left, right, directions;
+      std::vector<field_type> diagonal;
+      for (int k = 0; k < end; k++)
+        if (k != i_bounded) {
+          left.push_back(&Ad[k]);
+          right.push_back(&w);
+          directions.push_back(&d[k]);
+          diagonal.push_back(ddotAd[k]);
+        }
+      const int passes = (_orthogonalization == Orthogonalization::cgs2) ? 2 : 1;
+      for (int pass = 0; pass < passes && !left.empty(); pass++) {
+        // the reorthogonalization projects the updated direction
+        if (pass > 0)
+          right.assign(left.size(), &d[i_bounded]);
+        std::vector<field_type> alpha = _sp->idot(left, right).get();
+        for (std::size_t k = 0; k < alpha.size(); k++)
+          alpha[k] = -alpha[k] / diagonal[k];
+        // d[i] -= sum_k <Ad[k],w>/<d[k],Ad[k]> d[k]
+        Impl::maxpy(d[i_bounded], alpha, directions);
+      }
+    }
+
+    // icgs would need the A-norm of the direction, i.e. an additional operator application
+    static Orthogonalization::Type checkOrthogonalization (Orthogonalization::Type orthogonalization)
+    {
+      if (orthogonalization == Orthogonalization::icgs)
+        DUNE_THROW(NotImplemented, "iterated classical Gram-Schmidt is not available in the flexible conjugate gradient method");
+      return orthogonalization;
+    }
+
     int _mmax;
+    Orthogonalization::Type _orthogonalization;
     using IterativeSolver<X,X>::_op;
     using IterativeSolver<X,X>::_prec;
     using IterativeSolver<X,X>::_sp;
@@ -1678,10 +4480,7 @@ private:
     // This function is called every iteration to orthogonalize against the last search directions.
     virtual void orthogonalizations(const int& i_bounded,const std::vector<X>& Ad, const X& w, const std::vector<field_type,ReboundAllocatorType<X,field_type>>& ddotAd,std::vector<X>& d) override {
       // This FCGSolver uses values with higher array indexes too, if existent.
-      for (int k = 0; k < _k_limit; k++) {
-        if(i_bounded!=k)
-          d[i_bounded].axpy(-_sp->dot(Ad[k], w) / ddotAd[k], d[k]); // d[i] -= <<Ad[k],w>/<d[k],Ad[k]>>d[k]
-      }
+      this->orthogonalize(i_bounded, _k_limit, Ad, w, ddotAd, d);
       // The loop limit increase, if array is not completely filled.
       if(_k_limit<=i_bounded)
         _k_limit++;
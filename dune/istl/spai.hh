@@ -0,0 +1,347 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_SPAI_HH
+#define DUNE_ISTL_SPAI_HH
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/math.hh>
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/scalarmatrixview.hh>
+
+#include <dune/istl/common/threading.hh>
+
+#include "ilu.hh"
+#include "istlexception.hh"
+
+/** \file
+ * \brief Kernels for sparse approximate inverses with a static pattern.
+ *
+ * The factored sparse approximate inverse (FSAI) of a symmetric positive
+ * definite matrix A is a lower triangular matrix G with \f$GAG^H \approx I\f$.
+ * The sparse approximate inverse (SPAI) of a general matrix A is a matrix M
+ * minimizing \f$\|MA - I\|_F\f$. Every row of G and M is computed
+ * independently from a small dense problem, so the rows are processed
+ * concurrently.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  namespace Impl {
+
+    //! the number of rows and columns of the blocks of M
+    template<class M>
+    constexpr int spaiBlockSize ()
+    {
+      typedef typename M::block_type block_type;
+      typedef std::decay_t<decltype(Impl::asMatrix(std::declval<block_type&>()))> dense_block_type;
+      static_assert(int(dense_block_type::rows) == int(dense_block_type::cols),
+                    "sparse approximate inverses need square blocks");
+      return dense_block_type::rows;
+    }
+
+    //! reports a failed row after a threaded loop
+    template<class M>
+    void spaiCheckFailure (const M& A, typename M::size_type failed, const char* name)
+    {
+      if (failed != A.N())
+        DUNE_THROW(MatrixBlockError, name << " failed to compute row " << failed;
+                   th__ex.r=failed; th__ex.c=failed;);
+    }
+
+  } // end namespace Impl
+
+  /**
+   * \brief Sparsity pattern of the FSAI factor.
+   *
+   * The pattern is the lower triangle of the ILU(n) pattern of A, i.e. the
+   * lower triangle of A itself for n == 0. The matrix G should be an empty
+   * matrix in row_wise creation mode.
+   */
+  template<class M>
+  void bfsai_pattern (const M& A, int n, M& G)
+  {
+    M P;
+    if (n > 0)
+    {
+      P.setBuildMode(M::row_wise);
+      P.setSize(A.N(), A.M());
+      bilu_pattern(A, n, P);
+    }
+    const M& pattern = (n > 0) ? P : A;
+
+    G.setSize(A.N(), A.M());
+    for (auto row = G.createbegin(); row != G.createend(); ++row)
+      for (auto j = pattern[row.index()].begin(); j != pattern[row.index()].end() && j.index() <= row.index(); ++j)
+        row.insert(j.index());
+  }
+
+  /**
+   * \brief Compute the FSAI factor G of A on the pattern of G.
+   *
+   * For every row i the dense system \f$A_{PP} Y = E_i\f$ is solved, where
+   * P are the columns of row i of G and E_i the identity block at column i.
+   * With the Cholesky factorization \f$LL^H = Y_i\f$ of the diagonal block
+   * of Y the row of G is \f$L^{-1}Y^H\f$, so the diagonal blocks of
+   * \f$GAG^H\f$ are the identity. The rows are computed concurrently.
+   *
+   * \throws MatrixBlockError if a local problem is singular or A is not
+   *         positive definite.
+   */
+  template<class M>
+  void bfsai_decomposition (const M& A, M& G)
+  {
+    typedef typename M::size_type size_type;
+    typedef typename FieldTraits<typename M::block_type>::field_type K;
+    constexpr int n = Impl::spaiBlockSize<M>();
+
+    std::atomic<size_type> failedRow(A.N());
+
+    Impl::parallelFor(size_type(0), G.N(), [&](size_type i){
+        auto&& row = G[i];
+        std::vector<size_type> cols;
+        for (auto j = row.begin(); j != row.end(); ++j)
+          cols.push_back(j.index());
+        const size_type m = cols.size();
+        if (m == 0 || cols.back() != i)
+        {
+          failedRow = i;
+          return;
+        }
+
+        // the local matrix A_PP
+        DynamicMatrix<K> local(m*n, m*n, K(0));
+        for (size_type a = 0; a < m; ++a)
+          for (size_type b = 0; b < m; ++b)
+          {
+            auto ab = A[cols[a]].find(cols[b]);
+            if (ab == A[cols[a]].end())
+              continue;
+            const auto& block = Impl::asMatrix(*ab);
+            for (int r = 0; r < n; ++r)
+              for (int c = 0; c < n; ++c)
+                local[a*n+r][b*n+c] = block[r][c];
+          }
+
+        try {
+          local.invert();
+        }
+        catch (Dune::FMatrixError&) {
+          failedRow = i;
+          return;
+        }
+
+        // Y consists of the last n columns of the inverse
+        auto Y = [&](size_type k, int c) -> const K& { return local[k][(m-1)*n+c]; };
+
+        // Cholesky factorization of the diagonal block of Y
+        FieldMatrix<K,n,n> L(K(0));
+        for (int c = 0; c < n; ++c)
+        {
+          using std::real;
+          using std::sqrt;
+          auto d = real(Y((m-1)*n+c,c));
+          for (int k = 0; k < c; ++k)
+            d -= real(L[c][k] * conjugateComplex(L[c][k]));
+          if (!(d > 0))
+          {
+            failedRow = i;
+            return;
+          }
+          L[c][c] = sqrt(d);
+          for (int r = c+1; r < n; ++r)
+          {
+            K s = Y((m-1)*n+r,c);
+            for (int k = 0; k < c; ++k)
+              s -= L[r][k] * conjugateComplex(L[c][k]);
+            L[r][c] = s / L[c][c];
+          }
+        }
+
+        // G_ij = L^{-1} Y_j^H
+        size_type a = 0;
+        for (auto j = row.begin(); j != row.end(); ++j, ++a)
+        {
+          auto&& Gij = Impl::asMatrix(*j);
+          for (int c = 0; c < n; ++c)
+            for (int r = 0; r < n; ++r)
+            {
+              K s = conjugateComplex(Y(a*n+c,r));
+              for (int k = 0; k < r; ++k)
+                s -= L[r][k] * Gij[k][c];
+              Gij[r][c] = s / L[r][r];
+            }
+        }
+      }, 16);
+
+    const size_type failed = failedRow;
+    Impl::spaiCheckFailure(A, failed, "FSAI");
+  }
+
+  /**
+   * \brief Compute the sparse approximate inverse M of A on the pattern of M.
+   *
+   * Row i of M minimizes \f$\|M_i A - E_i\|_F\f$, where \f$E_i\f$ is the
+   * i-th block row of the identity and the columns J of \f$M_i\f$ are given
+   * by the pattern of M. The least squares problem is solved by the normal
+   * equations \f$BB^H M_i^H = B E_i^H\f$ with \f$B=A_{JI}\f$, where I are
+   * the nonzero columns of the rows J of A. The rows are computed
+   * concurrently.
+   *
+   * \throws MatrixBlockError if a local problem is singular.
+   */
+  template<class M>
+  void bspai_decomposition (const M& A, M& S)
+  {
+    typedef typename M::size_type size_type;
+    typedef typename FieldTraits<typename M::block_type>::field_type K;
+    constexpr int n = Impl::spaiBlockSize<M>();
+
+    std::atomic<size_type> failedRow(A.N());
+
+    Impl::parallelFor(size_type(0), S.N(), [&](size_type i){
+        auto&& row = S[i];
+        std::vector<size_type> J, I;
+        for (auto j = row.begin(); j != row.end(); ++j)
+        {
+          J.push_back(j.index());
+          for (auto k = A[j.index()].begin(); k != A[j.index()].end(); ++k)
+            I.push_back(k.index());
+        }
+        std::sort(I.begin(), I.end());
+        I.erase(std::unique(I.begin(), I.end()), I.end());
+        const size_type mJ = J.size();
+        const size_type mI = I.size();
+        const size_type pos = std::lower_bound(I.begin(), I.end(), i) - I.begin();
+        if (pos == mI || I[pos] != i)
+        {
+          failedRow = i;
+          return;
+        }
+
+        // B = A_JI
+        DynamicMatrix<K> B(mJ*n, mI*n, K(0));
+        for (size_type a = 0; a < mJ; ++a)
+          for (auto k = A[J[a]].begin(); k != A[J[a]].end(); ++k)
+          {
+            const size_type b = std::lower_bound(I.begin(), I.end(), k.index()) - I.begin();
+            const auto& block = Impl::asMatrix(*k);
+            for (int r = 0; r < n; ++r)
+              for (int c = 0; c < n; ++c)
+                B[a*n+r][b*n+c] = block[r][c];
+          }
+
+        // C = B B^H
+        DynamicMatrix<K> C(mJ*n, mJ*n, K(0));
+        for (size_type r = 0; r < mJ*n; ++r)
+          for (size_type c = 0; c <= r; ++c)
+          {
+            K s(0);
+            for (size_type k = 0; k < mI*n; ++k)
+              s += B[r][k] * conjugateComplex(B[c][k]);
+            C[r][c] = s;
+            C[c][r] = conjugateComplex(s);
+          }
+
+        try {
+          C.invert();
+        }
+        catch (Dune::FMatrixError&) {
+          failedRow = i;
+          return;
+        }
+
+        // Z = C^{-1} B E_i^H, M_ij = Z_j^H
+        size_type a = 0;
+        for (auto j = row.begin(); j != row.end(); ++j, ++a)
+        {
+          auto&& Mij = Impl::asMatrix(*j);
+          for (int r = 0; r < n; ++r)
+            for (int c = 0; c < n; ++c)
+            {
+              K z(0);
+              for (size_type k = 0; k < mJ*n; ++k)
+                z += C[a*n+c][k] * B[k][pos*n+r];
+              Mij[r][c] = conjugateComplex(z);
+            }
+        }
+      }, 16);
+
+    const size_type failed = failedRow;
+    Impl::spaiCheckFailure(A, failed, "SPAI");
+  }
+
+  /**
+   * \brief Set up the pattern of the conjugate transpose of A.
+   *
+   * The matrix At should be an empty matrix in row_wise creation mode.
+   * Its values are set by bconjugate_transpose_values.
+   */
+  template<class M>
+  void bconjugate_transpose_pattern (const M& A, M& At)
+  {
+    typedef typename M::size_type size_type;
+
+    std::vector<std::vector<size_type> > rows(A.M());
+    for (auto i = A.begin(); i != A.end(); ++i)
+      for (auto j = i->begin(); j != i->end(); ++j)
+        rows[j.index()].push_back(i.index());
+
+    At.setSize(A.M(), A.N());
+    for (auto row = At.createbegin(); row != At.createend(); ++row)
+      for (size_type j : rows[row.index()])
+        row.insert(j);
+  }
+
+  //! Copy the conjugate transposed blocks of A into the pattern of At, the rows of At are processed concurrently.
+  template<class M>
+  void bconjugate_transpose_values (const M& A, M& At)
+  {
+    typedef typename M::size_type size_type;
+    constexpr int n = Impl::spaiBlockSize<M>();
+
+    Impl::parallelFor(size_type(0), At.N(), [&](size_type i){
+        for (auto j = At[i].begin(); j != At[i].end(); ++j)
+        {
+          const auto& Aji = Impl::asMatrix(A[j.index()][i]);
+          auto&& Atij = Impl::asMatrix(*j);
+          for (int r = 0; r < n; ++r)
+            for (int c = 0; c < n; ++c)
+              Atij[r][c] = conjugateComplex(Aji[c][r]);
+        }
+      });
+  }
+
+  //! v = w A d, the rows are processed concurrently
+  template<class M, class X, class Y, class K>
+  void bspai_mv (const M& A, const Y& d, X& v, const K& w)
+  {
+    typedef typename M::size_type size_type;
+
+    Impl::parallelFor(size_type(0), A.N(), [&](size_type i){
+        auto&& vi = Impl::asVector(v[i]);
+        vi = 0;
+        for (auto j = A[i].begin(); j != A[i].end(); ++j)
+          Impl::asMatrix(*j).usmv(w, Impl::asVector(d[j.index()]), vi);
+      });
+  }
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <dune/common/classname.hh>
 #if HAVE_MPROTECT
@@ -69,6 +70,24 @@ int testVector()
   testVectorSpaceOperations(v);
   testScalarProduct(v);
 
+  // the fused kernels agree with the single dot products and updates
+  {
+    Vector u(v);
+    u *= 2.0;
+    std::vector<const Vector*> others = {&v, &u};
+    auto dots = w.mdot(others);
+    assert(dots.size() == 2);
+    assert(std::abs(dots[0] - v.dot(w)) <= 1e-12*std::abs(v.dot(w)));
+    assert(std::abs(dots[1] - u.dot(w)) <= 1e-12*std::abs(u.dot(w)));
+
+    Vector y(w), yref(w);
+    y.maxpy(std::vector<double>{0.5, -1.5}, others);
+    yref.axpy(0.5, v);
+    yref.axpy(-1.5, u);
+    yref -= y;
+    assert(yref.two_norm() <= 1e-12*y.two_norm());
+  }
+
   assert(w.N()==v.N());
 
   for(typename Vector::size_type i=0; i < v.N(); ++i)
@@ -242,6 +242,30 @@ int main(int argc, char** argv)
   GMRES solverGMRES(fop,dummyPrec, reduction, maxIter, maxIter*maxIter, 1);
   std::cout << "GMRES with identity preconditioner converged: " << solverTest(solverGMRES)  << std::endl <<  std::endl;
 
+  GMRES solverGMRESCGS2(fop,dummyPrec, reduction, maxIter, maxIter*maxIter, 1, Dune::Orthogonalization::cgs2);
+  std::cout << "GMRES with classical Gram-Schmidt and identity preconditioner converged: " << solverTest(solverGMRESCGS2)  << std::endl <<  std::endl;
+
+  typedef Dune::GCRODRSolver<Vector> GCRODR;
+  GCRODR solverGCRODR(fop,dummyPrec, reduction, 4, 2, maxIter*maxIter, 1);
+  std::cout << "GCRODR with identity preconditioner converged: " << solverTest(solverGCRODR)  << std::endl <<  std::endl;
+  std::cout << "GCRODR with a recycled subspace converged: " << solverTest(solverGCRODR)  << std::endl <<  std::endl;
+
+  typedef Dune::IDRSSolver<Vector> IDRS;
+  IDRS solverIDRS(fop,dummyPrec, reduction, 4, maxIter*maxIter, 1);
+  std::cout << "IDR(s) with identity preconditioner converged: " << solverTest(solverIDRS)  << std::endl <<  std::endl;
+
+  typedef Dune::BiCGSTABLSolver<Vector> BiCGSTABL;
+  BiCGSTABL solverBiCGSTABL(fop,dummyPrec, reduction, 2, maxIter*maxIter, 1);
+  std::cout << "BiCGStab(l) with identity preconditioner converged: " << solverTest(solverBiCGSTABL)  << std::endl <<  std::endl;
+
+  typedef Dune::BlockCGSolver<Vector> BlockCG;
+  BlockCG solverBlockCG(fop,dummyPrec, reduction, maxIter, 1);
+  std::cout << "BlockCG with identity preconditioner converged: " << solverTest(solverBlockCG)  << std::endl <<  std::endl;
+
+  typedef Dune::BlockGMResSolver<Vector> BlockGMRES;
+  BlockGMRES solverBlockGMRES(fop,dummyPrec, reduction, maxIter, maxIter*maxIter, 1);
+  std::cout << "BlockGMRES with identity preconditioner converged: " << solverTest(solverBlockGMRES)  << std::endl <<  std::endl;
+
   const int testCount = solverTest.getNumTests();
   const int errorCount = solverTest.getNumFailures();
   std::cout << "Tested " << testCount << " different solvers or preconditioners " << " for a laplacian with complex rhs. " << testCount -  errorCount << " out of " << testCount << " solvers converged! " << std::endl << std::endl;
@@ -0,0 +1,125 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file \brief Test the CPR preconditioner in the file `cpr.hh`
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/cpr.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/test/laplacian.hh>
+
+using namespace Dune;
+
+using Block = FieldMatrix<double,3,3>;
+using BlackOilMatrix = BCRSMatrix<Block>;
+using BlackOilVector = BlockVector<FieldVector<double,3> >;
+
+/* A model of a fully implicit discretization with one pressure and two
+ * saturations per cell on the N x N grid: the pressure equation is an
+ * elliptic Laplacian, the saturation equations are dominated by the
+ * accumulation terms and coupled to the pressure by the fluxes.
+ */
+void setupBlackOil(BlackOilMatrix& matrix, int N)
+{
+  setupLaplacian(matrix, N);
+  for (auto i = matrix.begin(); i != matrix.end(); ++i)
+    for (auto j = i->begin(); j != i->end(); ++j)
+    {
+      Block& a = *j;
+      a = 0;
+      if (j.index() == i.index())
+      {
+        const double s = 1.0 + 0.01 * ((i.index() * 7) % 5);
+        a[0][0] = 4.0 * s; a[0][1] = 0.3;     a[0][2] = 0.2;
+        a[1][0] = 2.0 * s; a[1][1] = 10.0;    a[1][2] = 0.5;
+        a[2][0] = 1.5 * s; a[2][1] = 0.5;     a[2][2] = 8.0;
+      }
+      else
+      {
+        a[0][0] = -1.0;  a[0][1] = -0.05; a[0][2] = -0.05;
+        a[1][0] = -0.5;  a[1][1] = -0.2;
+        a[2][0] = -0.4;                   a[2][2] = -0.2;
+      }
+    }
+}
+
+int solve(const BlackOilMatrix& matrix, Preconditioner<BlackOilVector,BlackOilVector>& prec)
+{
+  MatrixAdapter<BlackOilMatrix,BlackOilVector,BlackOilVector> op(matrix);
+  BiCGSTABSolver<BlackOilVector> solver(op, prec, 1e-8, 1000, 1);
+  BlackOilVector x(matrix.N()), b(matrix.N());
+  x = 0;
+  b = 1;
+  InverseOperatorResult result;
+  solver.apply(x, b, result);
+  if (!result.converged)
+    DUNE_THROW(Exception, "BiCGStab did not converge");
+  return result.iterations;
+}
+
+int main() try
+{
+  BlackOilMatrix matrix;
+  setupBlackOil(matrix, 40);
+
+  ParameterTree pressureConfig;
+  pressureConfig["smoother"] = "ssor";
+  CPRPreconditioner<BlackOilMatrix,BlackOilVector,BlackOilVector> cpr(matrix, 0, pressureConfig);
+
+  // the pressure matrix has the pattern of the matrix, the weights
+  // scale its diagonal to one
+  const auto& Ap = cpr.pressureMatrix();
+  if (Ap.N() != matrix.N() || Ap.nonzeroes() != matrix.nonzeroes())
+    DUNE_THROW(Exception, "wrong sparsity pattern of the pressure matrix");
+  for (auto i = Ap.begin(); i != Ap.end(); ++i)
+    if (std::abs((*i)[i.index()] - 1.0) > 1e-12)
+      DUNE_THROW(Exception, "wrong diagonal of the pressure matrix");
+
+  SeqILU<BlackOilMatrix,BlackOilVector,BlackOilVector> ilu(matrix, 0, 1.0);
+  const int itILU = solve(matrix, ilu);
+  const int itCPR = solve(matrix, cpr);
+
+  std::cout << "BiCGStab iterations with ILU0: " << itILU
+            << ", with CPR: " << itCPR << std::endl;
+  if (itCPR >= itILU)
+    DUNE_THROW(Exception, "CPR did not reduce the number of iterations");
+
+  // the update reuses the hierarchy and matches a new preconditioner
+  matrix *= 2.0;
+  cpr.update();
+  CPRPreconditioner<BlackOilMatrix,BlackOilVector,BlackOilVector> fresh(matrix, 0, pressureConfig);
+  for (auto i = Ap.begin(); i != Ap.end(); ++i)
+    for (auto j = i->begin(); j != i->end(); ++j)
+      if (std::abs(*j - fresh.pressureMatrix()[i.index()][j.index()]) > 1e-12)
+        DUNE_THROW(Exception, "pressure matrix differs after update");
+  if (solve(matrix, cpr) != itCPR)
+    DUNE_THROW(Exception, "iterations changed after scaling the matrix");
+
+  // the factory constructor
+  ParameterTree config;
+  config["pressureIndex"] = "0";
+  config["pressure.smoother"] = "jac";
+  config["n"] = "1";
+  CPRPreconditioner<BlackOilMatrix,BlackOilVector,BlackOilVector> configured(matrix, config);
+  solve(matrix, configured);
+
+  return 0;
+}
+catch (std::exception& e) {
+  std::cerr << e.what() << std::endl;
+  return 1;
+}
@@ -0,0 +1,133 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file \brief Test the deflation preconditioner in the file `deflation.hh`
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/deflation.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/test/laplacian.hh>
+
+using namespace Dune;
+
+// piecewise constant vectors on boxes x boxes subdomains of the grid
+template<class Vector>
+std::vector<Vector> subdomainVectors(int N, int boxes)
+{
+  std::vector<Vector> Z(boxes*boxes, Vector(N*N));
+  for (auto& z : Z)
+    z = 0;
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      Z[(i*boxes/N)*boxes + j*boxes/N][i*N+j] = 1.0;
+  return Z;
+}
+
+template<class Matrix, class Vector>
+void testProjection(const Matrix& matrix, const std::vector<Vector>& Z)
+{
+  MatrixAdapter<Matrix,Vector,Vector> op(matrix);
+  SeqJac<Matrix,Vector,Vector> jac(matrix, 1, 1.0);
+
+  // a vector in the deflation space
+  Vector z = Z[0];
+  z.axpy(2.0, Z[1]);
+  Vector d(z.size());
+  matrix.mv(z, d);
+
+  // ADEF1 is exact on A Z
+  DeflationPreconditioner<Vector> adef1(op, jac, Z, DeflationVariant::ADEF1);
+  Vector v(z.size());
+  v = 0;
+  adef1.apply(v, d);
+  v -= z;
+  if (v.two_norm() > 1e-10 * z.two_norm())
+    DUNE_THROW(Exception, "ADEF1 is not exact on the deflation space");
+
+  // the error of ADEF2 is A-orthogonal to Z
+  DeflationPreconditioner<Vector> adef2(op, jac, Z, DeflationVariant::ADEF2);
+  v = 0;
+  adef2.apply(v, d);
+  v -= z;
+  Vector Av(v.size());
+  matrix.mv(v, Av);
+  for (const auto& zk : Z)
+    if (std::abs(zk.dot(Av)) > 1e-10 * z.two_norm())
+      DUNE_THROW(Exception, "error of ADEF2 is not A-orthogonal to the deflation space");
+
+  // linearly dependent vectors are rejected
+  std::vector<Vector> dependent = {Z[0], Z[0]};
+  try {
+    DeflationPreconditioner<Vector> singular(op, jac, dependent);
+    DUNE_THROW(Exception, "singular coarse matrix not detected");
+  }
+  catch (ISTLError&) {}
+}
+
+template<class Matrix, class Vector>
+int solve(const Matrix& matrix, Preconditioner<Vector,Vector>& prec)
+{
+  MatrixAdapter<Matrix,Vector,Vector> op(matrix);
+  CGSolver<Vector> solver(op, prec, 1e-8, 1000, 1);
+  Vector x(matrix.N()), b(matrix.N());
+  x = 0;
+  b = 1;
+  InverseOperatorResult result;
+  solver.apply(x, b, result);
+  if (!result.converged)
+    DUNE_THROW(Exception, "CG did not converge");
+  return result.iterations;
+}
+
+int main() try
+{
+  using Matrix = BCRSMatrix<FieldMatrix<double,1,1> >;
+  using Vector = BlockVector<FieldVector<double,1> >;
+
+  const int N = 40;
+  Matrix matrix;
+  setupLaplacian(matrix, N);
+  const auto Z = subdomainVectors<Vector>(N, 4);
+
+  testProjection(matrix, Z);
+
+  MatrixAdapter<Matrix,Vector,Vector> op(matrix);
+  SeqSSOR<Matrix,Vector,Vector> ssor(matrix, 1, 1.0);
+  const int plain = solve(matrix, ssor);
+
+  DeflationPreconditioner<Vector> deflated(op, ssor, Z);
+  const int withDeflation = solve(matrix, deflated);
+
+  std::cout << "CG iterations with SSOR: " << plain
+            << ", with deflated SSOR: " << withDeflation << std::endl;
+  if (withDeflation >= plain)
+    DUNE_THROW(Exception, "deflation did not reduce the number of iterations");
+
+  // recompute the coarse matrix after a change of the matrix
+  matrix *= 2.0;
+  deflated.update();
+  testProjection(matrix, Z);
+  // all operations scale exactly by powers of two
+  if (solve(matrix, deflated) != withDeflation)
+    DUNE_THROW(Exception, "iterations changed after scaling the matrix");
+
+  return 0;
+}
+catch (std::exception& e) {
+  std::cerr << e.what() << std::endl;
+  return 1;
+}
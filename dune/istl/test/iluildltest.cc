@@ -10,10 +10,13 @@
 #include <dune/istl/bvector.hh>
 #include <dune/istl/bcrsmatrix.hh>
 #include <dune/istl/io.hh>
+#include <dune/istl/operators.hh>
 
 #include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
 
 #include "hilbertmatrix.hh"
+#include "laplacian.hh"
 
 
 template< template< class, class, class, int ... > class _Prec, class MatrixBlock, class VectorBlock >
@@ -46,6 +49,227 @@ void testDecomposition ( int n )
 }
 
 
+template< class MatrixBlock, class VectorBlock >
+void testLevelScheduledBacksolve ( int N )
+{
+  using BlockMatrix = Dune::BCRSMatrix< MatrixBlock >;
+  using BlockVector = Dune::BlockVector< VectorBlock >;
+
+  BlockMatrix A;
+  setupLaplacian( A, N );
+
+  BlockVector d( A.N() ), v( A.N() ), w( A.N() );
+  for ( std::size_t i = 0; i < d.size(); ++i )
+    d[ i ] = 1.0 + i%7;
+
+  auto compare = [] ( BlockVector v, const BlockVector& w, const char* method )
+  {
+    v -= w;
+    if ( v.two_norm() > 1e-12 )
+      DUNE_THROW( Dune::Exception, method << " returned wrong value with level sets!" );
+  };
+
+  // ILU(1) stored in a BCRSMatrix
+  BlockMatrix ILU( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::bilu_decomposition( A, 1, ILU );
+  Dune::bilu_backsolve( ILU, v, d );
+
+  // ILU(1) stored in CRS format
+  Dune::ILU::CRS< MatrixBlock > lowerCRS, upperCRS;
+  std::vector< MatrixBlock > inv;
+  Dune::ILU::convertToCRS( ILU, lowerCRS, upperCRS, inv );
+
+  // minLevelSize 1 gives plain wavefronts, the default merges the small levels
+  for ( std::size_t minLevelSize : { std::size_t( 1 ), std::size_t( N ), std::size_t( 512 ) } )
+  {
+    Dune::ILU::LevelSets lower, upper;
+    Dune::ILU::computeLevelSets( ILU, lower, upper, minLevelSize );
+    if ( lower.rows_.size() != A.N() || upper.rows_.size() != A.N() )
+      DUNE_THROW( Dune::Exception, "ILU::computeLevelSets() computed wrong level sets!" );
+    if ( minLevelSize == 1 && lower.levels() >= A.N() )
+      DUNE_THROW( Dune::Exception, "ILU::computeLevelSets() computed wrong number of levels!" );
+
+    w = 0.0;
+    Dune::ILU::bilu_backsolve( ILU, lower, upper, w, d );
+    compare( v, w, "bilu_backsolve()" );
+
+    Dune::ILU::computeLevelSets( lowerCRS, upperCRS, lower, upper, minLevelSize );
+    w = 0.0;
+    Dune::ILU::bilu_backsolve( lowerCRS, upperCRS, inv, lower, upper, w, d );
+    compare( v, w, "ILU::bilu_backsolve()" );
+  }
+
+  // ILDL of the lower triangle
+  BlockMatrix L( A.N(), A.M(), BlockMatrix::row_wise );
+  for ( auto row = L.createbegin(); row != L.createend(); ++row )
+  {
+    for ( auto ij = A[ row.index() ].begin(); ij.index() < row.index(); ++ij )
+      row.insert( ij.index() );
+    row.insert( row.index() );
+  }
+  for ( auto i = L.begin(); i != L.end(); ++i )
+    for ( auto ij = i->begin(); ij != i->end(); ++ij )
+      *ij = A[ i.index() ][ ij.index() ];
+  Dune::bildl_decompose( L );
+
+  Dune::bildl_backsolve( L, v, d, true );
+  for ( std::size_t minLevelSize : { std::size_t( 1 ), std::size_t( N ), std::size_t( 512 ) } )
+  {
+    Dune::ILDLLevelSets levelSets;
+    Dune::bildl_levelsets( L, levelSets, minLevelSize );
+    w = 0.0;
+    Dune::bildl_backsolve( L, levelSets, w, d );
+    compare( v, w, "bildl_backsolve()" );
+  }
+}
+
+
+template< class MatrixBlock, class VectorBlock >
+void testIterativeDecomposition ( int N )
+{
+  using BlockMatrix = Dune::BCRSMatrix< MatrixBlock >;
+  using BlockVector = Dune::BlockVector< VectorBlock >;
+
+  BlockMatrix A;
+  setupLaplacian( A, N );
+
+  BlockVector d( A.N() ), v( A.N() ), w( A.N() );
+  for ( std::size_t i = 0; i < d.size(); ++i )
+    d[ i ] = 1.0 + i%7;
+
+  // the fixed-point sweeps reproduce the exact decomposition after finitely many sweeps
+  const int sweeps = A.N();
+  for ( int n : { 0, 1 } )
+  {
+    BlockMatrix ILU( A.N(), A.M(), BlockMatrix::row_wise );
+    Dune::bilu_decomposition( A, n, ILU );
+
+    BlockMatrix iterativeILU( A.N(), A.M(), BlockMatrix::row_wise );
+    Dune::bilu_pattern( A, n, iterativeILU );
+    Dune::ILU::bilu_iterative_decomposition( A, iterativeILU, sweeps );
+
+    BlockMatrix diff( iterativeILU );
+    diff -= ILU;
+    if ( diff.frobenius_norm() > 1e-10 )
+      DUNE_THROW( Dune::Exception, "ILU::bilu_iterative_decomposition() computed wrong decomposition!" );
+
+    // so do the Jacobi iterations for the triangular solves
+    Dune::bilu_backsolve( ILU, v, d );
+    w = 0.0;
+    BlockVector old, y;
+    Dune::ILU::bilu_jacobi_backsolve( ILU, sweeps, w, d, old, y );
+    w -= v;
+    if ( w.two_norm() > 1e-10 )
+      DUNE_THROW( Dune::Exception, "ILU::bilu_jacobi_backsolve() returned wrong value!" );
+  }
+}
+
+
+template< class MatrixBlock, class VectorBlock >
+void testILUT ( int N )
+{
+  using BlockMatrix = Dune::BCRSMatrix< MatrixBlock >;
+  using BlockVector = Dune::BlockVector< VectorBlock >;
+
+  BlockMatrix A;
+  setupLaplacian( A, N );
+
+  BlockVector d( A.N() ), v( A.N() ), w( A.N() );
+  for ( std::size_t i = 0; i < d.size(); ++i )
+    d[ i ] = 1.0 + i%7;
+
+  // without dropping ILUT is the complete LU decomposition
+  BlockMatrix LU( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::bilut_decomposition( A, A.N(), 0.0, LU );
+  Dune::bilu_backsolve( LU, v, d );
+  A.mv( v, w );
+  w -= d;
+  if ( w.two_norm() > 1e-10 )
+    DUNE_THROW( Dune::Exception, "bilut_decomposition() without dropping is not exact!" );
+
+  // the number of entries left and right of the diagonal is limited by p
+  const int p = 3;
+  BlockMatrix ILUT( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::bilut_decomposition( A, p, 1e-2, ILUT );
+  for ( auto i = ILUT.begin(); i != ILUT.end(); ++i )
+    if ( i->size() > std::size_t( 2*p+1 ) || i->find( i.index() ) == i->end() )
+      DUNE_THROW( Dune::Exception, "bilut_decomposition() computed wrong pattern!" );
+
+  // a positive tau alone drops the small fill-in of the complete decomposition
+  const double tau = 1e-2;
+  BlockMatrix dropped( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::bilut_decomposition( A, A.N(), tau, dropped );
+  if ( dropped.nonzeroes() >= LU.nonzeroes() )
+    DUNE_THROW( Dune::Exception, "bilut_decomposition() did not drop entries smaller than tau!" );
+
+  // the dropped decomposition still accelerates GMRes
+  Dune::MatrixAdapter< BlockMatrix, BlockVector, BlockVector > op( A );
+  Dune::Richardson< BlockVector, BlockVector > identity( 1.0 );
+  Dune::SeqILUT< BlockMatrix, BlockVector, BlockVector > ilut( A, A.N(), tau, 1.0 );
+  auto iterations = [ & ] ( Dune::Preconditioner< BlockVector, BlockVector >& prec )
+  {
+    Dune::RestartedGMResSolver< BlockVector > solver( op, prec, 1e-8, 100, 100, 0 );
+    Dune::InverseOperatorResult result;
+    BlockVector b( d );
+    v = 0;
+    solver.apply( v, b, result );
+    if ( !result.converged )
+      DUNE_THROW( Dune::Exception, "GMRes did not converge!" );
+    return result.iterations;
+  };
+  if ( iterations( ilut ) >= iterations( identity ) )
+    DUNE_THROW( Dune::Exception, "SeqILUT did not reduce the number of iterations!" );
+}
+
+
+template< class MatrixBlock, class VectorBlock >
+void testSymbolicILU ( int N )
+{
+  using BlockMatrix = Dune::BCRSMatrix< MatrixBlock >;
+  using BlockVector = Dune::BlockVector< VectorBlock >;
+
+  BlockMatrix A;
+  setupLaplacian( A, N );
+
+  BlockVector d( A.N() ), v( A.N() ), w( A.N() );
+  for ( std::size_t i = 0; i < d.size(); ++i )
+    d[ i ] = 1.0 + i%7;
+
+  // the CRS structure of a resorted decomposition holds the pattern of the factors
+  BlockMatrix reference( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::bilu_pattern( A, 2, reference );
+  Dune::ILU::CRS< MatrixBlock, typename BlockMatrix::allocator_type > lower, upper;
+  std::vector< MatrixBlock, typename BlockMatrix::allocator_type > inv;
+  Dune::ILU::convertToCRS( reference, lower, upper, inv );
+  BlockMatrix pattern( A.N(), A.M(), BlockMatrix::row_wise );
+  Dune::ILU::setupPattern( lower, upper, pattern );
+  if ( pattern.nonzeroes() != reference.nonzeroes() )
+    DUNE_THROW( Dune::Exception, "ILU::setupPattern returned wrong pattern!" );
+  for ( auto i = reference.begin(); i != reference.end(); ++i )
+    for ( auto j = i->begin(); j != i->end(); ++j )
+      if ( !pattern.exists( i.index(), j.index() ) )
+        DUNE_THROW( Dune::Exception, "ILU::setupPattern returned wrong pattern!" );
+
+  // refactorization on the stored symbolic phase equals the decomposition from scratch
+  for ( bool resort : { false, true } )
+  {
+    BlockMatrix B( A );
+    Dune::SeqILU< BlockMatrix, BlockVector, BlockVector > ilu( B, 2, 1.0, resort );
+    B *= 2.0;
+    ilu.update();
+
+    BlockMatrix ILU( B.N(), B.M(), BlockMatrix::row_wise );
+    Dune::bilu_decomposition( B, 2, ILU );
+    Dune::bilu_backsolve( ILU, v, d );
+
+    ilu.apply( w, d );
+    w -= v;
+    if ( w.two_norm() > 1e-10 )
+      DUNE_THROW( Dune::Exception, "SeqILU::update() returned wrong value!" );
+  }
+}
+
+
 int main(int argc, char** argv)
 try {
 
@@ -55,13 +279,27 @@ try {
   testDecomposition< Dune::SeqILU, Dune::FieldMatrix<double,1,1>, Dune::FieldVector<double,1> >( 4 );
   testDecomposition<Dune::SeqILU, Dune::LoopSIMD<double, 4>, Dune::LoopSIMD<double, 4>>( 4 );
 
+  testLevelScheduledBacksolve< double, double >( 20 );
+  testLevelScheduledBacksolve< Dune::FieldMatrix<double,2,2>, Dune::FieldVector<double,2> >( 20 );
+
+  testIterativeDecomposition< double, double >( 6 );
+  testIterativeDecomposition< Dune::FieldMatrix<double,2,2>, Dune::FieldVector<double,2> >( 6 );
+
+  testILUT< double, double >( 6 );
+  testILUT< Dune::FieldMatrix<double,2,2>, Dune::FieldVector<double,2> >( 6 );
+
+  testSymbolicILU< double, double >( 6 );
+  testSymbolicILU< Dune::FieldMatrix<double,2,2>, Dune::FieldVector<double,2> >( 6 );
+
   return 0;
 }
 catch(Dune::Exception &e)
 {
   std::cerr << "Dune reported error: " << e << std::endl;
+  return 1;
 }
 catch (...)
 {
   std::cerr << "Unknown exception" << std::endl;
+  return 1;
 }
@@ -10,6 +10,41 @@
 #include <dune/common/fvector.hh>
 #include "laplacian.hh"
 
+// inverse operator counting the iterations of the wrapped solver
+template<class Solver>
+class CountingInverseOperator : public Dune::InverseOperator<typename Solver::domain_type, typename Solver::range_type>
+{
+public:
+  typedef typename Solver::domain_type X;
+
+  CountingInverseOperator(Solver& solver)
+    : solver_(solver), iterations(0)
+  {}
+
+  virtual void apply (X& x, X& b, Dune::InverseOperatorResult& res)
+  {
+    solver_.apply(x, b, res);
+    iterations += res.iterations;
+  }
+
+  virtual void apply (X& x, X& b, double reduction, Dune::InverseOperatorResult& res)
+  {
+    solver_.apply(x, b, reduction, res);
+    iterations += res.iterations;
+  }
+
+  virtual Dune::SolverCategory::Category category() const
+  {
+    return Dune::SolverCategory::sequential;
+  }
+
+private:
+  Solver& solver_;
+
+public:
+  int iterations;
+};
+
 int main(int argc, char** argv)
 {
   const int BS=1;
@@ -56,5 +91,46 @@ int main(int argc, char** argv)
     std::cerr<<"Convergence rates do not match!"<<std::endl;
     return 1;
   }
+
+  // inexact inner solves in a flexible outer solver: a relaxed inner
+  // reduction must reach the same accuracy with less inner iterations
+  typedef Dune::CGSolver<BVector> InnerSolver;
+  typedef CountingInverseOperator<InnerSolver> CountingSolver;
+  InnerSolver innerSolver(fop, prec0, 1e-3, 1000, 0);
+  CountingSolver fixedInner(innerSolver), relaxedInner(innerSolver);
+  Dune::InverseOperator2Preconditioner<CountingSolver> fixedPrec(fixedInner);
+  Dune::InverseOperator2Preconditioner<CountingSolver>
+    relaxedPrec(relaxedInner, Dune::RelaxedInnerTolerance(1e-3));
+
+  for(int flexibleGMRes=0; flexibleGMRes<2; ++flexibleGMRes)
+  {
+    fixedInner.iterations = relaxedInner.iterations = 0;
+    Dune::InverseOperatorResult fixedRes, relaxedRes;
+    for(auto* p : {&fixedPrec, &relaxedPrec})
+    {
+      auto& r = (p == &fixedPrec) ? fixedRes : relaxedRes;
+      x=1;
+      mat.mv(x, b);
+      x=0;
+      if(flexibleGMRes)
+      {
+        Dune::RestartedFlexibleGMResSolver<BVector> outer(fop, *p, 1e-8, 20, 100, 2);
+        outer.apply(x,b,r);
+      }
+      else
+      {
+        Dune::RestartedFCGSolver<BVector> outer(fop, *p, 1e-8, 100, 2);
+        outer.apply(x,b,r);
+      }
+    }
+    std::cout<<"inner iterations fixed "<<fixedInner.iterations
+             <<", relaxed "<<relaxedInner.iterations<<std::endl;
+    if(!fixedRes.converged || !relaxedRes.converged
+       || relaxedInner.iterations >= fixedInner.iterations)
+    {
+      std::cerr<<"Relaxed inner tolerance did not save inner iterations!"<<std::endl;
+      return 1;
+    }
+  }
   return 0;
 }
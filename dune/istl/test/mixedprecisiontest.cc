@@ -0,0 +1,130 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/mixedprecision.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include "laplacian.hh"
+
+// solve with mixed precision refinement to a tolerance far below the
+// machine epsilon of float and check the true residual in double
+template<class Matrix, class Vector, class Solver>
+bool checkRefinement(const Matrix& A, Solver& solver, double reduction)
+{
+  Vector x(A.M()), b(A.N()), b0(A.N());
+  x = 1.0;
+  A.mv(x, b);
+  b0 = b;
+  double bnorm = b.two_norm();
+  x = 0;
+
+  Dune::InverseOperatorResult res;
+  solver.apply(x, b, res);
+
+  A.mmv(x, b0);
+  double defect = b0.two_norm();
+  std::cout << "refinement steps " << res.iterations
+            << ", relative residual " << defect/bnorm << std::endl;
+
+  if (!res.converged || defect > 10*reduction*bnorm)
+  {
+    std::cerr << "mixed precision refinement did not reach the requested accuracy" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int N = 50;
+  if (argc > 1)
+    N = atoi(argv[1]);
+
+  bool passed = true;
+  const double reduction = 1e-12;
+
+  // scalar blocks, inner solver set up by hand
+  {
+    typedef Dune::BCRSMatrix<double> Matrix;
+    typedef Dune::BlockVector<double> Vector;
+    typedef Dune::MixedPrecisionSolver<Matrix,Vector> Solver;
+    typedef typename Solver::lower_preconditioner_type::lower_matrix_type LowerMatrix;
+    typedef typename Solver::lower_preconditioner_type::lower_domain_type LowerVector;
+    typedef typename Solver::lower_preconditioner_type::lower_operator_type LowerOperator;
+
+    static_assert(std::is_same<typename LowerMatrix::field_type, float>::value,
+                  "inner matrix has to be in single precision");
+
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Solver solver(A, [](const std::shared_ptr<LowerOperator>& op){
+        auto prec = std::make_shared<Dune::SeqILU<LowerMatrix,LowerVector,LowerVector>>(op->getmat(), 1.0);
+        auto sp = std::make_shared<Dune::SeqScalarProduct<LowerVector>>();
+        return std::make_shared<Dune::CGSolver<LowerVector>>(op, sp, prec, 1e-3, 1000, 0);
+      }, reduction, 100, 2);
+    passed &= checkRefinement<Matrix,Vector>(A, solver, reduction);
+
+    // update() converts the changed matrix and rebuilds the inner solver
+    Dune::MixedPrecisionPreconditioner<Matrix,Vector,Vector> prec(A, [](const std::shared_ptr<LowerOperator>& op){
+        auto ilu = std::make_shared<Dune::SeqILU<LowerMatrix,LowerVector,LowerVector>>(op->getmat(), 1.0);
+        auto sp = std::make_shared<Dune::SeqScalarProduct<LowerVector>>();
+        return std::make_shared<Dune::CGSolver<LowerVector>>(op, sp, ilu, 1e-5, 1000, 0);
+      });
+    A *= 2.0;
+    prec.update();
+    Vector x(A.M()), v(A.M()), d(A.N());
+    x = 1.0;
+    A.mv(x, d);
+    prec.apply(v, d);
+    v -= x;
+    if (v.two_norm() > 1e-3*x.two_norm())
+    {
+      std::cerr << "update() did not take the changed matrix into account" << std::endl;
+      passed = false;
+    }
+  }
+
+  // 2x2 blocks, inner solver from the solver factory
+  {
+    typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,2,2>> Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double,2>> Vector;
+
+    Matrix A;
+    setupLaplacian(A, N);
+
+    for (std::string precType : {"ilu", "amg"})
+    {
+      Dune::ParameterTree config;
+      config["reduction"] = "1e-12";
+      config["maxit"] = "100";
+      config["verbose"] = "2";
+      config["inner.type"] = "cgsolver";
+      config["inner.reduction"] = "1e-3";
+      config["inner.maxit"] = "1000";
+      config["inner.verbose"] = "0";
+      config["inner.preconditioner.type"] = precType;
+      config["inner.preconditioner.iterations"] = "1";
+      config["inner.preconditioner.relaxation"] = "1";
+
+      Dune::MixedPrecisionSolver<Matrix,Vector> solver(A, config);
+      passed &= checkRefinement<Matrix,Vector>(A, solver, reduction);
+    }
+  }
+
+  return passed ? 0 : 1;
+}
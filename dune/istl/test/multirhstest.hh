@@ -110,23 +110,33 @@ void test_all_solvers(std::string precName, Operator & op, Prec & prec, unsigned
   int verb = 1;
   Dune::LoopSolver<Vector> loop(op,prec,reduction,18000,verb);
   Dune::CGSolver<Vector> cg(op,prec,reduction,8000,verb);
+  Dune::PipelinedCGSolver<Vector> pipecg(op,prec,reduction,8000,verb);
   Dune::BiCGSTABSolver<Vector> bcgs(op,prec,reduction,8000,verb);
+  Dune::IDRSSolver<Vector> idrs(op,prec,reduction,4,8000,verb);
+  Dune::BiCGSTABLSolver<Vector> bcgsl(op,prec,reduction,2,8000,verb);
   Dune::GradientSolver<Vector> grad(op,prec,reduction,18000,verb);
   Dune::RestartedGMResSolver<Vector> gmres(op,prec,reduction,40,8000,verb);
   Dune::MINRESSolver<Vector> minres(op,prec,reduction,8000,verb);
   Dune::GeneralizedPCGSolver<Vector> gpcg(op,prec,reduction,8000,verb);
   Dune::RestartedFCGSolver<Vector> rfcg(op,prec,reduction,8000,verb);
   Dune::CompleteFCGSolver<Vector> cfcg(op,prec,reduction,8000,verb);
+  Dune::BlockCGSolver<Vector> bcg(op,prec,reduction,8000,verb);
+  Dune::BlockGMResSolver<Vector> bgmres(op,prec,reduction,40,8000,verb);
 
   // run_test(precName, "Loop",           op,loop,N,Runs);
   run_test(precName, "CG",             op,cg,N,Runs);
+  run_test(precName, "PipelinedCG",    op,pipecg,N,Runs);
   run_test(precName, "BiCGStab",       op,bcgs,N,Runs);
+  run_test(precName, "IDR(s)",         op,idrs,N,Runs);
+  run_test(precName, "BiCGStab(l)",    op,bcgsl,N,Runs);
   run_test(precName, "Gradient",       op,grad,N,Runs);
   run_test(precName, "RestartedGMRes", op,gmres,N,Runs);
   run_test(precName, "MINRes",         op,minres,N,Runs);
   run_test(precName, "GeneralizedPCG", op,gpcg,N,Runs);
   run_test(precName, "RestartedFCG",   op,rfcg,N,Runs);
   run_test(precName, "CompleteFCG",    op,cfcg,N,Runs);
+  run_test(precName, "BlockCG",        op,bcg,N,Runs);
+  run_test(precName, "BlockGMRes",     op,bgmres,N,Runs);
 }
 
 template<typename FT>
@@ -230,6 +230,16 @@ Dune::TestSuite test(int argc, char** argv)
   solver2.apply(x,b, res);
   suite.check(res.converged) << "solver2 did not converge";
 
+  std::cout << "Additive Schwarz with ILUTSubdomainSolver (rowToDomain vector)"<<std::endl;
+
+  b=0;
+  x=100;
+  Dune::SeqOverlappingSchwarz<BCRSMat,BVector,Dune::AdditiveSchwarzMode,
+                              Dune::ILUTSubdomainSolver<BCRSMat,BVector,BVector> > ilut_prec(mat, rowToDomain, 1);
+  Dune::LoopSolver<BVector> ilut_solver(fop, ilut_prec, 1e-2,100,2);
+  ilut_solver.apply(x,b, res);
+  suite.check(res.converged) << "ilut_solver did not converge";
+
   std::cout << "Multiplicative Schwarz (rowToDomain vector)"<<std::endl;
 
   b=0;
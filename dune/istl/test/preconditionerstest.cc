@@ -7,6 +7,10 @@
 /** \file \brief Test the preconditioners in the file `preconditioners.hh`
  */
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
@@ -25,18 +29,38 @@ namespace Dune
 
   // explicit template instantiation of all preconditioners
   template class SeqJac<Mat1, Vec1, Vec1>;
+  template class SeqChebyshev<Mat1, Vec1, Vec1>;
   template class SeqSOR<Mat1, Vec1, Vec1>;
   template class SeqSSOR<Mat1, Vec1, Vec1>;
   template class Richardson<Vec1, Vec1>;
   template class SeqILU<Mat1, Vec1, Vec1>;
+  template class SeqILUT<Mat1, Vec1, Vec1>;
   template class SeqILDL<Mat1, Vec1, Vec1>;
+  template class SeqIC<Mat1, Vec1, Vec1>;
+  template class SeqICT<Mat1, Vec1, Vec1>;
+  template class SeqMultiColorGS<Mat1, Vec1, Vec1>;
+  template class SeqMultiColorILU0<Mat1, Vec1, Vec1>;
+  template class SeqParILU<Mat1, Vec1, Vec1>;
+  template class SeqFSAI<Mat1, Vec1, Vec1>;
+  template class SeqSPAI<Mat1, Vec1, Vec1>;
+  template class SeqBlockJacobi<Mat1, Vec1, Vec1>;
 
   template class SeqJac<Mat2, Vec2, Vec2>;
+  template class SeqChebyshev<Mat2, Vec2, Vec2>;
   template class SeqSOR<Mat2, Vec2, Vec2>;
   template class SeqSSOR<Mat2, Vec2, Vec2>;
   template class Richardson<Vec2, Vec2>;
   template class SeqILU<Mat2, Vec2, Vec2>;
+  template class SeqILUT<Mat2, Vec2, Vec2>;
   template class SeqILDL<Mat2, Vec2, Vec2>;
+  template class SeqIC<Mat2, Vec2, Vec2>;
+  template class SeqICT<Mat2, Vec2, Vec2>;
+  template class SeqMultiColorGS<Mat2, Vec2, Vec2>;
+  template class SeqMultiColorILU0<Mat2, Vec2, Vec2>;
+  template class SeqParILU<Mat2, Vec2, Vec2>;
+  template class SeqFSAI<Mat2, Vec2, Vec2>;
+  template class SeqSPAI<Mat2, Vec2, Vec2>;
+  template class SeqBlockJacobi<Mat2, Vec2, Vec2>;
 
 } // end namespace Dune
 
@@ -88,14 +112,54 @@ void testAllPreconditioners(const Matrix& matrix, const Vector& b)
   SeqGS<Matrix,Vector,Vector> seqGS(matrix, 1,1.0);
   testPreconditioner(matrix, b, x, seqGS);
 
+  x = 0;
+  SeqMultiColorGS<Matrix,Vector,Vector> seqMCGS(matrix, 1,1.0);
+  testPreconditioner(matrix, b, x, seqMCGS);
+
   x = 0;
   SeqJac<Matrix,Vector,Vector> seqJac(matrix, 1,1.0);
   testPreconditioner(matrix, b, x, seqJac);
 
+  x = 0;
+  SeqChebyshev<Matrix,Vector,Vector> seqChebyshev(matrix, 2);
+  testPreconditioner(matrix, b, x, seqChebyshev);
+
   x = 0;
   SeqILU<Matrix,Vector,Vector> seqILU(matrix, 3, 1.2, true);
   testPreconditioner(matrix, b, x, seqILU);
 
+  x = 0;
+  SeqMultiColorILU0<Matrix,Vector,Vector> seqMCILU0(matrix, 1.0);
+  testPreconditioner(matrix, b, x, seqMCILU0);
+
+  x = 0;
+  SeqParILU<Matrix,Vector,Vector> seqParILU(matrix, 1, 3, 0, 1.0);
+  testPreconditioner(matrix, b, x, seqParILU);
+
+  x = 0;
+  SeqParILU<Matrix,Vector,Vector> seqParILUJacobi(matrix, 0, 3, 3, 1.0);
+  testPreconditioner(matrix, b, x, seqParILUJacobi);
+
+  x = 0;
+  SeqFSAI<Matrix,Vector,Vector> seqFSAI(matrix, 1, 1.0);
+  testPreconditioner(matrix, b, x, seqFSAI);
+
+  x = 0;
+  SeqSPAI<Matrix,Vector,Vector> seqSPAI(matrix, 1, 1.0);
+  testPreconditioner(matrix, b, x, seqSPAI);
+
+  x = 0;
+  SeqBlockJacobi<Matrix,Vector,Vector> seqBlockJacobi(matrix, 4, 1);
+  testPreconditioner(matrix, b, x, seqBlockJacobi);
+
+  x = 0;
+  SeqBlockJacobi<Matrix,Vector,Vector,SeqILDL<Matrix,Vector,Vector> > seqBlockJacobiILDL(matrix, 4, 0);
+  testPreconditioner(matrix, b, x, seqBlockJacobiILDL);
+
+  x = 0;
+  SeqILUT<Matrix,Vector,Vector> seqILUT(matrix, 5, 1e-3, 1.0);
+  testPreconditioner(matrix, b, x, seqILUT);
+
   x = 0;
   Richardson<Vector,Vector> richardson(1.5);
   testPreconditioner(matrix, b, x, richardson);
@@ -103,6 +167,254 @@ void testAllPreconditioners(const Matrix& matrix, const Vector& b)
   x = 0;
   SeqILDL<Matrix,Vector,Vector> seqILDL(matrix, 1.2);
   testPreconditioner(matrix, b, x, seqILDL);
+
+  x = 0;
+  SeqIC<Matrix,Vector,Vector> seqIC(matrix, 1);
+  testPreconditioner(matrix, b, x, seqIC);
+
+  x = 0;
+  SeqICT<Matrix,Vector,Vector> seqICT(matrix, 5, 1e-3);
+  testPreconditioner(matrix, b, x, seqICT);
+}
+
+// Check that update() after changing the matrix values yields the same
+// preconditioner as constructing a new one for the changed matrix
+template <class Matrix, class Vector, class Create>
+void testUpdate(const Matrix& matrix, const Vector& b, Create&& create)
+{
+  Matrix changed = matrix;
+  auto prec = create(changed);
+
+  // shift the diagonal and scale the matrix
+  for (auto row = changed.begin(); row != changed.end(); ++row)
+    changed[row.index()][row.index()] += 1.0;
+  changed *= 2.0;
+  prec->update();
+
+  auto fresh = create(changed);
+
+  Vector x1 = b, x2 = b;
+  x1 = 0;
+  x2 = 0;
+  prec->apply(x1, b);
+  fresh->apply(x2, b);
+  x1 -= x2;
+  if (x1.two_norm() > 1e-10 * x2.two_norm())
+    DUNE_THROW(Exception, "update() does not match a new preconditioner");
+}
+
+// Check that the sweeps using the inverted diagonal blocks match the
+// sweeps solving with the diagonal blocks
+void testInverseBlockDiagonal()
+{
+  using Matrix = BCRSMatrix<FieldMatrix<double,2,2> >;
+  using Vector = BlockVector<FieldVector<double,2> >;
+
+  Matrix matrix;
+  setupLaplacian(matrix, 20);
+  for (auto row = matrix.begin(); row != matrix.end(); ++row)
+    matrix[row.index()][row.index()][0][1] = 0.5;
+
+  InverseBlockDiagonal<Matrix> invDiag;
+  invDiag.compute(matrix);
+
+  Vector b(matrix.N());
+  for (std::size_t i = 0; i < b.size(); ++i)
+    b[i] = {1.0 + i%7, 2.0 - i%3};
+
+  auto check = [&](auto&& sweep, auto&& cachedSweep) {
+    Vector x1(matrix.N()), x2(matrix.N());
+    x1 = 0;
+    x2 = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+      sweep(x1);
+      cachedSweep(x2);
+    }
+    x1 -= x2;
+    if (x1.two_norm() > 1e-12 * x2.two_norm())
+      DUNE_THROW(Exception, "sweep with inverted diagonal blocks differs");
+  };
+
+  check([&](Vector& x){ bsorf(matrix, x, b, 1.2); },
+        [&](Vector& x){ bsorf(matrix, invDiag, x, b, 1.2); });
+  check([&](Vector& x){ bsorb(matrix, x, b, 1.2); },
+        [&](Vector& x){ bsorb(matrix, invDiag, x, b, 1.2); });
+  check([&](Vector& x){ dbgs(matrix, x, b, 0.8); },
+        [&](Vector& x){ dbgs(matrix, invDiag, x, b, 0.8); });
+  check([&](Vector& x){ dbjac(matrix, x, b, 0.8); },
+        [&](Vector& x){ dbjac(matrix, invDiag, x, b, 0.8); });
+}
+
+// Check that the tuned relaxation factors accelerate the stationary iterations
+void testRelaxationTuning()
+{
+  using Matrix = BCRSMatrix<FieldMatrix<double,1,1> >;
+  using Vector = BlockVector<FieldVector<double,1> >;
+
+  const int N = 30;
+  Matrix matrix;
+  setupLaplacian(matrix, N);
+  MatrixAdapter<Matrix,Vector,Vector> op(matrix);
+
+  auto solve = [&](Preconditioner<Vector,Vector>& prec){
+    LoopSolver<Vector> solver(op, prec, 1e-6, 5000, 0);
+    Vector x(matrix.N()), b(matrix.N());
+    x = 0;
+    b = 1;
+    InverseOperatorResult result;
+    solver.apply(x, b, result);
+    if (!result.converged)
+      DUNE_THROW(Exception, "LoopSolver did not converge");
+    return result;
+  };
+
+  SeqSOR<Matrix,Vector,Vector> sor(matrix, 1, 1.0);
+  SeqSOR<Matrix,Vector,Vector> tunedSOR(matrix, 1, 1.0, RelaxationTuning::spectral);
+  const int itSOR = solve(sor).iterations;
+  const int itTunedSOR = solve(tunedSOR).iterations;
+  std::cout << "SOR iterations with w=1: " << itSOR << ", with w="
+            << tunedSOR.relaxation() << ": " << itTunedSOR << std::endl;
+  if (4 * itTunedSOR > itSOR)
+    DUNE_THROW(Exception, "spectral relaxation factor did not accelerate SOR");
+
+  SeqSSOR<Matrix,Vector,Vector> ssor(matrix, 1, 1.0);
+  SeqSSOR<Matrix,Vector,Vector> tunedSSOR(matrix, 1, 1.0, RelaxationTuning::spectral);
+  const int itSSOR = solve(ssor).iterations;
+  const int itTunedSSOR = solve(tunedSSOR).iterations;
+  std::cout << "SSOR iterations with w=1: " << itSSOR << ", with w="
+            << tunedSSOR.relaxation() << ": " << itTunedSSOR << std::endl;
+  if (2 * itTunedSSOR > itSSOR)
+    DUNE_THROW(Exception, "spectral relaxation factor did not accelerate SSOR");
+
+  // the spectrum of D^{-1}A is (0,2) for the Laplacian, the upper bound is enlarged
+  SeqJac<Matrix,Vector,Vector> tunedJac(matrix, 1, 0.5, RelaxationTuning::spectral);
+  if (tunedJac.relaxation() < 0.85 || tunedJac.relaxation() > 1.0)
+    DUNE_THROW(Exception, "wrong spectral relaxation factor for Jacobi");
+
+  // Richardson with w=1 diverges for the Laplacian
+  Richardson<Vector,Vector> tunedRichardson(matrix, 1.0, RelaxationTuning::spectral);
+  if (tunedRichardson.relaxation() > 0.25)
+    DUNE_THROW(Exception, "spectral relaxation factor of Richardson too large");
+  solve(tunedRichardson);
+
+  // the search between solves improves on the spectral start value
+  SeqSOR<Matrix,Vector,Vector> adaptiveSOR(matrix, 1, 1.0, RelaxationTuning::adaptive);
+  int itBest = itTunedSOR;
+  for (int k = 0; k < 6; ++k)
+  {
+    const auto result = solve(adaptiveSOR);
+    std::cout << "adaptive SOR iterations with w=" << adaptiveSOR.relaxation()
+              << ": " << result.iterations << std::endl;
+    adaptiveSOR.adapt(result);
+    itBest = std::min(itBest, result.iterations);
+  }
+  if (itBest >= itTunedSOR)
+    DUNE_THROW(Exception, "adaptive relaxation factor did not improve");
+
+  // an update with an unchanged spectrum keeps the state of the search
+  const double w = adaptiveSOR.relaxation();
+  adaptiveSOR.update();
+  if (adaptiveSOR.relaxation() != w)
+    DUNE_THROW(Exception, "update() restarted the search of the relaxation factor");
+}
+
+// Check that more fill reduces the CG iterations and that a breakdown of
+// the incomplete Cholesky decomposition is cured by a diagonal shift
+void testIncompleteCholesky()
+{
+  using Matrix = BCRSMatrix<FieldMatrix<double,1,1> >;
+  using Vector = BlockVector<FieldVector<double,1> >;
+
+  auto solve = [](const Matrix& matrix, Preconditioner<Vector,Vector>& prec){
+    MatrixAdapter<Matrix,Vector,Vector> op(matrix);
+    CGSolver<Vector> solver(op, prec, 1e-8, 1000, 0);
+    Vector x(matrix.N()), b(matrix.N());
+    x = 0;
+    b = 1;
+    InverseOperatorResult result;
+    solver.apply(x, b, result);
+    if (!result.converged)
+      DUNE_THROW(Exception, "CG did not converge");
+    return result.iterations;
+  };
+
+  Matrix laplacian;
+  setupLaplacian(laplacian, 40);
+  SeqIC<Matrix,Vector,Vector> ic0(laplacian, 0);
+  SeqIC<Matrix,Vector,Vector> ic2(laplacian, 2);
+  SeqICT<Matrix,Vector,Vector> ict(laplacian, 10, 1e-4);
+  const int itIC0 = solve(laplacian, ic0);
+  const int itIC2 = solve(laplacian, ic2);
+  const int itICT = solve(laplacian, ict);
+  std::cout << "CG iterations with IC(0): " << itIC0 << ", IC(2): " << itIC2
+            << ", ICT: " << itICT << std::endl;
+  if (itIC2 >= itIC0 || itICT >= itIC0)
+    DUNE_THROW(Exception, "fill did not reduce the number of CG iterations");
+  if (ic0.shift() != 0 || ict.shift() != 0)
+    DUNE_THROW(Exception, "unnecessary diagonal shift for an M-matrix");
+
+  // IC(0) of the symmetric positive definite Kershaw matrix breaks down
+  const double kershaw[4][4] = {{3, -2, 0, 2}, {-2, 3, -2, 0}, {0, -2, 3, -2}, {2, 0, -2, 3}};
+  Matrix matrix(4, 4, 16, Matrix::row_wise);
+  for (auto row = matrix.createbegin(); row != matrix.createend(); ++row)
+    for (int j = 0; j < 4; ++j)
+      if (kershaw[row.index()][j] != 0)
+        row.insert(j);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      if (kershaw[i][j] != 0)
+        matrix[i][j] = kershaw[i][j];
+
+  SeqIC<Matrix,Vector,Vector> shifted(matrix, 0, 1e-2);
+  std::cout << "diagonal shift of IC(0) for the Kershaw matrix: " << shifted.shift() << std::endl;
+  if (!(shifted.shift() > 0))
+    DUNE_THROW(Exception, "breakdown of IC(0) not detected");
+  solve(matrix, shifted);
+}
+
+template <class Matrix, class Vector>
+void testAllUpdates(const Matrix& matrix, const Vector& b)
+{
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqJac<Matrix,Vector,Vector> >(m, 1, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqChebyshev<Matrix,Vector,Vector> >(m, 2);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqILU<Matrix,Vector,Vector> >(m, 0, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqILU<Matrix,Vector,Vector> >(m, 2, 1.0, true);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqILUT<Matrix,Vector,Vector> >(m, 5, 1e-3, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqMultiColorILU0<Matrix,Vector,Vector> >(m, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqParILU<Matrix,Vector,Vector> >(m, 1, 3, 0, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqFSAI<Matrix,Vector,Vector> >(m, 1, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqSPAI<Matrix,Vector,Vector> >(m, 0, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqBlockJacobi<Matrix,Vector,Vector> >(m, 4, 1);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqILDL<Matrix,Vector,Vector> >(m, 1.0);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqIC<Matrix,Vector,Vector> >(m, 2);
+    });
+  testUpdate(matrix, b, [](const Matrix& m){
+      return std::make_shared<SeqICT<Matrix,Vector,Vector> >(m, 5, 1e-3);
+    });
 }
 
 int main() try
@@ -115,6 +427,7 @@ int main() try
     setupProblem(matrix, b);
 
     testAllPreconditioners(matrix, b);
+    testAllUpdates(matrix, b);
   }
 
   {
@@ -125,8 +438,13 @@ int main() try
     setupProblem(matrix, b);
 
     testAllPreconditioners(matrix, b);
+    testAllUpdates(matrix, b);
   }
 
+  testInverseBlockDiagonal();
+  testRelaxationTuning();
+  testIncompleteCholesky();
+
   return 0;
 }
 catch (std::exception& e) {
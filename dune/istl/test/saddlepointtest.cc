@@ -0,0 +1,164 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file \brief Test the saddle point preconditioners in the file `saddlepoint.hh`
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/indices.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/multitypeblockmatrix.hh>
+#include <dune/istl/multitypeblockvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/saddlepoint.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/test/laplacian.hh>
+
+using namespace Dune;
+using namespace Dune::Indices;
+
+using BlockMatrix = BCRSMatrix<FieldMatrix<double,1,1> >;
+using BlockVec = BlockVector<FieldVector<double,1> >;
+using SaddleMatrix = MultiTypeBlockMatrix<MultiTypeBlockVector<BlockMatrix,BlockMatrix>,
+                                          MultiTypeBlockVector<BlockMatrix,BlockMatrix> >;
+using SaddleVector = MultiTypeBlockVector<BlockVec,BlockVec>;
+
+/* The first block is the Laplacian on an N x N grid, the second block
+ * lives on the (N/2) x (N/2) cells of 2 x 2 nodes, each cell is coupled
+ * to its nodes with alternating signs.
+ */
+void setupSaddlePoint(SaddleMatrix& matrix, int N)
+{
+  const int n = N/2;
+  setupLaplacian(matrix[_0][_0], N);
+
+  auto cell = [&](int node){ return ((node/N)/2)*n + (node%N)/2; };
+  auto sign = [&](int node){ return ((node/N + node%N)%2 == 0) ? 1.0 : -1.0; };
+
+  auto& B = matrix[_0][_1];
+  B.setBuildMode(BlockMatrix::row_wise);
+  B.setSize(N*N, n*n);
+  for (auto row = B.createbegin(); row != B.createend(); ++row)
+    row.insert(cell(row.index()));
+  for (int i = 0; i < N*N; ++i)
+    B[i][cell(i)] = sign(i);
+
+  auto& C = matrix[_1][_0];
+  C.setBuildMode(BlockMatrix::row_wise);
+  C.setSize(n*n, N*N);
+  for (auto row = C.createbegin(); row != C.createend(); ++row)
+    for (int i = 0; i < N*N; ++i)
+      if (cell(i) == int(row.index()))
+        row.insert(i);
+  for (int i = 0; i < N*N; ++i)
+    C[cell(i)][i] = sign(i);
+
+  auto& D = matrix[_1][_1];
+  D.setBuildMode(BlockMatrix::row_wise);
+  D.setSize(n*n, n*n);
+  for (auto row = D.createbegin(); row != D.createend(); ++row)
+    row.insert(row.index());
+  D = 0;
+}
+
+int solve(const SaddleMatrix& matrix, Preconditioner<SaddleVector,SaddleVector>& prec)
+{
+  MatrixAdapter<SaddleMatrix,SaddleVector,SaddleVector> op(matrix);
+  RestartedGMResSolver<SaddleVector> solver(op, prec, 1e-8, 100, 1000, 1);
+  SaddleVector x, b;
+  x[_0].resize(matrix[_0][_0].N());
+  x[_1].resize(matrix[_1][_1].N());
+  b[_0].resize(matrix[_0][_0].N());
+  b[_1].resize(matrix[_1][_1].N());
+  x = 0;
+  b[_0] = 1;
+  b[_1] = 0;
+  InverseOperatorResult result;
+  solver.apply(x, b, result);
+  if (!result.converged)
+    DUNE_THROW(Exception, "GMRes did not converge");
+  return result.iterations;
+}
+
+// a preconditioner failing like an inner solve that aborts
+class FailingPreconditioner : public Preconditioner<BlockVec,BlockVec>
+{
+public:
+  void pre (BlockVec&, BlockVec&) override {}
+  void apply (BlockVec&, const BlockVec&) override
+  {
+    DUNE_THROW(SolverAbort, "inner solve failed");
+  }
+  void post (BlockVec&) override {}
+  SolverCategory::Category category () const override
+  {
+    return SolverCategory::sequential;
+  }
+};
+
+int main() try
+{
+  SaddleMatrix matrix;
+  setupSaddlePoint(matrix, 20);
+
+  // each cell couples to four exclusive nodes with diagonal 4, so S = -I
+  BlockMatrix schur;
+  diagonalSchurComplement(matrix, schur);
+  for (auto i = schur.begin(); i != schur.end(); ++i)
+    for (auto j = i->begin(); j != i->end(); ++j)
+      if (std::abs(*j - (j.index() == i.index() ? -1.0 : 0.0)) > 1e-12)
+        DUNE_THROW(Exception, "wrong Schur complement approximation");
+
+  SeqILU<BlockMatrix,BlockVec,BlockVec> precA(matrix[_0][_0], 0, 1.0);
+  SeqILU<BlockMatrix,BlockVec,BlockVec> precS(schur, 0, 1.0);
+
+  SaddlePointPreconditioner<SaddleMatrix,SaddleVector> diagonal(matrix, precA, precS, SaddlePointVariant::blockDiagonal);
+  SaddlePointPreconditioner<SaddleMatrix,SaddleVector> triangular(matrix, precA, precS, SaddlePointVariant::blockUpperTriangular);
+  SaddlePointPreconditioner<SaddleMatrix,SaddleVector> simple(matrix, precA, precS, SaddlePointVariant::simple);
+
+  const int itDiagonal = solve(matrix, diagonal);
+  const int itTriangular = solve(matrix, triangular);
+  const int itSimple = solve(matrix, simple);
+
+  std::cout << "GMRes iterations with block diagonal: " << itDiagonal
+            << ", block triangular: " << itTriangular
+            << ", SIMPLE: " << itSimple << std::endl;
+  if (itTriangular > itDiagonal)
+    DUNE_THROW(Exception, "block triangular preconditioner needs more iterations than block diagonal");
+
+  // recompute after a change of the matrix
+  matrix[_0][_0] *= 2.0;
+  diagonalSchurComplement(matrix, schur);
+  simple.update();
+  if (solve(matrix, simple) > 2*itSimple)
+    DUNE_THROW(Exception, "SIMPLE deteriorated after update");
+
+  // exceptions of the concurrently applied blocks reach the caller
+  FailingPreconditioner failing;
+  SaddlePointPreconditioner<SaddleMatrix,SaddleVector> failingDiagonal(matrix, precA, failing, SaddlePointVariant::blockDiagonal);
+  bool caught = false;
+  try {
+    solve(matrix, failingDiagonal);
+  }
+  catch (const SolverAbort&) {
+    caught = true;
+  }
+  if (!caught)
+    DUNE_THROW(Exception, "exception of a block preconditioner got lost");
+
+  return 0;
+}
+catch (std::exception& e) {
+  std::cerr << e.what() << std::endl;
+  return 1;
+}
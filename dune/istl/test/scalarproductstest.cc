@@ -59,6 +59,21 @@ TestSuite scalarProductTest(const ScalarProduct& scalarProduct,
 
   t.check(std::abs(sp - norm*norm) <=myEps);
 
+  // several dot products in one reduction
+  auto dots = scalarProduct.idot({&one, &one}, {&one, &one}).get();
+
+  t.check(dots.size() == 2);
+  t.check(std::abs(dots[0] - sp) <= myEps && std::abs(dots[1] - sp) <= myEps);
+
+  // products with different second vectors
+  BlockVector two(one);
+  two *= 2.0;
+  dots = scalarProduct.idot({&one, &two, &one}, {&one, &one, &two}).get();
+
+  t.check(dots.size() == 3);
+  t.check(std::abs(dots[0] - sp) <= myEps && std::abs(dots[1] - real_type(2)*sp) <= myEps
+          && std::abs(dots[2] - real_type(2)*sp) <= myEps);
+
   return t;
 }
 
@@ -7,12 +7,15 @@
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/timer.hh>
+#include <dune/common/simd/loop.hh>
 #include <dune/istl/overlappingschwarz.hh>
 #include <dune/istl/solvers.hh>
 #include "laplacian.hh"
 
+#include <cmath>
 #include <complex>
 #include <iterator>
+#include <sstream>
 
 namespace Dune
 {
@@ -26,9 +29,16 @@ namespace Dune
   template class LoopSolver<Vec1>;
   template class GradientSolver<Vec1>;
   template class CGSolver<Vec1>;
+  template class PipelinedCGSolver<Vec1>;
   template class BiCGSTABSolver<Vec1>;
+  template class IDRSSolver<Vec1>;
+  template class BiCGSTABLSolver<Vec1>;
   template class MINRESSolver<Vec1>;
   template class RestartedGMResSolver<Vec1>;
+  template class SStepGMResSolver<Vec1>;
+  template class GCRODRSolver<Vec1>;
+  template class BlockCGSolver<Vec1>;
+  template class BlockGMResSolver<Vec1>;
   template class RestartedFlexibleGMResSolver<Vec1>;
   template class GeneralizedPCGSolver<Vec1>;
   template class RestartedFCGSolver<Vec1>;
@@ -39,9 +49,16 @@ namespace Dune
   template class LoopSolver<Vec2>;
   template class GradientSolver<Vec2>;
   template class CGSolver<Vec2>;
+  template class PipelinedCGSolver<Vec2>;
   template class BiCGSTABSolver<Vec2>;
+  template class IDRSSolver<Vec2>;
+  template class BiCGSTABLSolver<Vec2>;
   template class MINRESSolver<Vec2>;
   template class RestartedGMResSolver<Vec2>;
+  template class SStepGMResSolver<Vec2>;
+  template class GCRODRSolver<Vec2>;
+  template class BlockCGSolver<Vec2>;
+  template class BlockGMResSolver<Vec2>;
   template class RestartedFlexibleGMResSolver<Vec2>;
   template class GeneralizedPCGSolver<Vec2>;
   template class RestartedFCGSolver<Vec2>;
@@ -109,6 +126,7 @@ int main(int argc, char** argv)
 
   Dune::RestartedGMResSolver<BVector> solver3(fop, prec0, 1e-3,5,20,2);
   solver3.apply(x,b, res);
+  const double solver3Reduction = res.reduction;
 
   b = 0;
   x = 1;
@@ -131,8 +149,299 @@ int main(int argc, char** argv)
   mat.mv(x, b);
   x = 99;
 
-  Dune::RestartedFlexibleGMResSolver<BVector> solver6(fop, prec0, 1e-3, 5, 20, 2);
+  Dune::RestartedFlexibleGMResSolver<BVector> solver6(fop, prec0, 1e-3, 30, 200, 2);
   solver6.apply(x,b, res);
+  const int solver6Iterations = res.iterations;
+  if (!res.converged)
+    DUNE_THROW(Dune::Exception, "FlexibleGMRes did not converge");
+
+  b = 0;
+  x = 1;
+  mat.mv(x, b);
+  x = 0;
+
+  Dune::PipelinedCGSolver<BVector> solver7(fop, prec0, 1e-3, 10, 2);
+  solver7.apply(x, b, res);
+
+  b = 0;
+  x = 1;
+  mat.mv(x, b);
+  x = 99;
+
+  Dune::SStepGMResSolver<BVector> solver8(fop, prec0, 1e-3, 30, 3, 200, 2);
+  solver8.apply(x, b, res);
+  const Dune::InverseOperatorResult sstepRes = res;
+
+  // the s-step variant builds the same Krylov space as GMRes, hence it
+  // reaches the same defect up to rounding in the basis
+  b = 0;
+  x = 1;
+  mat.mv(x, b);
+  x = 99;
+
+  Dune::RestartedGMResSolver<BVector> solver8Reference(fop, prec0, 1e-3, 30, 200, 2);
+  solver8Reference.apply(x, b, res);
+  if (!sstepRes.converged || !res.converged
+      || std::abs(sstepRes.iterations - res.iterations) > 3
+      || std::abs(sstepRes.reduction - res.reduction) > 1e-6*res.reduction)
+    DUNE_THROW(Dune::Exception, "SStepGMRes differs from GMRes");
+
+  // the orthogonalizations with fewer reductions reach the same defect
+  // as modified Gram-Schmidt
+  for (auto orthogonalization : {Dune::Orthogonalization::cgs, Dune::Orthogonalization::cgs2, Dune::Orthogonalization::icgs})
+  {
+    b = 0;
+    x = 1;
+    mat.mv(x, b);
+    x = 99;
+
+    Dune::RestartedGMResSolver<BVector> solver9(fop, prec0, 1e-3, 5, 20, 2, orthogonalization);
+    solver9.apply(x, b, res);
+    if (std::abs(res.reduction - solver3Reduction) > 1e-6*solver3Reduction)
+      DUNE_THROW(Dune::Exception, "GMRes defect depends on the orthogonalization");
+
+    b = 0;
+    x = 1;
+    mat.mv(x, b);
+    x = 99;
+
+    Dune::RestartedFlexibleGMResSolver<BVector> solver10(fop, prec0, 1e-3, 30, 200, 2, orthogonalization);
+    solver10.apply(x, b, res);
+    if (!res.converged || std::abs(res.iterations - solver6Iterations) > 2)
+      DUNE_THROW(Dune::Exception, "FlexibleGMRes depends on the orthogonalization");
+  }
+
+  for (auto orthogonalization : {Dune::Orthogonalization::mgs, Dune::Orthogonalization::cgs2})
+  {
+    b = 0;
+    x = 1;
+    mat.mv(x, b);
+    x = 0;
+
+    Dune::RestartedFCGSolver<BVector> solver11(fop, prec0, 1e-3, 10, 2, 10, orthogonalization);
+    solver11.apply(x, b, res);
+  }
+
+  // an unsupported orthogonalization is rejected by the constructor
+  bool rejected = false;
+  try {
+    Dune::RestartedFCGSolver<BVector> solver11(fop, prec0, 1e-3, 10, 2, 10, Dune::Orthogonalization::icgs);
+  }
+  catch (const Dune::NotImplemented&) {
+    rejected = true;
+  }
+  if (!rejected)
+    DUNE_THROW(Dune::Exception, "RestartedFCGSolver accepted icgs");
+
+  // recycling of the Krylov subspace over a sequence of solves
+  {
+    Dune::SeqSSOR<BCRSMat,BVector,BVector> ssor(mat, 1, 1.0);
+    Dune::GCRODRSolver<BVector> solver12(fop, ssor, 1e-8, 20, 8, 1000, 1);
+    int firstIterations = 0;
+    for (int solve = 0; solve < 3; ++solve)
+    {
+      for (std::size_t i = 0; i < x.size(); ++i)
+        x[i] = 1.0 + std::sin(0.01*(solve+1)*i);
+      mat.mv(x, b);
+      x = 0;
+
+      solver12.apply(x, b, res);
+      if (!res.converged)
+        DUNE_THROW(Dune::Exception, "GCRODR did not converge");
+      if (solve == 0)
+        firstIterations = res.iterations;
+      else if (res.iterations >= firstIterations)
+        DUNE_THROW(Dune::Exception, "recycling did not reduce the number of iterations");
+    }
+  }
+
+  // for a single right hand side the block solvers reduce to CG and GMRes
+  {
+    Dune::SeqSSOR<BCRSMat,BVector,BVector> ssor(mat, 1, 1.0);
+    Dune::InverseOperatorResult blockRes;
+    auto compare = [&](auto& solver, auto& blockSolver)
+    {
+      b = 0;
+      x = 1;
+      mat.mv(x, b);
+      x = 0;
+      BVector blockB(b), blockX(x);
+      solver.apply(x, b, res);
+      blockSolver.apply(blockX, blockB, blockRes);
+      if (!blockRes.converged || blockRes.iterations != res.iterations)
+        DUNE_THROW(Dune::Exception, "block solver differs for a single right hand side");
+    };
+
+    Dune::CGSolver<BVector> solver13(fop, ssor, 1e-8, 1000, 1);
+    Dune::BlockCGSolver<BVector> blockSolver13(fop, ssor, 1e-8, 1000, 1);
+    compare(solver13, blockSolver13);
+
+    Dune::RestartedGMResSolver<BVector> solver14(fop, ssor, 1e-8, 10, 1000, 1);
+    Dune::BlockGMResSolver<BVector> blockSolver14(fop, ssor, 1e-8, 10, 1000, 1);
+    compare(solver14, blockSolver14);
+  }
+
+  // several right hand sides in the lanes of a SIMD type, the last two lanes
+  // depend linearly on the first two and reduce the rank of the block
+  {
+    typedef Dune::LoopSIMD<double,4> Lanes;
+    typedef Dune::BlockVector<Dune::FieldVector<Lanes,1> > LaneVector;
+    Dune::MatrixAdapter<BCRSMat,LaneVector,LaneVector> lop(mat);
+    Dune::SeqSSOR<BCRSMat,LaneVector,LaneVector> ssor(mat, 1, 1.0);
+    const std::size_t lanes = Dune::Simd::lanes<Lanes>();
+
+    auto check = [&](auto& blockSolver)
+    {
+      LaneVector lx(N*N), lb(N*N);
+      for (std::size_t i = 0; i < lb.size(); ++i)
+      {
+        Dune::Simd::lane(0, lb[i][0]) = std::sin(0.01*i);
+        Dune::Simd::lane(1, lb[i][0]) = std::cos(0.03*i);
+        Dune::Simd::lane(2, lb[i][0]) = std::sin(0.01*i) - 2.0*std::cos(0.03*i);
+        Dune::Simd::lane(3, lb[i][0]) = std::sin(0.01*i);
+      }
+      const LaneVector rhs(lb);
+      lx = 0;
+      blockSolver.apply(lx, lb, res);
+
+      LaneVector defect(rhs);
+      lop.applyscaleadd(-1.0, lx, defect);
+      for (std::size_t l = 0; l < lanes; ++l)
+      {
+        double defectNorm = 0, rhsNorm = 0;
+        for (std::size_t i = 0; i < rhs.size(); ++i)
+        {
+          defectNorm += Dune::Simd::lane(l, defect[i][0]) * Dune::Simd::lane(l, defect[i][0]);
+          rhsNorm += Dune::Simd::lane(l, rhs[i][0]) * Dune::Simd::lane(l, rhs[i][0]);
+        }
+        if (!res.converged || !std::isfinite(defectNorm) || defectNorm > 1e-12*rhsNorm)
+          DUNE_THROW(Dune::Exception, "block solver did not solve lane " << l);
+      }
+    };
+
+    Dune::BlockCGSolver<LaneVector> laneSolver13(lop, ssor, 1e-8, 1000, 1);
+    check(laneSolver13);
+    Dune::BlockGMResSolver<LaneVector> laneSolver14(lop, ssor, 1e-8, 10, 1000, 1);
+    check(laneSolver14);
+  }
+
+  // IDR(s) and BiCGStab(l) for a convection dominated problem
+  {
+    BCRSMat convection(mat);
+    for (auto row = convection.begin(); row != convection.end(); ++row)
+      for (auto entry = row->begin(); entry != row->end(); ++entry)
+      {
+        const int offset = int(entry.index()) - int(row.index());
+        if (offset == 1 || offset == N)
+          *entry += 1.5;
+        else if (offset == -1 || offset == -N)
+          *entry -= 1.5;
+      }
+    Operator cop(convection);
+    Dune::SeqILU<BCRSMat,BVector,BVector> ilu(convection, 0, 1.0);
+
+    auto check = [&](auto& solver)
+    {
+      for (std::size_t i = 0; i < x.size(); ++i)
+        x[i] = std::sin(0.1*i);
+      convection.mv(x, b);
+      BVector defect(b);
+      const double rhsNorm = b.two_norm();
+      x = 0;
+      solver.apply(x, b, res);
+      convection.mmv(x, defect);
+      if (!res.converged || defect.two_norm() > 1e-6*rhsNorm)
+        DUNE_THROW(Dune::Exception, "IDR(s) or BiCGStab(l) did not converge");
+    };
+
+    for (int s : {1, 4})
+    {
+      Dune::IDRSSolver<BVector> solver15(cop, ilu, 1e-8, s, 1000, 1);
+      check(solver15);
+    }
+    for (int l : {1, 2, 4})
+    {
+      Dune::BiCGSTABLSolver<BVector> solver16(cop, ilu, 1e-8, l, 1000, 1);
+      check(solver16);
+    }
+  }
+
+  // residual history and timing breakdown of an instrumented solver
+  {
+    b=0;
+    x=1;
+    mat.mv(x, b);
+    x=0;
+    Dune::CGSolver<BVector> solver17(fop, prec0, 1e-8, 1000, 1);
+    solver17.setInstrumentation(true);
+    solver17.apply(x, b, res);
+
+    std::ostringstream json;
+    res.writeJSON(json);
+    std::cout << json.str() << std::endl;
+
+    // CG computes one matrix-vector product and one preconditioner step per
+    // iteration and the initial defect
+    if (res.residual_history.size() != std::size_t(res.iterations+1)
+        || res.operator_applications != res.iterations+1
+        || res.preconditioner_applications != res.iterations
+        || res.reductions < 2*res.iterations
+        || res.residual_history.back() > 1e-8*res.residual_history.front()
+        || res.operator_time + res.preconditioner_time + res.reduction_time + res.update_time > 1.01*res.elapsed
+        || json.str().find("\"residual_history\": [") == std::string::npos)
+      DUNE_THROW(Dune::Exception, "instrumentation of the CG solver is inconsistent");
+
+    solver17.setInstrumentation(false);
+    x=1;
+    mat.mv(x, b);
+    x=0;
+    solver17.apply(x, b, res);
+    if (!res.residual_history.empty() || res.operator_applications != 0)
+      DUNE_THROW(Dune::Exception, "instrumentation is still active");
+  }
+
+  // extreme eigenvalue estimates from the Lanczos and Arnoldi coefficients,
+  // the eigenvalues of the Laplacian are 4-2cos(k pi h)-2cos(l pi h)
+  {
+    const double pi = std::acos(-1.0);
+    const double h = 1.0/(N+1);
+    const double lambdaMin = 4.0 - 4.0*std::cos(pi*h);
+    const double lambdaMax = 4.0 + 4.0*std::cos(pi*h);
+    Dune::Richardson<BVector,BVector> richardson(1.0);
+
+    auto check = [&](auto& solver, bool symmetric) {
+      b=0;
+      x=1;
+      mat.mv(x, b);
+      x=0;
+      solver.apply(x, b, res);
+      std::cout << "eigenvalue estimates " << res.min_eigenvalue_estimate
+                << " " << res.max_eigenvalue_estimate
+                << " (exact " << lambdaMin << " " << lambdaMax << ")" << std::endl;
+      // Ritz values of a symmetric operator lie in its spectrum
+      if (res.min_eigenvalue_estimate <= 0
+          || res.max_eigenvalue_estimate > (1+1e-8)*lambdaMax
+          || res.max_eigenvalue_estimate < 0.9*lambdaMax)
+        DUNE_THROW(Dune::Exception, "eigenvalue estimates are wrong");
+      if (symmetric
+          && (res.min_eigenvalue_estimate < (1-1e-8)*lambdaMin
+              || res.min_eigenvalue_estimate > 1.5*lambdaMin
+              || std::abs(res.condition_estimate - res.max_eigenvalue_estimate/res.min_eigenvalue_estimate) > 1e-8*res.condition_estimate))
+        DUNE_THROW(Dune::Exception, "Lanczos eigenvalue estimates are wrong");
+    };
+
+    Dune::CGSolver<BVector> solver18(fop, richardson, 1e-8, 1000, 0, true);
+    check(solver18, true);
+    Dune::MINRESSolver<BVector> solver19(fop, richardson, 1e-8, 1000, 0);
+    check(solver19, true);
+    Dune::GeneralizedPCGSolver<BVector> solver20(fop, richardson, 1e-8, 1000, 0, 10);
+    check(solver20, true);
+    Dune::RestartedGMResSolver<BVector> solver21(fop, richardson, 1e-8, 50, 1000, 0);
+    check(solver21, false);
+    // the final cycle of a single step does not replace the estimate of the full cycle
+    Dune::RestartedGMResSolver<BVector> solver22(fop, richardson, 1e-8, 50, 51, 0);
+    check(solver22, false);
+  }
 
   return 0;
 }